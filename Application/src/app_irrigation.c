@@ -3,20 +3,38 @@
  * @brief   Application implementation with dual timer modes
  */
 
+#define LOG_MODULE  LOG_MODULE_APP
+
 #include "app_irrigation.h"
 #include "mid_button.h"
 #include "mid_display.h"
+#include "mid_format.h"
+#include "mid_history.h"
+#include "mid_journal.h"
+#include "mid_latency.h"
+#include "mid_telemetry.h"
+#include "mid_param.h"
+#include "mid_shell.h"
+#include "mid_modbus.h"
 #include "bsp_moisture.h"
 #include "bsp_pump.h"
 #include "bsp_rtc.h"
 #include "bsp_dht11.h"
+#include "bsp_uart.h"
+#include "bsp_modbus.h"
+#include "bsp_time.h"
+#include "bsp_log.h"
 #include <stdio.h>
 #include <string.h>
 
-/* Auto mode thresholds */
+/* Auto mode thresholds (defaults, changeable at runtime) */
 #define AUTO_MOISTURE_LOW_THRESHOLD    40
 #define AUTO_MOISTURE_HIGH_THRESHOLD   50
 
+#if MODBUS_ENABLE && TELEMETRY_RATE_HZ > 0
+#error "Telemetry and Modbus both need USART1"
+#endif
+
 /* Timer mode schedule */
 typedef struct {
     uint8_t start_hour;
@@ -33,58 +51,83 @@ static uint8_t timer_cursor = 0;
 static uint8_t timer_menu_selection = 0;  // 0 = Set Time, 1 = Set Schedule
 static WateringSchedule_t watering_schedule = {8, 0, 10};  // Default: 8:00 AM, 10 min
 static WateringSchedule_t temp_schedule = {8, 0, 10};
+static bool show_history = false;  // 4-row panels: history instead of the overview
 static uint32_t last_update_time = 0;
-static bool clear_display_flag = false;
-/* UART handle for debug */
-static UART_HandleTypeDef *debug_uart = NULL;
+static uint8_t auto_low_threshold = AUTO_MOISTURE_LOW_THRESHOLD;
+static uint8_t auto_high_threshold = AUTO_MOISTURE_HIGH_THRESHOLD;
+static Param_t app_params[7];
 
 /* DHT display variables */
-static float dht_temperature = 25.0;
-static float dht_humidity = 60.0;
-static uint8_t display_mode = 0;
-static uint32_t last_display_switch = 0;
+static int16_t dht_temperature = 250;   // 0.1 degC
+static uint16_t dht_humidity = 600;     // 0.1 %RH
 
 /* Private function prototypes */
 static void handle_state_startup(void);
-static void handle_state_menu(void);
-static void handle_state_manual(void);
-static void handle_state_auto(void);
-static void handle_state_timer_display(void);
-static void handle_state_timer_menu(void);
-static void handle_state_timer_set_time(void);
-static void handle_state_timer_set_schedule(void);
+static void handle_state_menu(Button_t pressed);
+static void handle_state_manual(Button_t pressed);
+static void handle_state_auto(Button_t pressed);
+static void handle_state_timer_display(Button_t pressed);
+static void handle_state_timer_menu(Button_t pressed);
+static void handle_state_timer_set_time(Button_t pressed, int16_t step);
+static void handle_state_timer_set_schedule(Button_t pressed, int16_t step);
+static int16_t value_step(const ButtonEventRecord_t *event);
+static uint8_t wrap_add(uint8_t value, int16_t step, uint8_t modulo);
 static void check_watering_schedule(void);
+static bool publish_display(void);
+static void update_telemetry(uint32_t loop_start);
+static void register_params(void);
+static const char *tenths_str(char *buf, uint8_t size, int32_t tenths);
+
+#if MODBUS_ENABLE
+static uint16_t read_pump_state(void);
+
+/* Modbus input registers 0-8, read straight from the live state */
+static const ModbusInput_t app_inputs[] = {
+    MODBUS_INPUT(current_state),
+    MODBUS_INPUT(moisture_percent),
+    MODBUS_INPUT_FN(BSP_Moisture_Get_Last_Raw),
+    MODBUS_INPUT_FN(read_pump_state),
+    MODBUS_INPUT(dht_temperature),
+    MODBUS_INPUT(dht_humidity),
+    MODBUS_INPUT(current_time.hours),
+    MODBUS_INPUT(current_time.minutes),
+    MODBUS_INPUT(current_time.seconds),
+};
+#endif
 
 /**
  * @brief Override _write() for printf redirection to UART
+ * @note  Only queues the text; USART1 TX DMA sends it in the background.
+ *        Text that does not fit is counted in UART_Stats_t, not retried.
+ *        Discarded in Modbus builds, where USART1 carries only frames.
  */
 int _write(int file, char *ptr, int len)
 {
-    if (file == 1 || file == 2) {
-        if (debug_uart != NULL) {
-            HAL_UART_Transmit(debug_uart, (uint8_t*)ptr, len, HAL_MAX_DELAY);
-        }
+    if ((file == 1 || file == 2) && !MODBUS_ENABLE) {
+        BSP_UART_Write((const uint8_t *)ptr, (uint16_t)len);
     }
     return len;
 }
 
+#if LOG_ON(LOG_LEVEL_DEBUG)
 /**
- * @brief I2C Scanner
+ * @brief I2C Scanner (debug builds only, its output is LOG_DEBUG)
  */
 static void I2C_Scanner(I2C_HandleTypeDef *hi2c)
 {
-    printf("\r\nScanning I2C bus...\r\n");
+    LOG_DEBUG("\r\nScanning I2C bus...\r\n");
     uint8_t found = 0;
     
     for (uint8_t addr = 1; addr < 128; addr++) {
         if (HAL_I2C_IsDeviceReady(hi2c, addr << 1, 1, 10) == HAL_OK) {
-            printf("Device found at address 0x%02X\r\n", addr);
+            LOG_DEBUG("Device found at address 0x%02X\r\n", addr);
             found++;
         }
     }
     
-    printf("Total devices found: %d\r\n", found);
+    LOG_DEBUG("Total devices found: %d\r\n", found);
 }
+#endif
 
 /**
  * @brief Initialize application
@@ -92,39 +135,57 @@ static void I2C_Scanner(I2C_HandleTypeDef *hi2c)
 void APP_Irrigation_Init(ADC_HandleTypeDef *hadc, I2C_HandleTypeDef *hi2c, UART_HandleTypeDef *huart)
 {
     HAL_Delay(100);
-    debug_uart = huart;
-    
-    printf("\r\n=================================\r\n");
-    printf("STM32 Irrigation System v2.0\r\n");
-    printf("=================================\r\n");
-    
+#if MODBUS_ENABLE
+    BSP_Modbus_Init(huart, MODBUS_ADDRESS);
+#else
+    BSP_UART_Init(huart);
+#endif
+    BSP_Time_Init();
+    
+    LOG_INFO("\r\n=================================\r\n");
+    LOG_INFO("STM32 Irrigation System v2.0\r\n");
+    LOG_INFO("=================================\r\n");
+    
+#if LOG_ON(LOG_LEVEL_DEBUG)
     I2C_Scanner(hi2c);
+#endif
     
     BSP_Pump_Init();
     
     if (!BSP_Moisture_Init(hadc)) {
-        printf("ERROR: Moisture sensor init failed!\r\n");
+        LOG_ERROR("ERROR: Moisture sensor init failed!\r\n");
     }
     
     MID_Button_Init();
     MID_Display_Init(hi2c);
+    MID_History_Init();
+    MID_Journal_Init();
+    MID_Latency_Init();
+    MID_Journal_Record(JOURNAL_BOOT, 0, 0);
+    MID_Telemetry_Init();
+    register_params();
+#if MODBUS_ENABLE
+    MID_Modbus_Init(app_inputs, sizeof(app_inputs) / sizeof(app_inputs[0]));
+#else
+    MID_Shell_Init();
+#endif
     
     if (!BSP_RTC_Init(hi2c)) {
-        printf("WARNING: RTC not detected! Timer mode disabled.\r\n");
+        LOG_WARN("WARNING: RTC not detected! Timer mode disabled.\r\n");
         RTC_Time_t default_time = {0, 0, 0, 1, 1, 1, 25};
         current_time = default_time;
     } else {
-        printf("RTC initialized successfully.\r\n");
+        LOG_INFO("RTC initialized successfully.\r\n");
     }
     
     if (!BSP_DHT11_Init()) {
-        printf("WARNING: DHT11 sensor init failed!\r\n");
+        LOG_WARN("WARNING: DHT11 sensor init failed!\r\n");
     }
     current_state = STATE_STARTUP;
     last_update_time = HAL_GetTick();
     
-    printf("System initialized.\r\n");
-    printf("=================================\r\n\r\n");
+    LOG_INFO("System initialized.\r\n");
+    LOG_INFO("=================================\r\n\r\n");
 }
 
 /**
@@ -133,37 +194,69 @@ void APP_Irrigation_Init(ADC_HandleTypeDef *hadc, I2C_HandleTypeDef *hi2c, UART_
 void APP_Irrigation_Run(void)
 {
     static SystemState_t last_state = STATE_STARTUP;
+    static bool last_pump_state = false;
+    uint32_t loop_start = BSP_Time_Cycles();
+    ButtonEventRecord_t event = {0};
+    Button_t pressed = BUTTON_COUNT;    // None
     
     MID_Button_Update();
+    // One event per pass: a state only sees presses made while it is current
+    if (MID_Button_GetEvent(&event) && event.event == BUTTON_EVENT_PRESSED) {
+        if (MID_Display_GetPower() == DISPLAY_POWER_ON) {
+            pressed = (Button_t)event.button;
+        } else {
+            event.event = BUTTON_EVENT_NONE;    // Only wakes the display (below)
+        }
+    }
+#if MODBUS_ENABLE
+    MID_Modbus_Process();
+#else
+    MID_Shell_Process();
+#endif
+    if (MID_Button_HadActivity()) {
+        MID_Display_Wake();
+    }
     BSP_DHT11_Read();
-    dht_temperature = BSP_DHT11_GetTemperature();
-    dht_humidity = BSP_DHT11_GetHumidity();
+    dht_temperature = BSP_DHT11_GetTemperature_x10();
+    dht_humidity = BSP_DHT11_GetHumidity_x10();
     // Update readings every 500ms
     if ((HAL_GetTick() - last_update_time) >= 500) {
         moisture_percent = BSP_Moisture_Get_Percent();
+        MID_History_Add(moisture_percent);
+        // I2C2 is shared: let queued display traffic finish before the RTC read
+        MID_Display_Sync();
         BSP_RTC_GetTime(&current_time);
         last_update_time = HAL_GetTick();
         
         // Debug output every 5 seconds
         static uint32_t last_debug_time = 0;
         if ((HAL_GetTick() - last_debug_time) >= 5000) {
-            printf("[%02d:%02d:%02d] State: %d, Moisture: %d%%, Pump: %s, Temp: %.1fC, Humidity: %.1f%%\r\n",
+            char temp_str[8], humi_str[8];
+            LOG_INFO("[%02d:%02d:%02d] State: %d, Moisture: %d%%, Pump: %s, Temp: %sC, Humidity: %s%%\r\n",
                current_time.hours, current_time.minutes, current_time.seconds,
                current_state, moisture_percent,
                BSP_Pump_GetState() ? "ON" : "OFF",
-               dht_temperature, dht_humidity);
+               tenths_str(temp_str, sizeof(temp_str), dht_temperature),
+               tenths_str(humi_str, sizeof(humi_str), dht_humidity));
+            last_debug_time = HAL_GetTick();
+            
+            static uint32_t last_dropped = 0;
+            UART_Stats_t uart_stats;
+            BSP_UART_GetStats(&uart_stats);
+            if (uart_stats.bytes_dropped != last_dropped) {
+                LOG_WARN("WARNING: UART TX overflow, %lu bytes dropped (ring peak %u)\r\n",
+                       (unsigned long)uart_stats.bytes_dropped, uart_stats.peak);
+                last_dropped = uart_stats.bytes_dropped;
+            }
         }
         }
         
-        // Log state transitions
+        // Journal state transitions (shell "events")
         if (current_state != last_state) {
-        MID_Display_Clear();
-        printf("\r\n>>> STATE CHANGE: %d -> %d <<<\r\n", last_state, current_state);
+        MID_Journal_Record(JOURNAL_STATE, (uint8_t)last_state, (uint16_t)current_state);
+        LOG_DEBUG("STATE: %d -> %d\r\n", last_state, current_state);
         last_state = current_state;
-        clear_display_flag = true;
-    }
-    else {
-        clear_display_flag = false;
+        show_history = false;  // Every mode opens on its own screen
     }
     // State machine
     switch (current_state) {
@@ -171,31 +264,48 @@ void APP_Irrigation_Run(void)
             handle_state_startup();
             break;
         case STATE_MENU:
-            handle_state_menu();
+            handle_state_menu(pressed);
             break;
         case STATE_MANUAL:
-            handle_state_manual();
+            handle_state_manual(pressed);
             break;
         case STATE_AUTO:
-            handle_state_auto();
+            handle_state_auto(pressed);
             break;
         case STATE_TIMER_DISPLAY:
-            handle_state_timer_display();
+            handle_state_timer_display(pressed);
             break;
         case STATE_TIMER_MENU:
-            handle_state_timer_menu();
+            handle_state_timer_menu(pressed);
             break;
         case STATE_TIMER_SET_TIME:
-            handle_state_timer_set_time();
+            handle_state_timer_set_time(pressed, value_step(&event));
             break;
         case STATE_TIMER_SET_SCHEDULE:
-            handle_state_timer_set_schedule();
+            handle_state_timer_set_schedule(pressed, value_step(&event));
             break;
         default:
-            printf("ERROR: Unknown state, resetting to MENU\r\n");
+            LOG_ERROR("ERROR: Unknown state, resetting to MENU\r\n");
             current_state = STATE_MENU;
             break;
     }
+    
+    // Pump changes wake the display like a button, whoever switched it
+    if (BSP_Pump_GetState() != last_pump_state) {
+        last_pump_state = BSP_Pump_GetState();
+        MID_Journal_Record(JOURNAL_PUMP, last_pump_state, moisture_percent);
+        MID_Display_Wake();
+    }
+    
+    // Handlers only change state; the display layer draws it at its own rate
+    if (publish_display() && event.event == BUTTON_EVENT_PRESSED) {
+        MID_Latency_Start((Button_t)event.button, event.cycles);
+    }
+    MID_Display_Process();
+    MID_Latency_Process();
+    
+    BSP_Log_Process();
+    update_telemetry(loop_start);
 }
 
 /**
@@ -211,125 +321,266 @@ SystemState_t APP_Irrigation_GetState(void)
  */
 static void handle_state_startup(void)
 {
-    printf("Starting system...\r\n");
+    LOG_INFO("Starting system...\r\n");
     current_state = STATE_MENU;
 }
 
 /**
  * @brief Handle MENU state
  */
-static void handle_state_menu(void)
+static void handle_state_menu(Button_t pressed)
 {
-    if (clear_display_flag) {
-        MID_Display_ShowMenu();
-    }
-    if (MID_Button_IsPressed(BUTTON_MANUAL)) {
-        printf("Button: MANUAL pressed\r\n");
+    if (pressed == BUTTON_MANUAL) {
+        LOG_INFO("Button: MANUAL pressed\r\n");
         current_state = STATE_MANUAL;
         BSP_Pump_On();
-        MID_Display_ShowManual(moisture_percent);
     }
-    else if (MID_Button_IsPressed(BUTTON_AUTO)) {
-        printf("Button: AUTO pressed\r\n");
+    else if (pressed == BUTTON_AUTO) {
+        LOG_INFO("Button: AUTO pressed\r\n");
         current_state = STATE_AUTO;
-        MID_Display_ShowAuto(moisture_percent, BSP_Pump_GetState());
     }
-    else if (MID_Button_IsPressed(BUTTON_TIMER)) {
-        printf("Button: TIMER pressed\r\n");
+    else if (pressed == BUTTON_TIMER) {
+        LOG_INFO("Button: TIMER pressed\r\n");
         current_state = STATE_TIMER_DISPLAY;
-        MID_Display_ShowTime(&current_time);
     }
 }
 
 /**
  * @brief Handle MANUAL state
  */
-static void handle_state_manual(void)
+static void handle_state_manual(Button_t pressed)
 {
     BSP_DHT11_Read();
-    dht_temperature = BSP_DHT11_GetTemperature();
-    dht_humidity = BSP_DHT11_GetHumidity();
-    printf("MANUAL: Moisture %d%%, Temp %.1fC, Humidity %.1f%%\r\n",
-           moisture_percent, dht_temperature, dht_humidity);
-    if ((HAL_GetTick() - last_display_switch) >= 5000) {
-        display_mode = !display_mode;
-        last_display_switch = HAL_GetTick();
-    }
-    
-    if (display_mode == 0) {
-        MID_Display_ShowManual(moisture_percent);
-    } else {
-        MID_Display_ShowDHT(dht_temperature, dht_humidity);
-    }
-    
-    if (MID_Button_IsPressed(BUTTON_RESET)) {
-        printf("Button: RESET pressed in MANUAL\r\n");
+    dht_temperature = BSP_DHT11_GetTemperature_x10();
+    dht_humidity = BSP_DHT11_GetHumidity_x10();
+    char temp_str[8], humi_str[8];
+    LOG_TRACE("MANUAL: Moisture %d%%, Temp %sC, Humidity %s%%\r\n", moisture_percent,
+           tenths_str(temp_str, sizeof(temp_str), dht_temperature),
+           tenths_str(humi_str, sizeof(humi_str), dht_humidity));
+    if (pressed == BUTTON_RESET) {
+        LOG_INFO("Button: RESET pressed in MANUAL\r\n");
         BSP_Pump_Off();
-        display_mode = 0;
         current_state = STATE_MENU;
-        MID_Display_ShowMenu();
     }
+#if DISPLAY_HAS_OVERVIEW
+    if (pressed == BUTTON_INC) {
+        show_history = !show_history;  // Overview <-> history
+    }
+#endif
 }
 
 /**
  * @brief Handle AUTO state
  */
-static void handle_state_auto(void)
+static void handle_state_auto(Button_t pressed)
 {
     BSP_DHT11_Read();
-    dht_temperature = BSP_DHT11_GetTemperature();
-    dht_humidity = BSP_DHT11_GetHumidity();
-    printf("AUTO: Moisture %d%%, Temp %.1fC, Humidity %.1f%%\r\n",
-           moisture_percent, dht_temperature, dht_humidity);
+    dht_temperature = BSP_DHT11_GetTemperature_x10();
+    dht_humidity = BSP_DHT11_GetHumidity_x10();
+    char temp_str[8], humi_str[8];
+    LOG_TRACE("AUTO: Moisture %d%%, Temp %sC, Humidity %s%%\r\n", moisture_percent,
+           tenths_str(temp_str, sizeof(temp_str), dht_temperature),
+           tenths_str(humi_str, sizeof(humi_str), dht_humidity));
     bool current_pump_state = BSP_Pump_GetState();
     
-    if (moisture_percent < AUTO_MOISTURE_LOW_THRESHOLD) {
+    if (moisture_percent < auto_low_threshold) {
         if (!current_pump_state) {
             BSP_Pump_On();
-            printf("AUTO: Pump ON (moisture %d%%)\r\n", moisture_percent);
+            LOG_DEBUG("AUTO: Pump ON (moisture %d%%)\r\n", moisture_percent);
         }
     }
-    else if (moisture_percent >= AUTO_MOISTURE_HIGH_THRESHOLD) {
+    else if (moisture_percent >= auto_high_threshold) {
         if (current_pump_state) {
             BSP_Pump_Off();
-            printf("AUTO: Pump OFF (moisture %d%%)\r\n", moisture_percent);
+            LOG_DEBUG("AUTO: Pump OFF (moisture %d%%)\r\n", moisture_percent);
         }
     }
 
-    if ((HAL_GetTick() - last_display_switch) >= 5000) {
-        display_mode = !display_mode;
-        last_display_switch = HAL_GetTick();
+    if (pressed == BUTTON_RESET) {
+        LOG_INFO("Button: RESET pressed in AUTO\r\n");
+        BSP_Pump_Off();
+        current_state = STATE_MENU;
     }
-
-    if (display_mode == 0) {
-        MID_Display_ShowAuto(moisture_percent, BSP_Pump_GetState());
-    } else {
-        MID_Display_ShowDHT(dht_temperature, dht_humidity);
+#if DISPLAY_HAS_OVERVIEW
+    if (pressed == BUTTON_INC) {
+        show_history = !show_history;  // Overview <-> history
     }
+#endif
+}
+
+/**
+ * @brief Publish the screen model for the current state
+ * @return true if the screen changed
+ */
+static bool publish_display(void)
+{
+    DisplayModel_t model;
     
-    if (MID_Button_IsPressed(BUTTON_RESET)) {
-        printf("Button: RESET pressed in AUTO\r\n");
-        BSP_Pump_Off();
-        display_mode = 0;
-        current_state = STATE_MENU;
+    memset(&model, 0, sizeof(model));  // Unused fields must compare equal
+    
+    switch (current_state) {
+        case STATE_MANUAL:
+        case STATE_AUTO:
+            model.mode = (current_state == STATE_AUTO) ? DISPLAY_MODE_AUTO
+                                                       : DISPLAY_MODE_MANUAL;
+            model.moisture = moisture_percent;
+            model.pump_on = BSP_Pump_GetState();
+            model.temperature_x10 = dht_temperature;
+            model.humidity_x10 = dht_humidity;
+            model.history_seq = MID_History_GetSeq();
+#if DISPLAY_HAS_OVERVIEW
+            model.time = current_time;
+            model.show_history = show_history;
+#endif
+            break;
+        case STATE_TIMER_DISPLAY:
+            model.mode = DISPLAY_MODE_TIMER_DISPLAY;
+            model.time = current_time;
+            break;
+        case STATE_TIMER_MENU:
+            model.mode = DISPLAY_MODE_TIMER_MENU;
+            model.menu_selection = timer_menu_selection;
+            break;
+        case STATE_TIMER_SET_TIME:
+            model.mode = DISPLAY_MODE_TIMER_SET_TIME;
+            model.time = set_time;
+            model.cursor_pos = timer_cursor;
+            break;
+        case STATE_TIMER_SET_SCHEDULE:
+            model.mode = DISPLAY_MODE_TIMER_SET_SCHEDULE;
+            model.schedule_hour = temp_schedule.start_hour;
+            model.schedule_minute = temp_schedule.start_minute;
+            model.schedule_duration = temp_schedule.duration_minutes;
+            model.cursor_pos = timer_cursor;
+            break;
+        default:
+            model.mode = DISPLAY_MODE_MENU;
+            break;
     }
+    
+    return MID_Display_Publish(&model);
+}
+
+/**
+ * @brief Format a 0.1-unit reading for printf (no float printf support)
+ */
+static const char *tenths_str(char *buf, uint8_t size, int32_t tenths)
+{
+    MID_Format_Tenths(buf, buf + size, tenths, 0);
+    return buf;
+}
+
+/* Cross-parameter rules: thresholds and calibration points must not cross */
+static bool check_auto_low(uint16_t value)
+{
+    return value < auto_high_threshold;
+}
+
+static bool check_auto_high(uint16_t value)
+{
+    return value > auto_low_threshold;
+}
+
+static bool check_moisture_dry(uint16_t value)
+{
+    return value > BSP_Moisture_GetCalibration()->wet;
+}
+
+static bool check_moisture_wet(uint16_t value)
+{
+    return value < BSP_Moisture_GetCalibration()->dry;
+}
+
+/**
+ * @brief Publish the runtime parameters (UART shell, Modbus holding registers)
+ * @note  Entries point at the live variables; the calibration lives in
+ *        the BSP, so the table is filled in here rather than in flash.
+ *        The order is the Modbus register map: append, do not reorder.
+ */
+static void register_params(void)
+{
+    MoistureCalibration_t *cal = BSP_Moisture_GetCalibration();
+    const Param_t params[] = {
+        {"auto_low",   &auto_low_threshold,  PARAM_U8,  0, 100,  check_auto_low},
+        {"auto_high",  &auto_high_threshold, PARAM_U8,  0, 100,  check_auto_high},
+        {"moist_dry",  &cal->dry,            PARAM_U16, 0, 4095, check_moisture_dry},
+        {"moist_wet",  &cal->wet,            PARAM_U16, 0, 4095, check_moisture_wet},
+        {"sched_hour", &watering_schedule.start_hour,       PARAM_U8, 0, 23, NULL},
+        {"sched_min",  &watering_schedule.start_minute,     PARAM_U8, 0, 59, NULL},
+        {"sched_dur",  &watering_schedule.duration_minutes, PARAM_U8, 0, 99, NULL},
+    };
+    
+    _Static_assert(sizeof(params) == sizeof(app_params), "app_params size");
+    memcpy(app_params, params, sizeof(app_params));
+    MID_Param_Register(app_params, sizeof(app_params) / sizeof(app_params[0]));
+}
+
+#if MODBUS_ENABLE
+/**
+ * @brief Pump relay state for Modbus input register 3
+ */
+static uint16_t read_pump_state(void)
+{
+    return BSP_Pump_GetState() ? 1U : 0U;
+}
+#endif
+
+/**
+ * @brief Account this loop pass and send a telemetry snapshot when due
+ * @param loop_start Cycle count at the start of the pass
+ */
+static void update_telemetry(uint32_t loop_start)
+{
+    static uint32_t loop_count = 0;
+    static uint32_t loop_sum_us = 0;
+    static uint32_t loop_max_us = 0;
+    uint32_t loop_us = BSP_Time_CyclesToUs(BSP_Time_Cycles() - loop_start);
+    Telemetry_t snapshot;
+    
+    loop_count++;
+    loop_sum_us += loop_us;
+    if (loop_us > loop_max_us) {
+        loop_max_us = loop_us;
+    }
+    
+    if (!MID_Telemetry_Due()) {
+        return;
+    }
+    
+    snapshot.state = (uint8_t)current_state;
+    snapshot.adc_raw = BSP_Moisture_Get_Last_Raw();
+    snapshot.moisture = moisture_percent;
+    snapshot.pump_on = BSP_Pump_GetState();
+    snapshot.temperature_x10 = dht_temperature;
+    snapshot.humidity_x10 = dht_humidity;
+    snapshot.hours = current_time.hours;
+    snapshot.minutes = current_time.minutes;
+    snapshot.seconds = current_time.seconds;
+    snapshot.loop_count = (uint16_t)((loop_count > 0xFFFF) ? 0xFFFF : loop_count);
+    snapshot.loop_max_us = (uint16_t)((loop_max_us > 0xFFFF) ? 0xFFFF : loop_max_us);
+    loop_sum_us /= loop_count;
+    snapshot.loop_avg_us = (uint16_t)((loop_sum_us > 0xFFFF) ? 0xFFFF : loop_sum_us);
+    MID_Telemetry_Send(&snapshot);
+    
+    loop_count = 0;
+    loop_sum_us = 0;
+    loop_max_us = 0;
 }
 
 /**
  * @brief Handle TIMER_DISPLAY state
  */
-static void handle_state_timer_display(void)
+static void handle_state_timer_display(Button_t pressed)
 {
-    MID_Display_ShowTime(&current_time);
     check_watering_schedule();
     
-    if (MID_Button_IsPressed(BUTTON_TIMER)) {
-        printf("Button: TIMER pressed, entering TIMER MENU\r\n");
+    if (pressed == BUTTON_TIMER) {
+        LOG_INFO("Button: TIMER pressed, entering TIMER MENU\r\n");
         timer_menu_selection = 0;  // Default to "Set Time"
         current_state = STATE_TIMER_MENU;
     }
-    else if (MID_Button_IsPressed(BUTTON_RESET)) {
-        printf("Button: RESET pressed in TIMER\r\n");
+    else if (pressed == BUTTON_RESET) {
+        LOG_INFO("Button: RESET pressed in TIMER\r\n");
         BSP_Pump_Off();
         current_state = STATE_MENU;
     }
@@ -338,40 +589,25 @@ static void handle_state_timer_display(void)
 /**
  * @brief Handle TIMER_MENU state (Choose Set Time or Set Schedule)
  */
-static void handle_state_timer_menu(void)
+static void handle_state_timer_menu(Button_t pressed)
 {
-    static uint32_t last_display_update = 0;
-    if (clear_display_flag) {
-        MID_Display_ShowTimerMenu();
-    }
-    // Update display every 500ms to show selection
-    if ((HAL_GetTick() - last_display_update) >= 500) {
-        BSP_LCD_SetCursor(1, 0);
-        if (timer_menu_selection == 0) {
-            BSP_LCD_Send_String(">TIME SCHEDULE ");
-        } else {
-            BSP_LCD_Send_String(" TIME>SCHEDULE ");
-        }
-        last_display_update = HAL_GetTick();
-    }
-    
     // Navigate menu
-    if (MID_Button_IsPressed(BUTTON_INC) || MID_Button_IsPressed(BUTTON_DEC)) {
+    if (pressed == BUTTON_INC || pressed == BUTTON_DEC) {
         timer_menu_selection = !timer_menu_selection;
-        printf("TIMER MENU: Selection = %d\r\n", timer_menu_selection);
+        LOG_DEBUG("TIMER MENU: Selection = %d\r\n", timer_menu_selection);
     }
     
     // Confirm selection
-    if (MID_Button_IsPressed(BUTTON_TIMER)) {
+    if (pressed == BUTTON_TIMER) {
         if (timer_menu_selection == 0) {
             // Set Time
-            printf("Entering SET TIME mode\r\n");
+            LOG_INFO("Entering SET TIME mode\r\n");
             set_time = current_time;
             timer_cursor = 0;
             current_state = STATE_TIMER_SET_TIME;
         } else {
             // Set Schedule
-            printf("Entering SET SCHEDULE mode\r\n");
+            LOG_INFO("Entering SET SCHEDULE mode\r\n");
             temp_schedule = watering_schedule;
             timer_cursor = 0;
             current_state = STATE_TIMER_SET_SCHEDULE;
@@ -379,130 +615,105 @@ static void handle_state_timer_menu(void)
     }
     
     // Cancel
-    if (MID_Button_IsPressed(BUTTON_RESET)) {
-        printf("Button: RESET, returning to TIMER DISPLAY\r\n");
+    if (pressed == BUTTON_RESET) {
+        LOG_INFO("Button: RESET, returning to TIMER DISPLAY\r\n");
         current_state = STATE_TIMER_DISPLAY;
-        MID_Display_ShowTime(&current_time);
     }
 }
 
 /**
- * @brief Handle TIMER_SET_TIME state
+ * @brief INC/DEC press or auto-repeat as a signed step, 0 for anything else
  */
-static void handle_state_timer_set_time(void)
+static int16_t value_step(const ButtonEventRecord_t *event)
 {
-    bool value_changed = false;
-
-    if (clear_display_flag) {
-        MID_Display_ShowSetTime(&set_time, timer_cursor);
+    if (event->event != BUTTON_EVENT_PRESSED && event->event != BUTTON_EVENT_REPEAT) {
+        return 0;
     }
-    
-    if (MID_Button_IsPressed(BUTTON_INC)) {
-        if (timer_cursor == 0) {
-            set_time.hours = (set_time.hours + 1) % 24;
-        } else if (timer_cursor == 1) {
-            set_time.minutes = (set_time.minutes + 1) % 60;
-        } else if (timer_cursor == 2) {
-            set_time.seconds = (set_time.seconds + 1) % 60;
-        }
-        value_changed = true;
+    if (event->button == BUTTON_INC) {
+        return event->step;
+    }
+    if (event->button == BUTTON_DEC) {
+        return -(int16_t)event->step;
     }
+    return 0;
+}
+
+/**
+ * @brief Add step to a value that wraps at modulo
+ */
+static uint8_t wrap_add(uint8_t value, int16_t step, uint8_t modulo)
+{
+    int16_t result = (int16_t)((value + step) % modulo);
     
-    if (MID_Button_IsPressed(BUTTON_DEC)) {
+    return (uint8_t)(result < 0 ? result + modulo : result);
+}
+
+/**
+ * @brief Handle TIMER_SET_TIME state
+ * @param step INC/DEC steps this pass, see value_step()
+ */
+static void handle_state_timer_set_time(Button_t pressed, int16_t step)
+{
+    if (step != 0) {
         if (timer_cursor == 0) {
-            set_time.hours = (set_time.hours == 0) ? 23 : set_time.hours - 1;
+            set_time.hours = wrap_add(set_time.hours, step, 24);
         } else if (timer_cursor == 1) {
-            set_time.minutes = (set_time.minutes == 0) ? 59 : set_time.minutes - 1;
+            set_time.minutes = wrap_add(set_time.minutes, step, 60);
         } else if (timer_cursor == 2) {
-            set_time.seconds = (set_time.seconds == 0) ? 59 : set_time.seconds - 1;
+            set_time.seconds = wrap_add(set_time.seconds, step, 60);
         }
-        value_changed = true;
     }
     
-    if (MID_Button_IsPressed(BUTTON_TIMER)) {
+    if (pressed == BUTTON_TIMER) {
         timer_cursor++;
         if (timer_cursor >= 3) {
             // Save time to RTC
+            MID_Display_Sync();
             BSP_RTC_SetTime(&set_time);
-            printf("Time saved: %02d:%02d:%02d\r\n", 
+            LOG_INFO("Time saved: %02d:%02d:%02d\r\n", 
                    set_time.hours, set_time.minutes, set_time.seconds);
             current_state = STATE_TIMER_DISPLAY;
         }
-        value_changed = true;
-    }
-    
-    if (value_changed) {
-        MID_Display_ShowSetTime(&set_time, timer_cursor);
     }
     
-    if (MID_Button_IsPressed(BUTTON_RESET)) {
-        printf("Button: RESET, discarding time changes\r\n");
+    if (pressed == BUTTON_RESET) {
+        LOG_INFO("Button: RESET, discarding time changes\r\n");
         current_state = STATE_TIMER_DISPLAY;
-        MID_Display_ShowTime(&current_time);
     }
 }
 
 /**
  * @brief Handle TIMER_SET_SCHEDULE state
+ * @param step INC/DEC steps this pass, see value_step()
  */
-static void handle_state_timer_set_schedule(void)
+static void handle_state_timer_set_schedule(Button_t pressed, int16_t step)
 {
-    bool value_changed = false;
-
-    if (clear_display_flag) {
-        MID_Display_ShowSetSchedule(temp_schedule.start_hour, 
-                                    temp_schedule.start_minute, 
-                                    temp_schedule.duration_minutes, 
-                                    timer_cursor);
-    }
-    
-    if (MID_Button_IsPressed(BUTTON_INC)) {
+    if (step != 0) {
         if (timer_cursor == 0) {
-            temp_schedule.start_hour = (temp_schedule.start_hour + 1) % 24;
+            temp_schedule.start_hour = wrap_add(temp_schedule.start_hour, step, 24);
         } else if (timer_cursor == 1) {
-            temp_schedule.start_minute = (temp_schedule.start_minute + 1) % 60;
+            temp_schedule.start_minute = wrap_add(temp_schedule.start_minute, step, 60);
         } else if (timer_cursor == 2) {
-            temp_schedule.duration_minutes = (temp_schedule.duration_minutes + 1) % 100;
+            temp_schedule.duration_minutes = wrap_add(temp_schedule.duration_minutes, step, 100);
         }
-        value_changed = true;
     }
     
-    if (MID_Button_IsPressed(BUTTON_DEC)) {
-        if (timer_cursor == 0) {
-            temp_schedule.start_hour = (temp_schedule.start_hour == 0) ? 23 : temp_schedule.start_hour - 1;
-        } else if (timer_cursor == 1) {
-            temp_schedule.start_minute = (temp_schedule.start_minute == 0) ? 59 : temp_schedule.start_minute - 1;
-        } else if (timer_cursor == 2) {
-            temp_schedule.duration_minutes = (temp_schedule.duration_minutes == 0) ? 99 : temp_schedule.duration_minutes - 1;
-        }
-        value_changed = true;
-    }
-    
-    if (MID_Button_IsPressed(BUTTON_TIMER)) {
+    if (pressed == BUTTON_TIMER) {
         timer_cursor++;
         if (timer_cursor >= 3) {
             // Save schedule
             watering_schedule = temp_schedule;
-            printf("Schedule saved: %02d:%02d for %d minutes\r\n",
+            LOG_INFO("Schedule saved: %02d:%02d for %d minutes\r\n",
                    watering_schedule.start_hour,
                    watering_schedule.start_minute,
                    watering_schedule.duration_minutes);
             current_state = STATE_TIMER_DISPLAY;
         }
-        value_changed = true;
-    }
-    
-    if (value_changed) {
-        MID_Display_ShowSetSchedule(temp_schedule.start_hour,
-                                    temp_schedule.start_minute,
-                                    temp_schedule.duration_minutes,
-                                    timer_cursor);
     }
     
-    if (MID_Button_IsPressed(BUTTON_RESET)) {
-        printf("Button: RESET, discarding schedule changes\r\n");
+    if (pressed == BUTTON_RESET) {
+        LOG_INFO("Button: RESET, discarding schedule changes\r\n");
         current_state = STATE_TIMER_DISPLAY;
-        MID_Display_ShowTime(&current_time);
     }
 }
 
@@ -524,8 +735,8 @@ static void check_watering_schedule(void)
         watering_active = true;
         watering_start_time = HAL_GetTick();
         
-        printf("\r\n*** SCHEDULED WATERING STARTED ***\r\n");
-        printf("Time: %02d:%02d, Duration: %d min\r\n",
+        MID_Journal_Record(JOURNAL_WATERING, 1, watering_schedule.duration_minutes);
+        LOG_DEBUG("WATERING: start %02d:%02d for %d min\r\n",
                watering_schedule.start_hour,
                watering_schedule.start_minute,
                watering_schedule.duration_minutes);
@@ -538,7 +749,8 @@ static void check_watering_schedule(void)
         if (elapsed_minutes >= watering_schedule.duration_minutes) {
             BSP_Pump_Off();
             watering_active = false;
-            printf("*** SCHEDULED WATERING COMPLETED ***\r\n\r\n");
+            MID_Journal_Record(JOURNAL_WATERING, 0, watering_schedule.duration_minutes);
+            LOG_DEBUG("WATERING: done\r\n");
         }
     }
 }
@@ -1,6 +1,22 @@
 /**
  * @file    bsp_button.h
- * @brief   BSP for button inputs with hardware debouncing
+ * @brief   BSP for button inputs with bit-parallel debouncing
+ *
+ * All buttons are on one port, on consecutive pins, so one read of the
+ * input register gives every button at once: bit n of a button mask is
+ * Button_t n. BSP_Button_Tick() (SysTick) samples the port every
+ * BUTTON_SAMPLE_MS and debounces all bits together with a 2-bit vertical
+ * counter; a button changes state after 4 samples in a row that disagree
+ * with it, 15-20 ms at the default rate. The cost is the same for 1 or 16
+ * buttons.
+ *
+ * With BUTTON_USE_EXTI the first edge of every press or release also
+ * interrupts: the handler stamps it with the DWT cycle counter, pushes it
+ * on a single-producer/single-consumer ring for the main loop and mutes
+ * the line until a sample reads its debounced level again, so a bouncing
+ * contact costs at most one interrupt per sample period. The debouncer
+ * still decides whether the edge was a press; the stamp says when it
+ * started.
  */
 
 #ifndef BSP_BUTTON_H
@@ -23,13 +39,45 @@ typedef enum {
     BUTTON_COUNT
 } Button_t;
 
+#define BUTTON_PORT          GPIOA
+#define BUTTON_FIRST_PIN     1      // Pin of BUTTON_MANUAL, the others follow
+#define BUTTON_MASK          ((uint16_t)((1U << BUTTON_COUNT) - 1U))
+
 /* Debounce configuration */
-#define DEBOUNCE_DELAY_MS   10   // Debounce delay in milliseconds
+#ifndef BUTTON_SAMPLE_MS
+#define BUTTON_SAMPLE_MS     5      // Port sample period (SysTick ms)
+#endif
+
+/* Interrupt on button edges and queue time stamps */
+#ifndef BUTTON_USE_EXTI
+#define BUTTON_USE_EXTI      1
+#endif
+
+#define BUTTON_EDGE_QUEUE    16     // Edges, must be a power of 2
+#define BUTTON_EXTI_PRIORITY 3      // Below the I2C/UART/DMA interrupts
+
+/* One queued edge */
+typedef struct {
+    uint32_t cycles;        // BSP_Time_Cycles() in the interrupt
+    uint16_t lines;         // Buttons whose line fired, bit n = Button_t n
+    uint16_t levels;        // All buttons right after it, bit n = pressed
+} ButtonEdge_t;
+
+/* Debounced masks, bit n = Button_t n */
+typedef struct {
+    uint16_t state;         // Pressed now
+    uint16_t pressed;       // Went down since the previous BSP_Button_Update()
+    uint16_t released;      // Went up since the previous BSP_Button_Update()
+    uint16_t changed;       // pressed | released
+} ButtonScan_t;
 
 /* BSP Function Prototypes */
 void BSP_Button_Init(void);
 bool BSP_Button_Read(Button_t button);
 bool BSP_Button_Read_Debounced(Button_t button);
-void BSP_Button_Update(void);
+void BSP_Button_Update(ButtonScan_t *scan);
+void BSP_Button_Tick(void);
+bool BSP_Button_GetEdge(ButtonEdge_t *edge);
+void BSP_Button_EXTI_IRQHandler(void);
 
 #endif /* BSP_BUTTON_H */
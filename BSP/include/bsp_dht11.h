@@ -28,6 +28,8 @@ bool BSP_DHT11_Init(void);
 bool BSP_DHT11_Read(void);
 float BSP_DHT11_GetTemperature(void);
 float BSP_DHT11_GetHumidity(void);
+int16_t BSP_DHT11_GetTemperature_x10(void);
+uint16_t BSP_DHT11_GetHumidity_x10(void);
 bool BSP_DHT11_IsReady(void);
 
 #endif /* BSP_DHT11_H */
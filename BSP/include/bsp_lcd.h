@@ -28,8 +28,63 @@
 #define LCD_CMD_DISPLAY_ON  0x0C
 #define LCD_CMD_DISPLAY_OFF 0x08
 #define LCD_CMD_4BIT_MODE   0x28
+#define LCD_CMD_SET_CGRAM   0x40
 #define LCD_CMD_SET_DDRAM   0x80
 
+/* Custom characters: 8 CGRAM slots of 5x8 pixels.
+ * Character codes 0x08-0x0F mirror slots 0-7 and, unlike 0x00, can be
+ * embedded in C strings.
+ */
+#define LCD_CGRAM_SLOTS     8
+#define LCD_GLYPH_ROWS      8
+#define LCD_GLYPH_CODE(slot) ((char)(0x08 + (slot)))
+
+/* Asynchronous mode: once initialized, LCD traffic is queued and drained
+ * by I2C interrupts, with CLEAR/HOME gaps timed from SysTick.
+ * Set to 0 to keep every transfer blocking.
+ */
+#ifndef LCD_USE_ASYNC
+#define LCD_USE_ASYNC       1
+#endif
+#define LCD_QUEUE_SIZE      256     // Expander bytes, must be a power of 2
+#define LCD_SYNC_TIMEOUT_MS 100     // Queue stalled this long is dropped
+
+/* Busy-flag mode: drive RW high and read BF back through the PCF8574
+ * instead of waiting worst-case delays. Needs RW wired to P1; if BF never
+ * clears at init (RW tied low) the driver falls back to fixed delays.
+ */
+#ifndef LCD_USE_BUSY_FLAG
+#define LCD_USE_BUSY_FLAG   0
+#endif
+#define LCD_BUSY_TIMEOUT_MS 5
+
+/* Display geometry, selected at build time with -DLCD_GEOMETRY=...
+ * LCD_ROW_OFFSETS is the DDRAM address of the first cell of each row.
+ */
+#define LCD_GEOMETRY_16X2   0
+#define LCD_GEOMETRY_16X4   1
+#define LCD_GEOMETRY_20X4   2
+
+#ifndef LCD_GEOMETRY
+#define LCD_GEOMETRY        LCD_GEOMETRY_16X2
+#endif
+
+#if LCD_GEOMETRY == LCD_GEOMETRY_16X2
+#define LCD_ROWS            2
+#define LCD_COLS            16
+#define LCD_ROW_OFFSETS     {0x00, 0x40}
+#elif LCD_GEOMETRY == LCD_GEOMETRY_16X4
+#define LCD_ROWS            4
+#define LCD_COLS            16
+#define LCD_ROW_OFFSETS     {0x00, 0x40, 0x10, 0x50}
+#elif LCD_GEOMETRY == LCD_GEOMETRY_20X4
+#define LCD_ROWS            4
+#define LCD_COLS            20
+#define LCD_ROW_OFFSETS     {0x00, 0x40, 0x14, 0x54}
+#else
+#error "Unsupported LCD_GEOMETRY"
+#endif
+
 /* BSP Function Prototypes */
 bool BSP_LCD_Init(I2C_HandleTypeDef *hi2c);
 void BSP_LCD_Clear(void);
@@ -38,5 +93,23 @@ void BSP_LCD_Send_String(const char *str);
 void BSP_LCD_Send_Cmd(uint8_t cmd);
 void BSP_LCD_Send_Data(uint8_t data);
 void BSP_LCD_Backlight(bool state);
+void BSP_LCD_Display(bool on);
+void BSP_LCD_LoadGlyph(uint8_t slot, const uint8_t pattern[LCD_GLYPH_ROWS]);
+
+/* Shadow framebuffer: write into RAM, then commit only the changed cells */
+void BSP_LCD_Buffer_Clear(void);
+void BSP_LCD_Buffer_Write(uint8_t row, uint8_t col, const char *str);
+void BSP_LCD_Buffer_WriteLine(uint8_t row, const char *str);
+void BSP_LCD_Commit(void);
+
+/* Asynchronous queue control */
+void BSP_LCD_Tick(void);
+void BSP_LCD_Sync(void);
+
+/* Commit tracking: when the screen of a given commit reached the panel */
+#define LCD_DONE_HISTORY    8       // Done stamps kept, must be a power of 2
+
+uint32_t BSP_LCD_GetCommitSeq(void);
+bool BSP_LCD_GetCommitDone(uint32_t seq, uint32_t *cycles);
 
 #endif /* BSP_LCD_H */
@@ -0,0 +1,215 @@
+/**
+ * @file    bsp_log.h
+ * @brief   Debug logging: plain printf or tokenized binary frames
+ *
+ * LOG() takes printf arguments, at most LOG_MAX_ARGS after the format.
+ * With LOG_TOKENIZED=0 (default) it is printf. With LOG_TOKENIZED=1 the
+ * format string is placed in the
+ * log_fmt ELF section, which the linker script keeps out of flash, and
+ * only a frame with the string's offset and the raw arguments is sent:
+ *
+ *     LOG_FRAME_START, len, id_lo, id_hi, args...
+ *
+ * len counts the bytes after itself. Integer arguments (anything up to
+ * 32 bits, %c included) take 4 bytes little-endian; %s arguments are
+ * sent as NUL-terminated text. Tools/log_decode turns frames back into
+ * text using the firmware ELF; bytes outside frames pass through as-is.
+ * No float or 64-bit arguments.
+ *
+ * Levels: LOG_ERROR() .. LOG_TRACE() print only when their level is at
+ * or below LOG_LEVEL and the file's LOG_MODULE is set in LOG_MODULES.
+ * Both are checked by the preprocessor, so a disabled call leaves no
+ * code and no string in the image (arguments are not evaluated). A
+ * source file selects its module before including this header:
+ *
+ *     #define LOG_MODULE  LOG_MODULE_BSP
+ *     #include "bsp_log.h"
+ *
+ * Rate limit (LOG_LIMIT=1, default): each LOG() call site prints at most
+ * LOG_LIMIT_BURST messages per LOG_LIMIT_WINDOW_MS and counts the rest.
+ * Once the window is over, BSP_Log_Process() (main loop) prints the
+ * count as the start of the site's format string followed by
+ * "(repeated N times)". A site that keeps firing reports it before its
+ * next message instead. A site costs 16 bytes of RAM.
+ */
+
+#ifndef BSP_LOG_H
+#define BSP_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifndef LOG_TOKENIZED
+#define LOG_TOKENIZED           0
+#endif
+
+/* Levels */
+#define LOG_LEVEL_NONE          0
+#define LOG_LEVEL_ERROR         1
+#define LOG_LEVEL_WARN          2
+#define LOG_LEVEL_INFO          3       // Boot, state changes, status line
+#define LOG_LEVEL_DEBUG         4       // Configuration details, menus
+#define LOG_LEVEL_TRACE         5       // Per-loop and per-reading output
+
+/* A Modbus build owns USART1: no text on the line unless asked for */
+#ifndef LOG_LEVEL
+#if defined(MODBUS_ENABLE) && MODBUS_ENABLE
+#define LOG_LEVEL               LOG_LEVEL_NONE
+#else
+#define LOG_LEVEL               LOG_LEVEL_INFO
+#endif
+#endif
+
+/* Module masks */
+#define LOG_MODULE_APP          0x01
+#define LOG_MODULE_MID          0x02
+#define LOG_MODULE_BSP          0x04
+#define LOG_MODULE_ALL          0x07
+
+#ifndef LOG_MODULES
+#define LOG_MODULES             LOG_MODULE_ALL
+#endif
+
+#ifndef LOG_MODULE
+#define LOG_MODULE              LOG_MODULE_ALL
+#endif
+
+#ifndef LOG_LIMIT
+#define LOG_LIMIT               1
+#endif
+
+#ifndef LOG_LIMIT_WINDOW_MS
+#define LOG_LIMIT_WINDOW_MS     1000
+#endif
+
+#ifndef LOG_LIMIT_BURST
+#define LOG_LIMIT_BURST         5       // Messages per site and window
+#endif
+
+#define LOG_REPEAT_PREFIX       24      // Format characters naming the site
+
+#define LOG_FRAME_START         0xA5    // Never part of the ASCII text
+#define LOG_FRAME_MAX           64      // Bytes, longer frames are cut
+#define LOG_MAX_ARGS            8
+
+/* The format string of a LOG() argument list */
+#define LOG_FIRST(fmt, ...)     fmt
+
+#if LOG_LIMIT
+
+/* Rate limit state of one call site (static, one per LOG()) */
+typedef struct LogSite {
+    const char *fmt;                // Names the site in the repeat line
+    struct LogSite *next;           // Sites with a count to report
+    uint32_t window_start;          // HAL_GetTick() at the window start
+    uint16_t suppressed;            // Messages dropped, saturates
+    uint8_t count;                  // Messages printed in this window
+    bool pending;                   // On the report list
+} LogSite_t;
+
+bool BSP_Log_Allow(LogSite_t *site);
+void BSP_Log_Process(void);
+
+#define LOG_SITE(fmt) \
+    static LogSite_t log_site_ = {(fmt), NULL, 0, 0, 0, false}; \
+    if (BSP_Log_Allow(&log_site_))
+
+#else
+
+#define LOG_SITE(fmt)   if (1)
+#define BSP_Log_Process()   do { } while (0)
+
+#endif /* LOG_LIMIT */
+
+#if LOG_TOKENIZED
+
+/* Frame being assembled on the caller's stack */
+typedef struct {
+    uint8_t data[LOG_FRAME_MAX];
+    uint8_t len;
+} LogFrame_t;
+
+void BSP_Log_Begin(LogFrame_t *frame, const char *fmt);
+void BSP_Log_Int(LogFrame_t *frame, uint32_t value);
+void BSP_Log_Str(LogFrame_t *frame, const char *str);
+void BSP_Log_End(LogFrame_t *frame);
+
+/* One argument: strings by content, everything else as 32 bits */
+#define LOG_ARG(frame, x) \
+    _Generic((x), char *: BSP_Log_Str, const char *: BSP_Log_Str, \
+             default: BSP_Log_Int)((frame), (x));
+
+/* Argument count including the format string (1-9) */
+#define LOG_NARGS(...)  LOG_NARGS_(__VA_ARGS__, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, n, ...) n
+#define LOG_CAT(a, b)   LOG_CAT_(a, b)
+#define LOG_CAT_(a, b)  a##b
+
+#define LOG_ARGS_1(f, fmt)
+#define LOG_ARGS_2(f, fmt, a)       LOG_ARG(f, a)
+#define LOG_ARGS_3(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_2(f, fmt, __VA_ARGS__)
+#define LOG_ARGS_4(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_3(f, fmt, __VA_ARGS__)
+#define LOG_ARGS_5(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_4(f, fmt, __VA_ARGS__)
+#define LOG_ARGS_6(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_5(f, fmt, __VA_ARGS__)
+#define LOG_ARGS_7(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_6(f, fmt, __VA_ARGS__)
+#define LOG_ARGS_8(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_7(f, fmt, __VA_ARGS__)
+#define LOG_ARGS_9(f, fmt, a, ...)  LOG_ARG(f, a) LOG_ARGS_8(f, fmt, __VA_ARGS__)
+
+#define LOG(...) do { \
+    static const char log_fmt_[] __attribute__((section("log_fmt"))) = LOG_FIRST(__VA_ARGS__, 0); \
+    LOG_SITE(log_fmt_) { \
+        LogFrame_t log_frame_; \
+        BSP_Log_Begin(&log_frame_, log_fmt_); \
+        LOG_CAT(LOG_ARGS_, LOG_NARGS(__VA_ARGS__))(&log_frame_, __VA_ARGS__) \
+        BSP_Log_End(&log_frame_); \
+    } \
+} while (0)
+
+#else
+
+#define LOG(...) do { \
+    LOG_SITE(LOG_FIRST(__VA_ARGS__, 0)) { \
+        printf(__VA_ARGS__); \
+    } \
+} while (0)
+
+#endif /* LOG_TOKENIZED */
+
+/* Disabled level: still type-checks the format, emits nothing */
+#define LOG_OFF(...)    do { if (0) { printf(__VA_ARGS__); } } while (0)
+
+#define LOG_ON(level)   (LOG_LEVEL >= (level) && (LOG_MODULES & LOG_MODULE) != 0)
+
+#if LOG_ON(LOG_LEVEL_ERROR)
+#define LOG_ERROR(...)  LOG(__VA_ARGS__)
+#else
+#define LOG_ERROR(...)  LOG_OFF(__VA_ARGS__)
+#endif
+
+#if LOG_ON(LOG_LEVEL_WARN)
+#define LOG_WARN(...)   LOG(__VA_ARGS__)
+#else
+#define LOG_WARN(...)   LOG_OFF(__VA_ARGS__)
+#endif
+
+#if LOG_ON(LOG_LEVEL_INFO)
+#define LOG_INFO(...)   LOG(__VA_ARGS__)
+#else
+#define LOG_INFO(...)   LOG_OFF(__VA_ARGS__)
+#endif
+
+#if LOG_ON(LOG_LEVEL_DEBUG)
+#define LOG_DEBUG(...)  LOG(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...)  LOG_OFF(__VA_ARGS__)
+#endif
+
+#if LOG_ON(LOG_LEVEL_TRACE)
+#define LOG_TRACE(...)  LOG(__VA_ARGS__)
+#else
+#define LOG_TRACE(...)  LOG_OFF(__VA_ARGS__)
+#endif
+
+#endif /* BSP_LOG_H */
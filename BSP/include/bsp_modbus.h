@@ -0,0 +1,49 @@
+/**
+ * @file    bsp_modbus.h
+ * @brief   BSP for the Modbus RTU link on USART1 (framing, timing, CRC)
+ *
+ * Bytes are taken from the USART1 receive interrupt; TIM2 measures the
+ * silence after each one. A gap longer than 1.5 characters inside a frame
+ * spoils it, 3.5 characters ends it. The CRC is updated byte by byte in
+ * the interrupt, so a frame is checked by the time it is complete.
+ */
+
+#ifndef BSP_MODBUS_H
+#define BSP_MODBUS_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef MODBUS_ENABLE
+#define MODBUS_ENABLE           0       // 1: USART1 is a Modbus slave, no text
+#endif
+
+#ifndef MODBUS_BAUD
+#define MODBUS_BAUD             19200   // USART1 baud rate in Modbus builds
+#endif
+
+#ifndef MODBUS_ADDRESS
+#define MODBUS_ADDRESS          1       // Slave address, 1-247
+#endif
+
+#define MODBUS_FRAME_MAX        256     // RTU frame: address, PDU, CRC
+
+/* Link counters */
+typedef struct {
+    uint32_t frames;            // Good frames for this slave (or broadcast)
+    uint32_t crc_errors;        // Complete frames failing the CRC
+    uint32_t frame_errors;      // Gap inside a frame, too long or too short
+    uint32_t overruns;          // Bytes arriving while a frame is handled
+    uint32_t ignored;           // Good frames for other slaves
+} Modbus_Stats_t;
+
+/* BSP Function Prototypes */
+void BSP_Modbus_Init(UART_HandleTypeDef *huart, uint8_t address);
+uint16_t BSP_Modbus_Receive(uint8_t **frame);
+void BSP_Modbus_Reply(uint16_t len);
+void BSP_Modbus_Release(void);
+void BSP_Modbus_GetStats(Modbus_Stats_t *stats);
+void BSP_Modbus_TIM_IRQHandler(void);
+
+#endif /* BSP_MODBUS_H */
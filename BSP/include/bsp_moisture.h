@@ -10,9 +10,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* ADC readings at 0% and 100% moisture (lower ADC = wetter), dry > wet */
+typedef struct {
+    uint16_t dry;
+    uint16_t wet;
+} MoistureCalibration_t;
+
 /* BSP Function Prototypes */
 bool BSP_Moisture_Init(ADC_HandleTypeDef *hadc);
 uint16_t BSP_Moisture_Read_Raw(void);
 uint8_t BSP_Moisture_Get_Percent(void);
+uint16_t BSP_Moisture_Get_Last_Raw(void);
+MoistureCalibration_t *BSP_Moisture_GetCalibration(void);
 
 #endif /* BSP_MOISTURE_H */
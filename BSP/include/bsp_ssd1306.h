@@ -0,0 +1,95 @@
+/**
+ * @file    bsp_ssd1306.h
+ * @brief   BSP for 128x64 SSD1306 OLED (I2C) as a text display
+ */
+
+#ifndef BSP_SSD1306_H
+#define BSP_SSD1306_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* SSD1306 I2C Address
+ * 7-bit address: 0x3C (SA0 = LOW), 0x3D with SA0 = HIGH
+ */
+#define SSD1306_I2C_ADDR        (0x3C << 1)  // Shift for HAL
+
+/* Panel */
+#define SSD1306_WIDTH           128
+#define SSD1306_HEIGHT          64
+#define SSD1306_PAGES           (SSD1306_HEIGHT / 8)    // 8 pixel rows per page
+
+/* Control byte sent first in every transfer */
+#define SSD1306_CTRL_CMD        0x00
+#define SSD1306_CTRL_DATA       0x40
+
+/* Commands */
+#define SSD1306_CMD_DISPLAY_OFF     0xAE
+#define SSD1306_CMD_DISPLAY_ON      0xAF
+#define SSD1306_CMD_CLOCK_DIV       0xD5
+#define SSD1306_CMD_MULTIPLEX       0xA8
+#define SSD1306_CMD_DISPLAY_OFFSET  0xD3
+#define SSD1306_CMD_START_LINE      0x40
+#define SSD1306_CMD_CHARGE_PUMP     0x8D
+#define SSD1306_CMD_MEMORY_MODE     0x20
+#define SSD1306_CMD_SEG_REMAP       0xA1
+#define SSD1306_CMD_COM_SCAN_DEC    0xC8
+#define SSD1306_CMD_COM_PINS        0xDA
+#define SSD1306_CMD_CONTRAST        0x81
+#define SSD1306_CMD_PRECHARGE       0xD9
+#define SSD1306_CMD_VCOM_DETECT     0xDB
+#define SSD1306_CMD_RESUME_RAM      0xA4
+#define SSD1306_CMD_NORMAL          0xA6
+#define SSD1306_CMD_COLUMN_ADDR     0x21
+#define SSD1306_CMD_PAGE_ADDR       0x22
+
+/* Contrast levels (0x81 argument) */
+#define SSD1306_CONTRAST_NORMAL     0xCF
+#define SSD1306_CONTRAST_DIM        0x01
+
+/* Text grid: 5x7 font in 8x8 cells, one text row per page */
+#define SSD1306_CELL_WIDTH      8
+#define SSD1306_TEXT_ROWS       SSD1306_PAGES
+#define SSD1306_TEXT_COLS       (SSD1306_WIDTH / SSD1306_CELL_WIDTH)
+
+/* Custom characters, same convention as the HD44780 CGRAM:
+ * codes 0x08-0x0F show slots 0-7, patterns are 8 rows of 5 pixels.
+ */
+#define SSD1306_GLYPH_SLOTS     8
+#define SSD1306_GLYPH_ROWS      8
+#define SSD1306_GLYPH_CODE(slot) ((char)(0x08 + (slot)))
+
+/* Transfer counters */
+typedef struct {
+    uint32_t page_writes;       // Single dirty pages sent
+    uint32_t full_writes;       // Whole-frame transfers
+    uint32_t bytes;             // I2C payload bytes incl. control bytes
+} SSD1306_Stats_t;
+
+/* BSP Function Prototypes */
+bool BSP_SSD1306_Init(I2C_HandleTypeDef *hi2c);
+void BSP_SSD1306_Refresh(void);
+void BSP_SSD1306_SetCursor(uint8_t row, uint8_t col);
+void BSP_SSD1306_Display(bool on);
+void BSP_SSD1306_Dim(bool dim);
+void BSP_SSD1306_LoadGlyph(uint8_t slot, const uint8_t pattern[SSD1306_GLYPH_ROWS]);
+void BSP_SSD1306_GetStats(SSD1306_Stats_t *stats);
+const uint8_t *BSP_SSD1306_GetFramebuffer(void);
+
+/* Text buffer: write into RAM, then commit only the changed pages */
+void BSP_SSD1306_Buffer_Clear(void);
+void BSP_SSD1306_Buffer_Write(uint8_t row, uint8_t col, const char *str);
+void BSP_SSD1306_Buffer_WriteLine(uint8_t row, const char *str);
+void BSP_SSD1306_Commit(void);
+
+/* Commit tracking: transfers are blocking, so a commit is done on return
+ * unless a page failed to go out; it is then done once a later commit
+ * has resent it.
+ */
+#define SSD1306_DONE_HISTORY    8   // Done stamps kept, must be a power of 2
+
+uint32_t BSP_SSD1306_GetCommitSeq(void);
+bool BSP_SSD1306_GetCommitDone(uint32_t seq, uint32_t *cycles);
+
+#endif /* BSP_SSD1306_H */
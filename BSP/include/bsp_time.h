@@ -0,0 +1,25 @@
+/**
+ * @file    bsp_time.h
+ * @brief   BSP for cycle-accurate timestamps (DWT cycle counter)
+ */
+
+#ifndef BSP_TIME_H
+#define BSP_TIME_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+/**
+ * @brief Current CPU cycle count (wraps every ~59 s at 72 MHz)
+ * @note  Only differences are meaningful; take them as uint32_t
+ */
+static inline uint32_t BSP_Time_Cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* BSP Function Prototypes */
+void BSP_Time_Init(void);
+uint32_t BSP_Time_CyclesToUs(uint32_t cycles);
+
+#endif /* BSP_TIME_H */
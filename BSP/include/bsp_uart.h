@@ -0,0 +1,58 @@
+/**
+ * @file    bsp_uart.h
+ * @brief   BSP for the non-blocking debug UART (TX ring + DMA, RX ring + IRQ)
+ */
+
+#ifndef BSP_UART_H
+#define BSP_UART_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* TX ring: printf copies into RAM and returns; USART1 TX DMA
+ * (DMA1 Channel 4) drains it in chunks from interrupts.
+ */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     1024    // Bytes, must be a power of 2
+#endif
+#define UART_TX_CHUNK           64      // Bytes per DMA transfer
+
+/* RX ring: filled one byte per USART1 interrupt, read by the main loop */
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     128     // Bytes, must be a power of 2
+#endif
+
+/* Overflow policy when the ring is full */
+#define UART_TX_DROP_NEWEST     0       // Discard what does not fit
+#define UART_TX_DROP_OLDEST     1       // Discard queued text to make room
+#define UART_TX_BLOCK           2       // Wait for the DMA (old behaviour)
+
+#ifndef UART_TX_POLICY
+#define UART_TX_POLICY          UART_TX_DROP_NEWEST
+#endif
+
+/* Transmit and receive counters */
+typedef struct {
+    uint32_t bytes_sent;        // Handed to the UART by DMA
+    uint32_t bytes_dropped;     // Lost to overflow
+    uint32_t errors;            // UART/DMA errors
+    uint16_t peak;              // Highest ring fill level seen
+    uint32_t rx_bytes;          // Received (RX ring or handler)
+    uint32_t rx_dropped;        // Received with the RX ring full
+    uint32_t rx_errors;         // Overrun, framing, noise, parity
+} UART_Stats_t;
+
+/* Takes each received byte in the interrupt instead of the RX ring */
+typedef void (*UART_RxHandler_t)(uint8_t byte);
+
+/* BSP Function Prototypes */
+void BSP_UART_Init(UART_HandleTypeDef *huart);
+uint16_t BSP_UART_Write(const uint8_t *data, uint16_t len);
+void BSP_UART_Flush(void);
+uint16_t BSP_UART_TxSpace(void);
+uint16_t BSP_UART_Read(uint8_t *data, uint16_t max);
+void BSP_UART_SetRxHandler(UART_RxHandler_t handler);
+void BSP_UART_GetStats(UART_Stats_t *stats);
+
+#endif /* BSP_UART_H */
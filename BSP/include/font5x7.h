@@ -0,0 +1,18 @@
+/**
+ * @file    font5x7.h
+ * @brief   5x7 bitmap font for pixel displays (printable ASCII)
+ */
+
+#ifndef FONT5X7_H
+#define FONT5X7_H
+
+#include <stdint.h>
+
+/* One glyph = 5 column bytes, bit 0 is the top pixel, bit 7 unused */
+#define FONT5X7_WIDTH       5
+#define FONT5X7_FIRST       0x20
+#define FONT5X7_LAST        0x7E
+
+extern const uint8_t font5x7[FONT5X7_LAST - FONT5X7_FIRST + 1][FONT5X7_WIDTH];
+
+#endif /* FONT5X7_H */
@@ -1,42 +1,103 @@
 /**
  * @file    bsp_button.c
- * @brief   BSP implementation with time-based debouncing
+ * @brief   BSP implementation with vertical-counter debouncing
+ *
+ * Each button has a 2-bit counter whose bits live in button_ct0/ct1, one
+ * bit position per button, so all counters are stepped by the same few
+ * logic operations. A sample that matches the debounced state reloads the
+ * counter to 3; one that differs counts it down, and when it wraps past 0
+ * the button's state bit flips. Edges are collected in the interrupt until
+ * the main loop takes them, so none is lost while the loop is busy.
+ *
+ * The EXTI edge ring is lock-free: only the interrupt writes edge_head and
+ * only the main loop writes edge_tail. A full ring drops the new edge;
+ * the debounced masks still report the press, without its stamp.
  */
 
 #include "bsp_button.h"
+#include "bsp_time.h"
 
-static const uint16_t button_pins[BUTTON_COUNT] = {
-    GPIO_PIN_1,  // Manual
-    GPIO_PIN_2,  // AUTO
-    GPIO_PIN_3,  // TIMER
-    GPIO_PIN_4,  // RESET
-    GPIO_PIN_5,  // INC
-    GPIO_PIN_6   // DEC
-};
+#define BUTTON_LINES         ((uint32_t)BUTTON_MASK << BUTTON_FIRST_PIN)
+#define BUTTON_EDGE_MASK     (BUTTON_EDGE_QUEUE - 1)
 
-/* Time-based debounce structure */
-typedef struct {
-    bool raw_state;             // Current raw reading
-    bool stable_state;          // Stable debounced state
-    bool last_raw_state;        // Previous raw reading
-    uint32_t last_change_time;  // Time of last state change
-    uint8_t stable_count;       // Counter for consecutive stable readings
-} ButtonDebounceTime_t;
+_Static_assert(BUTTON_FIRST_PIN + BUTTON_COUNT <= 16, "Buttons must fit in one 16-pin port");
+_Static_assert((BUTTON_EDGE_QUEUE & BUTTON_EDGE_MASK) == 0 && BUTTON_EDGE_QUEUE <= 256,
+               "BUTTON_EDGE_QUEUE must be a power of 2, 256 at most");
 
-static ButtonDebounceTime_t debounce_data[BUTTON_COUNT] = {0};
+static volatile uint16_t button_state = 0;      // Debounced, SysTick
+static uint16_t button_ct0 = 0xFFFF;            // Counter bit 0 per button
+static uint16_t button_ct1 = 0xFFFF;            // Counter bit 1 per button
+static volatile uint16_t button_pressed = 0;    // Edges not yet taken
+static volatile uint16_t button_released = 0;
+static uint8_t button_sample_ms = 0;
+
+#if BUTTON_USE_EXTI
+static volatile ButtonEdge_t button_edges[BUTTON_EDGE_QUEUE];
+static volatile uint8_t button_edge_head = 0;   // Free-running, EXTI
+static volatile uint8_t button_edge_tail = 0;   // Free-running, main loop
+static uint16_t button_muted = 0;               // Lines waiting to settle
+#endif
+
+/**
+ * @brief Read all buttons from the port, bit n = Button_t n pressed
+ */
+static uint16_t button_sample(void)
+{
+    uint16_t pins = (uint16_t)(BUTTON_PORT->IDR >> BUTTON_FIRST_PIN);
+    
+#if BUTTON_ACTIVE_LOW
+    // Active LOW : pressed = LOW (0), released = HIGH (1)
+    pins = (uint16_t)~pins;
+#endif
+    return pins & BUTTON_MASK;
+}
 
 /**
  * @brief Initialize buttons
+ * @note  Starts from the current pin levels, so a button held at reset
+ *        gives no press
  */
 void BSP_Button_Init(void)
 {
-    for (int i = 0; i < BUTTON_COUNT; i++) {
-        debounce_data[i].raw_state = false;
-        debounce_data[i].stable_state = false;
-        debounce_data[i].last_raw_state = false;
-        debounce_data[i].last_change_time = 0;
-        debounce_data[i].stable_count = 0;
-    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    button_state = button_sample();
+    button_ct0 = 0xFFFF;
+    button_ct1 = 0xFFFF;
+    button_pressed = 0;
+    button_released = 0;
+    button_sample_ms = 0;
+    
+#if BUTTON_USE_EXTI
+    GPIO_InitTypeDef init = {0};
+    
+    button_edge_head = 0;
+    button_edge_tail = 0;
+    button_muted = 0;
+    
+    // Same pins as MX_GPIO_Init, now also routed to EXTI1-6 (port A)
+    init.Pin = BUTTON_LINES;
+    init.Mode = GPIO_MODE_IT_RISING_FALLING;
+    init.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(BUTTON_PORT, &init);
+    __HAL_GPIO_EXTI_CLEAR_IT(BUTTON_LINES);
+#endif
+    
+    __set_PRIMASK(primask);
+    
+#if BUTTON_USE_EXTI
+    HAL_NVIC_SetPriority(EXTI1_IRQn, BUTTON_EXTI_PRIORITY, 0);
+    HAL_NVIC_SetPriority(EXTI2_IRQn, BUTTON_EXTI_PRIORITY, 0);
+    HAL_NVIC_SetPriority(EXTI3_IRQn, BUTTON_EXTI_PRIORITY, 0);
+    HAL_NVIC_SetPriority(EXTI4_IRQn, BUTTON_EXTI_PRIORITY, 0);
+    HAL_NVIC_SetPriority(EXTI9_5_IRQn, BUTTON_EXTI_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(EXTI1_IRQn);
+    HAL_NVIC_EnableIRQ(EXTI2_IRQn);
+    HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+    HAL_NVIC_EnableIRQ(EXTI4_IRQn);
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+#endif
 }
 
 /**
@@ -47,20 +108,11 @@ bool BSP_Button_Read(Button_t button)
     if (button >= BUTTON_COUNT) {
         return false;
     }
-
-    GPIO_PinState pin_state = HAL_GPIO_ReadPin(GPIOA, button_pins[button]);
-    
-    #ifdef BUTTON_ACTIVE_LOW
-        // Active LOW : pressed = LOW (0), released = HIGH (1)
-        return (pin_state == GPIO_PIN_RESET);
-    #else
-        // Active HIGH: pressed = HIGH (1), released = LOW (0)
-        return (pin_state == GPIO_PIN_SET);
-    #endif
+    return (button_sample() >> button) & 1U;
 }
 
 /**
- * @brief Read debounced button state with time-based filtering
+ * @brief Read debounced button state
  * @param button Button to read
  * @return true if button is stably pressed
  */
@@ -69,68 +121,108 @@ bool BSP_Button_Read_Debounced(Button_t button)
     if (button >= BUTTON_COUNT) {
         return false;
     }
+    return (button_state >> button) & 1U;
+}
+
+/**
+ * @brief Take the debounced state and the edges since the last call
+ */
+void BSP_Button_Update(ButtonScan_t *scan)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
     
-    uint32_t current_time = HAL_GetTick();
-    bool current_reading = BSP_Button_Read(button);
-    
-    // Detect state change
-    if (current_reading != debounce_data[button].last_raw_state) {
-        // Reset debounce timer and counter
-        debounce_data[button].last_change_time = current_time;
-        debounce_data[button].stable_count = 0;
-        debounce_data[button].last_raw_state = current_reading;
-    }
-    else {
-        // State is the same as last reading
-        // Check if enough time has passed
-        if ((current_time - debounce_data[button].last_change_time) >= DEBOUNCE_DELAY_MS) {
-            // State has been stable for DEBOUNCE_DELAY_MS
-            debounce_data[button].stable_state = current_reading;
-        }
-    }
+    scan->state = button_state;
+    scan->pressed = button_pressed;
+    scan->released = button_released;
+    button_pressed = 0;
+    button_released = 0;
     
-    return debounce_data[button].stable_state;
+    __set_PRIMASK(primask);
+    scan->changed = scan->pressed | scan->released;
 }
 
 /**
- * @brief Alternative: Counter-based debounce (without delay blocking)
- * @param button Button to read
- * @return true if button is stably pressed
+ * @brief Sample and debounce every button (SysTick, every 1 ms)
  */
-bool BSP_Button_Read_Debounced_Counter(Button_t button)
+void BSP_Button_Tick(void)
 {
-    if (button >= BUTTON_COUNT) {
-        return false;
-    }
+    uint16_t sample;
+    uint16_t delta;
     
-    bool current_reading = BSP_Button_Read(button);
-    
-    if (current_reading == debounce_data[button].last_raw_state) {
-        // Same state - increment counter
-        if (debounce_data[button].stable_count < 20) {
-            debounce_data[button].stable_count++;
-        }
-        
-        // If counter reaches threshold, update stable state
-        if (debounce_data[button].stable_count >= 20) {
-            debounce_data[button].stable_state = current_reading;
-        }
+    if (++button_sample_ms < BUTTON_SAMPLE_MS) {
+        return;
     }
-    else {
-        // State changed - reset counter
-        debounce_data[button].stable_count = 0;
-        debounce_data[button].last_raw_state = current_reading;
+    button_sample_ms = 0;
+    
+    sample = button_sample();
+    delta = sample ^ button_state;                          // Disagrees with state
+    button_ct0 = (uint16_t)~(button_ct0 & delta);           // Reload or count
+    button_ct1 = (uint16_t)(button_ct0 ^ (button_ct1 & delta));
+    delta &= button_ct0 & button_ct1;                       // Wrapped: accept
+    
+    button_state ^= delta;
+    button_pressed |= delta & button_state;
+    button_released |= delta & (uint16_t)~button_state;
+    
+#if BUTTON_USE_EXTI
+    // Lines reading their debounced level again listen for the next edge
+    uint16_t settled = button_muted & (uint16_t)~(sample ^ button_state);
+    
+    if (settled != 0) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        button_muted &= (uint16_t)~settled;
+        __HAL_GPIO_EXTI_CLEAR_IT((uint32_t)settled << BUTTON_FIRST_PIN);   // Bounce while muted
+        EXTI->IMR |= (uint32_t)settled << BUTTON_FIRST_PIN;
+        __set_PRIMASK(primask);
     }
+#endif
+}
+
+#if BUTTON_USE_EXTI
+/**
+ * @brief Take the oldest queued edge (main loop)
+ * @return false if none is waiting
+ */
+bool BSP_Button_GetEdge(ButtonEdge_t *edge)
+{
+    uint8_t tail = button_edge_tail;
     
-    return debounce_data[button].stable_state;
+    if (tail == button_edge_head) {
+        return false;
+    }
+    edge->cycles = button_edges[tail & BUTTON_EDGE_MASK].cycles;
+    edge->lines = button_edges[tail & BUTTON_EDGE_MASK].lines;
+    edge->levels = button_edges[tail & BUTTON_EDGE_MASK].levels;
+    button_edge_tail = (uint8_t)(tail + 1);
+    return true;
 }
 
 /**
- * @brief Update all buttons (call every 1-5ms from timer or main loop)
+ * @brief Stamp and queue a button edge (EXTI1-4 and EXTI9_5 handlers)
+ * @note  PR also latches on muted lines while they bounce; those bits are
+ *        left for BSP_Button_Tick() to clear when it unmutes the line
  */
-void BSP_Button_Update(void)
+void BSP_Button_EXTI_IRQHandler(void)
 {
-    for (int i = 0; i < BUTTON_COUNT; i++) {
-        BSP_Button_Read_Debounced((Button_t)i);
+    uint32_t cycles = BSP_Time_Cycles();
+    uint32_t pending = __HAL_GPIO_EXTI_GET_IT(BUTTON_LINES) & EXTI->IMR;
+    uint16_t lines = (uint16_t)(pending >> BUTTON_FIRST_PIN);
+    uint8_t head = button_edge_head;
+    
+    if (lines == 0) {
+        return;
+    }
+    __HAL_GPIO_EXTI_CLEAR_IT(pending);
+    EXTI->IMR &= ~pending;          // Muted until BSP_Button_Tick() sees it settle
+    button_muted |= lines;
+    
+    if ((uint8_t)(head - button_edge_tail) < BUTTON_EDGE_QUEUE) {
+        button_edges[head & BUTTON_EDGE_MASK].cycles = cycles;
+        button_edges[head & BUTTON_EDGE_MASK].lines = lines;
+        button_edges[head & BUTTON_EDGE_MASK].levels = button_sample();
+        button_edge_head = (uint8_t)(head + 1);
     }
 }
+#endif /* BUTTON_USE_EXTI */
@@ -3,12 +3,15 @@
  * @brief   BSP implementation for DHT11 sensor using SysTick/DWT delays
  */
 
+#define LOG_MODULE  LOG_MODULE_BSP
+
 #include "bsp_dht11.h"
+#include "bsp_log.h"
 #include <stdio.h>
 
 /* Private variables */
-static float temperature = 0.0f;
-static float humidity = 0.0f;
+static int16_t temperature_x10 = 0;   // 0.1 degC
+static uint16_t humidity_x10 = 0;     // 0.1 %RH
 static bool sensor_ready = false;
 static uint32_t last_read_time = 0;
 static uint8_t use_dwt = 0;  // Flag to indicate if DWT is available
@@ -19,7 +22,7 @@ static void DHT11_SetPinInput(void);
 static void DHT11_DelayUs(uint32_t us);
 static void DHT11_Start(void);
 static uint8_t DHT11_CheckResponse(void);
-static uint8_t DHT11_ReadByte(void);
+static bool DHT11_ReadByte(uint8_t *byte);
 static void DHT11_DWT_Init(void);
 
 /**
@@ -44,12 +47,12 @@ static void DHT11_DWT_Init(void)
     if (DWT->CYCCNT > 0)
     {
         use_dwt = 1;
-        printf("DHT11: Using DWT for microsecond delays\r\n");
+        LOG_DEBUG("DHT11: Using DWT for microsecond delays\r\n");
     }
     else
     {
         use_dwt = 0;
-        printf("DHT11: Using software delay (less accurate)\r\n");
+        LOG_DEBUG("DHT11: Using software delay (less accurate)\r\n");
     }
 }
 
@@ -143,13 +146,13 @@ static uint8_t DHT11_CheckResponse(void)
         }
         else
         {
-            printf("ERROR: DHT11 no HIGH response\r\n");
+            LOG_WARN("ERROR: DHT11 no HIGH response\r\n");
             return 0;
         }
     }
     else
     {
-        printf("ERROR: DHT11 no LOW response\r\n");
+        LOG_WARN("ERROR: DHT11 no LOW response\r\n");
         return 0;
     }
 
@@ -161,7 +164,7 @@ static uint8_t DHT11_CheckResponse(void)
         DHT11_DelayUs(1);
         if (timeout > DHT11_TIMEOUT)
         {
-            printf("ERROR: DHT11 response timeout\r\n");
+            LOG_WARN("ERROR: DHT11 response timeout\r\n");
             return 0;
         }
     }
@@ -171,9 +174,10 @@ static uint8_t DHT11_CheckResponse(void)
 
 /**
  * @brief  Read one byte (8 bits) from DHT11
- * @retval Data byte read
+ * @param  byte: Data byte read
+ * @retval false on a bit timeout (nothing is printed inside the bit loop)
  */
-static uint8_t DHT11_ReadByte(void)
+static bool DHT11_ReadByte(uint8_t *byte)
 {
     uint8_t data = 0;
     uint16_t timeout = 0;
@@ -188,8 +192,7 @@ static uint8_t DHT11_ReadByte(void)
             DHT11_DelayUs(1);
             if (timeout > DHT11_TIMEOUT)
             {
-                printf("ERROR: Timeout waiting for bit start\r\n");
-                return 0;
+                return false;
             }
         }
 
@@ -212,13 +215,13 @@ static uint8_t DHT11_ReadByte(void)
             DHT11_DelayUs(1);
             if (timeout > DHT11_TIMEOUT)
             {
-                printf("ERROR: Timeout waiting for bit end\r\n");
-                return 0;
+                return false;
             }
         }
     }
 
-    return data;
+    *byte = data;
+    return true;
 }
 
 /**
@@ -240,8 +243,8 @@ bool BSP_DHT11_Init(void)
     HAL_Delay(1000);
 
     sensor_ready = true;
-    printf("DHT11 initialized successfully\r\n");
-    printf("NOTE: No external timer required - using %s\r\n", 
+    LOG_INFO("DHT11 initialized successfully\r\n");
+    LOG_DEBUG("NOTE: No external timer required - using %s\r\n", 
            use_dwt ? "DWT cycle counter" : "software delay");
 
     return true;
@@ -256,7 +259,7 @@ bool BSP_DHT11_Read(void)
 {
     if (!sensor_ready)
     {
-        printf("ERROR: DHT11 not initialized\r\n");
+        LOG_ERROR("ERROR: DHT11 not initialized\r\n");
         return false;
     }
 
@@ -275,14 +278,19 @@ bool BSP_DHT11_Read(void)
     // Check response
     if (!DHT11_CheckResponse())
     {
-        printf("ERROR: DHT11 no response\r\n");
+        LOG_ERROR("ERROR: DHT11 no response\r\n");
         return false;
     }
 
     // Read 40 bits (5 bytes)
     for (uint8_t i = 0; i < 5; i++)
     {
-        data[i] = DHT11_ReadByte();
+        if (!DHT11_ReadByte(&data[i]))
+        {
+            DHT11_SetPinInput();
+            LOG_ERROR("ERROR: DHT11 bit timeout in byte %u\r\n", i);
+            return false;
+        }
     }
 
     // Set pin back to input mode
@@ -292,16 +300,16 @@ bool BSP_DHT11_Read(void)
     uint8_t checksum = data[0] + data[1] + data[2] + data[3];
     if (checksum != data[4])
     {
-        printf("ERROR: Checksum failed (calc: 0x%02X, recv: 0x%02X)\r\n",
+        LOG_ERROR("ERROR: Checksum failed (calc: 0x%02X, recv: 0x%02X)\r\n",
                checksum, data[4]);
-        printf("Data: RH=%d.%d, Temp=%d.%d\r\n",
+        LOG_DEBUG("Data: RH=%d.%d, Temp=%d.%d\r\n",
                data[0], data[1], data[2], data[3]);
         return false;
     }
 
     // Extract humidity and temperature (DHT11 only uses integer part)
-    humidity = (float)data[0];    // RH integer
-    temperature = (float)data[2]; // Temp integer
+    int16_t temperature = data[2] & 0x7F;  // Temp integer
+    uint16_t humidity = data[0];           // RH integer
 
     // Check for negative temperature (bit 7 of data[2])
     if (data[2] & 0x80)
@@ -310,16 +318,17 @@ bool BSP_DHT11_Read(void)
     }
 
     // Sanity check
-    if (humidity < 0.0f || humidity > 100.0f ||
-        temperature < -40.0f || temperature > 80.0f)
+    if (humidity > 100 || temperature < -40 || temperature > 80)
     {
-        printf("WARNING: Values out of range (T:%.1f, H:%.1f)\r\n",
+        LOG_WARN("WARNING: Values out of range (T:%d, H:%u)\r\n",
                temperature, humidity);
         return false;
     }
 
+    temperature_x10 = temperature * 10;
+    humidity_x10 = humidity * 10;
     last_read_time = HAL_GetTick();
-    // printf("DHT11: Temp=%.1f°C, Humidity=%.1f%%\r\n", temperature, humidity);
+    LOG_TRACE("DHT11: Temp=%dC, Humidity=%u%%\r\n", temperature, humidity);
 
     return true;
 }
@@ -330,7 +339,16 @@ bool BSP_DHT11_Read(void)
  */
 float BSP_DHT11_GetTemperature(void)
 {
-    return temperature;
+    return temperature_x10 / 10.0f;
+}
+
+/**
+ * @brief  Get last temperature reading in fixed point
+ * @retval Temperature in 0.1 Celsius
+ */
+int16_t BSP_DHT11_GetTemperature_x10(void)
+{
+    return temperature_x10;
 }
 
 /**
@@ -339,7 +357,16 @@ float BSP_DHT11_GetTemperature(void)
  */
 float BSP_DHT11_GetHumidity(void)
 {
-    return humidity;
+    return humidity_x10 / 10.0f;
+}
+
+/**
+ * @brief  Get last humidity reading in fixed point
+ * @retval Relative humidity in 0.1 %
+ */
+uint16_t BSP_DHT11_GetHumidity_x10(void)
+{
+    return humidity_x10;
 }
 
 /**
@@ -3,41 +3,355 @@
  * @brief   BSP implementation for LCD 16x2 with PCF8574T
  */
 
+#define LOG_MODULE  LOG_MODULE_BSP
+
 #include "bsp_lcd.h"
+#include "bsp_log.h"
+#include "bsp_time.h"
 #include <string.h>
 #include <stdio.h>
 
+#define LCD_ADDR_UNKNOWN    0xFF
+#define LCD_CELL_STALE      '\0'     // Never in lcd_shadow: strings end there
+
+/* Burst buffer: PCF8574 bytes sent in one I2C transaction.
+ * Each LCD byte costs 4 expander bytes (2 nibbles x EN high/low), so
+ * 64 bytes carry 16 characters. At 100 kHz one expander byte takes
+ * ~90 us, well above the 37 us the HD44780 needs per instruction, so
+ * the bus itself provides the enable pulse and execution timing.
+ */
+#define LCD_BURST_SIZE      64
+
 static I2C_HandleTypeDef *lcd_i2c = NULL;
 static bool backlight_state = true;
 
+static const uint8_t row_offsets[] = LCD_ROW_OFFSETS;
+
+/* Rows must stay inside the two 40-cell DDRAM lines (0x00-0x27, 0x40-0x67) */
+_Static_assert(LCD_COLS <= 20 && LCD_ROWS <= 4, "HD44780 drives at most 20x4");
+_Static_assert(sizeof(row_offsets) == LCD_ROWS, "LCD_ROW_OFFSETS needs one entry per row");
+_Static_assert(LCD_ROWS <= 2 || 2 * LCD_COLS <= 40,
+               "Rows 3-4 continue DDRAM lines 1-2 and must not overflow them");
+
+/* Shadow framebuffer
+ * lcd_shadow: contents the upper layers want on screen
+ * lcd_panel:  contents last sent to the HD44780 DDRAM
+ * lcd_addr:   current DDRAM address counter (LCD_ADDR_UNKNOWN if not tracked)
+ */
+static char lcd_shadow[LCD_ROWS][LCD_COLS];
+static char lcd_panel[LCD_ROWS][LCD_COLS];
+static uint8_t lcd_addr = LCD_ADDR_UNKNOWN;
+
+static uint8_t lcd_burst[LCD_BURST_SIZE];
+static uint16_t lcd_burst_len = 0;
+
+/* Commit tracking: lcd_done_seq follows lcd_commit_seq one commit at a
+ * time as the last queue entry of each leaves the bus. lcd_done_cycles
+ * keeps when, for the last LCD_DONE_HISTORY commits done.
+ */
+#define LCD_DONE_MASK       (LCD_DONE_HISTORY - 1)
+
+_Static_assert((LCD_DONE_HISTORY & LCD_DONE_MASK) == 0, "LCD_DONE_HISTORY must be a power of 2");
+
+static volatile uint32_t lcd_commit_seq = 0;
+static volatile uint32_t lcd_done_seq = 0;
+static volatile uint32_t lcd_done_cycles[LCD_DONE_HISTORY];
+
+#if LCD_USE_BUSY_FLAG
+static bool lcd_busy_flag_ok = false;  // BF readable (RW is wired)
+#endif
+
+#if LCD_USE_ASYNC
+/* Asynchronous queue
+ * Entries are expander bytes, or LCD_QUEUE_GAP | ms for a timed pause.
+ * The main loop is the only producer (head); the drain runs from the
+ * I2C completion interrupt and SysTick (tail) under a short PRIMASK
+ * critical section, so it can be started from any context.
+ */
+#define LCD_QUEUE_GAP       0x8000
+#define LCD_QUEUE_MASK      (LCD_QUEUE_SIZE - 1)
+
+static volatile uint16_t lcd_queue[LCD_QUEUE_SIZE];
+static volatile uint16_t lcd_queue_head = 0;
+static volatile uint16_t lcd_queue_tail = 0;
+static volatile bool lcd_async_active = false;
+static volatile bool lcd_tx_busy = false;
+static volatile uint32_t lcd_gap_start = 0;
+static volatile uint32_t lcd_gap_ms = 0;
+static volatile uint32_t lcd_error_count = 0;
+static volatile bool lcd_panel_lost = false;    // Burst failed, see BSP_LCD_Commit
+static uint8_t lcd_tx_buf[LCD_BURST_SIZE];
+static uint16_t lcd_tx_len = 0;
+
+/* Entries ever queued and ever finished (sent, dropped or gap elapsed);
+ * lcd_commit_end is lcd_queued_count after each outstanding commit.
+ */
+static volatile uint32_t lcd_queued_count = 0;
+static volatile uint32_t lcd_sent_count = 0;
+static volatile uint32_t lcd_commit_end[LCD_DONE_HISTORY];
+
+static void lcd_queue_push(uint16_t entry);
+static void lcd_async_kick(void);
+static void lcd_async_abort(void);
+#endif
+
 /* Private Functions */
 static void lcd_send_nibble(uint8_t nibble, uint8_t rs);
 static void lcd_send_byte(uint8_t data, uint8_t rs);
-static HAL_StatusTypeDef lcd_write_i2c(uint8_t data);
+static HAL_StatusTypeDef lcd_burst_flush(void);
+static void lcd_wait_ms(uint32_t ms);
+#if LCD_USE_BUSY_FLAG
+static bool lcd_poll_busy(uint32_t timeout_ms);
+#endif
+static void lcd_queue_cmd(uint8_t cmd);
+static void lcd_queue_data(uint8_t data);
+static void lcd_track_data(uint8_t data);
+static void lcd_mark_stale(void);
+static void lcd_check_done(void);
+
+#if LCD_USE_ASYNC
+/**
+ * @brief Append one entry to the asynchronous queue, waiting if it is full
+ * @note  If the queue does not move for LCD_SYNC_TIMEOUT_MS it is dropped
+ */
+static void lcd_queue_push(uint16_t entry)
+{
+    uint16_t next = (lcd_queue_head + 1) & LCD_QUEUE_MASK;
+    uint32_t start = HAL_GetTick();
+    
+    while (next == lcd_queue_tail) {
+        if ((HAL_GetTick() - start) > LCD_SYNC_TIMEOUT_MS) {
+            lcd_async_abort();
+            break;
+        }
+        lcd_async_kick();  // Full: the drain frees space from interrupts
+    }
+    
+    lcd_queue[lcd_queue_head] = entry;
+    lcd_queue_head = next;
+    lcd_queued_count++;
+}
 
 /**
- * @brief Write data to PCF8574 via I2C
+ * @brief Start the next I2C transfer from the queue if the bus is free
+ * @note  Safe to call from main loop, I2C interrupt and SysTick
  */
-static HAL_StatusTypeDef lcd_write_i2c(uint8_t data)
+static void lcd_async_kick(void)
 {
-    HAL_StatusTypeDef status;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (!lcd_tx_busy) {
+        // Pending CLEAR/HOME pause: strictly more than gap_ms ticks
+        if (lcd_gap_ms != 0 && (HAL_GetTick() - lcd_gap_start) > lcd_gap_ms) {
+            lcd_gap_ms = 0;
+            lcd_sent_count++;
+        }
+        
+        if (lcd_gap_ms == 0) {
+            uint16_t tail = lcd_queue_tail;
+            uint16_t len = 0;
+            
+            while (tail != lcd_queue_head && len < LCD_BURST_SIZE) {
+                uint16_t entry = lcd_queue[tail];
+                
+                if (entry & LCD_QUEUE_GAP) {
+                    if (len == 0) {
+                        // Gap reached with nothing in flight: start timing it
+                        lcd_gap_ms = entry & ~LCD_QUEUE_GAP;
+                        lcd_gap_start = HAL_GetTick();
+                        lcd_queue_tail = (tail + 1) & LCD_QUEUE_MASK;
+                    }
+                    break;
+                }
+                
+                lcd_tx_buf[len++] = (uint8_t)entry;
+                tail = (tail + 1) & LCD_QUEUE_MASK;
+            }
+            
+            // Consume entries only once the transfer is actually running
+            if (len > 0 &&
+                HAL_I2C_Master_Transmit_IT(lcd_i2c, LCD_I2C_ADDR, lcd_tx_buf, len) == HAL_OK) {
+                lcd_tx_busy = true;
+                lcd_tx_len = len;
+                lcd_queue_tail = tail;
+            }
+        }
+    }
+    lcd_check_done();
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Drop everything queued after the drain stalled
+ * @note  The panel contents are unknown afterwards, so the next commit
+ *        redraws every cell
+ */
+static void lcd_async_abort(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    lcd_queue_tail = lcd_queue_head;
+    lcd_sent_count = lcd_queued_count;
+    lcd_tx_busy = false;
+    lcd_gap_ms = 0;
+    lcd_error_count++;
+    lcd_mark_stale();
+    
+    __set_PRIMASK(primask);
+    
+    LOG_ERROR("LCD queue stalled, dropped\r\n");
+}
+
+/**
+ * @brief I2C transfer complete: continue draining the queue
+ */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c == lcd_i2c) {
+        lcd_sent_count += lcd_tx_len;
+        lcd_tx_busy = false;
+        lcd_async_kick();
+    }
+}
+
+/**
+ * @brief I2C error: drop the failed burst and keep draining
+ * @note  The burst was already mirrored into lcd_panel, so the next
+ *        commit stops trusting the mirror and redraws every cell
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c == lcd_i2c) {
+        lcd_error_count++;
+        lcd_panel_lost = true;
+        lcd_sent_count += lcd_tx_len;
+        lcd_tx_busy = false;
+        lcd_async_kick();
+    }
+}
+#endif
+
+/**
+ * @brief Stamp each commit as done once its last queued entry is finished
+ * @note  Call with interrupts disabled
+ */
+static void lcd_check_done(void)
+{
+    while (lcd_done_seq != lcd_commit_seq) {
+        uint32_t seq = lcd_done_seq + 1U;
+        
+#if LCD_USE_ASYNC
+        if ((int32_t)(lcd_sent_count - lcd_commit_end[seq & LCD_DONE_MASK]) < 0) {
+            return;
+        }
+#endif
+        lcd_done_cycles[seq & LCD_DONE_MASK] = BSP_Time_Cycles();
+        lcd_done_seq = seq;
+    }
+}
+
+#if LCD_USE_BUSY_FLAG
+/**
+ * @brief Poll the HD44780 busy flag until the controller is ready
+ * @retval true if BF cleared within timeout_ms
+ * @note   Each poll reads the high nibble (BF on D7) and clocks out the
+ *         low nibble. RW changes in its own expander write, never in the
+ *         one that raises EN (tAS), and is low again when the poll ends.
+ */
+static bool lcd_poll_busy(uint32_t timeout_ms)
+{
+    uint8_t read = 0xF0 | LCD_PIN_RW;  // D7-D4 released high as inputs
+    uint32_t start = HAL_GetTick();
     
-    // Add backlight bit
     if (backlight_state) {
-        data |= LCD_PIN_BL;
+        read |= LCD_PIN_BL;
     }
     
-    status = HAL_I2C_Master_Transmit(lcd_i2c, LCD_I2C_ADDR, &data, 1, 100);
+    do {
+        uint8_t begin[2] = {read, read | LCD_PIN_EN};
+        uint8_t finish[4] = {read, read | LCD_PIN_EN, read, read & (uint8_t)~LCD_PIN_RW};
+        uint8_t status = 0x80;
+        
+        // RW high, then EN high: controller drives BF and AC6-AC4 on D7-D4
+        if (HAL_I2C_Master_Transmit(lcd_i2c, LCD_I2C_ADDR, begin, sizeof(begin), 10) != HAL_OK ||
+            HAL_I2C_Master_Receive(lcd_i2c, LCD_I2C_ADDR, &status, 1, 10) != HAL_OK) {
+            return false;
+        }
+        
+        // EN low, pulse EN again for the (ignored) low nibble, then RW low
+        HAL_I2C_Master_Transmit(lcd_i2c, LCD_I2C_ADDR, finish, sizeof(finish), 10);
+        
+        if ((status & 0x80) == 0) {
+            return true;
+        }
+    } while ((HAL_GetTick() - start) < timeout_ms);
+    
+    return false;
+}
+#endif
+
+/**
+ * @brief Pause between LCD operations (queued gap in asynchronous mode)
+ * @note  In busy-flag mode the blocking path returns as soon as BF clears
+ */
+static void lcd_wait_ms(uint32_t ms)
+{
+#if LCD_USE_ASYNC
+    if (lcd_async_active) {
+        lcd_queue_push(LCD_QUEUE_GAP | (uint16_t)ms);
+        return;
+    }
+#endif
+#if LCD_USE_BUSY_FLAG
+    if (lcd_busy_flag_ok) {
+        lcd_burst_flush();
+        if (lcd_poll_busy(ms + LCD_BUSY_TIMEOUT_MS)) {
+            return;
+        }
+    }
+#endif
+    HAL_Delay(ms);
+}
+
+/**
+ * @brief Send the queued burst to PCF8574 as one multi-byte I2C write
+ * @note  In asynchronous mode the burst is moved to the queue instead
+ */
+static HAL_StatusTypeDef lcd_burst_flush(void)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+    
+    if (lcd_burst_len == 0) {
+        return HAL_OK;
+    }
+    
+#if LCD_USE_ASYNC
+    if (lcd_async_active) {
+        for (uint16_t i = 0; i < lcd_burst_len; i++) {
+            lcd_queue_push(lcd_burst[i]);
+        }
+        lcd_burst_len = 0;
+        lcd_async_kick();
+        return HAL_OK;
+    }
+#endif
+    
+    status = HAL_I2C_Master_Transmit(lcd_i2c, LCD_I2C_ADDR, lcd_burst, lcd_burst_len, 100);
+    lcd_burst_len = 0;
     
     if (status != HAL_OK) {
-        printf("LCD I2C Error: %d\r\n", status);
+        lcd_mark_stale();
+        LOG_ERROR("LCD I2C Error: %d\r\n", status);
     }
     
     return status;
 }
 
 /**
- * @brief Send 4-bit nibble to LCD with enable pulse
+ * @brief Queue 4-bit nibble with enable pulse into the burst buffer
  */
 static void lcd_send_nibble(uint8_t nibble, uint8_t rs)
 {
@@ -45,14 +359,17 @@ static void lcd_send_nibble(uint8_t nibble, uint8_t rs)
     
     // Prepare data byte: D7-D4 = nibble, BL=backlight, EN=0, RW=0, RS=rs
     data = (nibble & 0xF0) | (rs ? LCD_PIN_RS : 0);
+    if (backlight_state) {
+        data |= LCD_PIN_BL;
+    }
     
-    // Send with Enable HIGH
-    lcd_write_i2c(data | LCD_PIN_EN);
-    HAL_Delay(1);  // Enable pulse width (min 450ns, 1ms is safe)
+    if (lcd_burst_len + 2 > LCD_BURST_SIZE) {
+        lcd_burst_flush();
+    }
     
-    // Send with Enable LOW (latch data)
-    lcd_write_i2c(data);
-    HAL_Delay(1);  // Data hold time
+    // Enable HIGH, then Enable LOW (HD44780 latches on the falling edge)
+    lcd_burst[lcd_burst_len++] = data | LCD_PIN_EN;
+    lcd_burst[lcd_burst_len++] = data;
 }
 
 /**
@@ -64,6 +381,69 @@ static void lcd_send_byte(uint8_t data, uint8_t rs)
     lcd_send_nibble((data << 4) & 0xF0, rs); // Lower nibble
 }
 
+/**
+ * @brief Queue a command byte, keeping the DDRAM address counter in sync
+ */
+static void lcd_queue_cmd(uint8_t cmd)
+{
+    lcd_send_byte(cmd, 0);  // RS = 0 for command
+    
+    // Keep the DDRAM address counter in sync for the shadow framebuffer
+    if (cmd & LCD_CMD_SET_DDRAM) {
+        lcd_addr = cmd & 0x7F;
+    } else if (cmd == LCD_CMD_CLEAR) {
+        memset(lcd_panel, ' ', sizeof(lcd_panel));
+        lcd_addr = 0;
+    } else if (cmd == LCD_CMD_HOME) {
+        lcd_addr = 0;
+    } else if (cmd & LCD_CMD_SET_CGRAM) {
+        lcd_addr = LCD_ADDR_UNKNOWN;  // CGRAM access
+    }
+    
+    // Clear and home take 1.52 ms, longer than the bus can cover
+    if (cmd == LCD_CMD_CLEAR || cmd == LCD_CMD_HOME) {
+        lcd_burst_flush();
+        lcd_wait_ms(2);
+    }
+}
+
+/**
+ * @brief Queue a data byte, mirroring it into the panel copy
+ */
+static void lcd_queue_data(uint8_t data)
+{
+    lcd_send_byte(data, 1);  // RS = 1 for data
+    lcd_track_data(data);
+}
+
+/**
+ * @brief Forget what the panel shows after bytes were lost on the bus
+ */
+static void lcd_mark_stale(void)
+{
+    memset(lcd_panel, LCD_CELL_STALE, sizeof(lcd_panel));
+    lcd_addr = LCD_ADDR_UNKNOWN;
+}
+
+/**
+ * @brief Mirror a data write into lcd_panel and advance the address counter
+ */
+static void lcd_track_data(uint8_t data)
+{
+    if (lcd_addr == LCD_ADDR_UNKNOWN) {
+        return;
+    }
+    
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        if (lcd_addr >= row_offsets[row] && lcd_addr < row_offsets[row] + LCD_COLS) {
+            lcd_panel[row][lcd_addr - row_offsets[row]] = (char)data;
+            break;
+        }
+    }
+    
+    lcd_addr++;
+}
+
 /**
  * @brief Initialize LCD with proper timing
  */
@@ -71,18 +451,24 @@ bool BSP_LCD_Init(I2C_HandleTypeDef *hi2c)
 {
     lcd_i2c = hi2c;
     backlight_state = true;
+#if LCD_USE_ASYNC
+    lcd_async_active = false;  // Initialization runs blocking
+#endif
+    lcd_addr = LCD_ADDR_UNKNOWN;
+    memset(lcd_shadow, ' ', sizeof(lcd_shadow));
+    memset(lcd_panel, ' ', sizeof(lcd_panel));
     
-    printf("Initializing LCD at address 0x%02X (8-bit: 0x%02X)...\r\n", 
+    LOG_DEBUG("Initializing LCD at address 0x%02X (8-bit: 0x%02X)...\r\n", 
            LCD_I2C_ADDR >> 1, LCD_I2C_ADDR);
     
     // Check if PCF8574 is accessible
     if (HAL_I2C_IsDeviceReady(lcd_i2c, LCD_I2C_ADDR, 3, 100) != HAL_OK) {
-        printf("ERROR: LCD/PCF8574 not responding at address 0x%02X\r\n", 
+        LOG_ERROR("ERROR: LCD/PCF8574 not responding at address 0x%02X\r\n", 
                LCD_I2C_ADDR >> 1);
         return false;
     }
     
-    printf("PCF8574 detected, initializing LCD...\r\n");
+    LOG_DEBUG("PCF8574 detected, initializing LCD...\r\n");
     
     // Wait for LCD power-on (min 15ms after VCC reaches 4.5V)
     HAL_Delay(50);
@@ -90,46 +476,59 @@ bool BSP_LCD_Init(I2C_HandleTypeDef *hi2c)
     // Initialize LCD in 4-bit mode (HD44780 initialization sequence)
     // Step 1: Function set (8-bit mode) - 3 times
     lcd_send_nibble(0x30, 0);
+    lcd_burst_flush();
     HAL_Delay(5);  // Wait > 4.1ms
     
     lcd_send_nibble(0x30, 0);
+    lcd_burst_flush();
     HAL_Delay(1);  // Wait > 100us
     
     lcd_send_nibble(0x30, 0);
+    lcd_burst_flush();
     HAL_Delay(1);
     
     // Step 2: Function set (4-bit mode)
     lcd_send_nibble(0x20, 0);
+    lcd_burst_flush();
     HAL_Delay(1);
     
+#if LCD_USE_BUSY_FLAG
+    // BF is readable from here on if RW is wired; otherwise use delays
+    lcd_busy_flag_ok = lcd_poll_busy(LCD_BUSY_TIMEOUT_MS);
+    LOG_DEBUG("LCD busy flag %s\r\n", lcd_busy_flag_ok ? "enabled" : "not readable, using delays");
+#endif
+    
     // Now in 4-bit mode, send full commands
     // Function set: 4-bit, 2 lines, 5x8 dots
     BSP_LCD_Send_Cmd(LCD_CMD_4BIT_MODE);
-    HAL_Delay(1);
+    lcd_wait_ms(1);
     
     // Display off
     BSP_LCD_Send_Cmd(LCD_CMD_DISPLAY_OFF);
-    HAL_Delay(1);
+    lcd_wait_ms(1);
     
-    // Clear display
+    // Clear display (Send_Cmd already waits for it to complete)
     BSP_LCD_Send_Cmd(LCD_CMD_CLEAR);
-    HAL_Delay(2);  // Clear command takes longer
     
     // Entry mode set: increment, no shift
     BSP_LCD_Send_Cmd(LCD_CMD_ENTRY_MODE);
-    HAL_Delay(1);
+    lcd_wait_ms(1);
     
     // Display on, cursor off, blink off
     BSP_LCD_Send_Cmd(LCD_CMD_DISPLAY_ON);
-    HAL_Delay(1);
+    lcd_wait_ms(1);
     
-    printf("LCD initialized successfully!\r\n");
+    LOG_INFO("LCD initialized successfully!\r\n");
     
     // Test display
     BSP_LCD_Send_String("LCD Ready!");
     HAL_Delay(1000);
     BSP_LCD_Clear();
     
+#if LCD_USE_ASYNC
+    lcd_async_active = true;
+#endif
+    
     return true;
 }
 
@@ -138,12 +537,8 @@ bool BSP_LCD_Init(I2C_HandleTypeDef *hi2c)
  */
 void BSP_LCD_Send_Cmd(uint8_t cmd)
 {
-    lcd_send_byte(cmd, 0);  // RS = 0 for command
-    
-    // Extra delay for clear and home commands
-    if (cmd == LCD_CMD_CLEAR || cmd == LCD_CMD_HOME) {
-        HAL_Delay(2);
-    }
+    lcd_queue_cmd(cmd);
+    lcd_burst_flush();
 }
 
 /**
@@ -151,7 +546,8 @@ void BSP_LCD_Send_Cmd(uint8_t cmd)
  */
 void BSP_LCD_Send_Data(uint8_t data)
 {
-    lcd_send_byte(data, 1);  // RS = 1 for data
+    lcd_queue_data(data);
+    lcd_burst_flush();
 }
 
 /**
@@ -160,6 +556,7 @@ void BSP_LCD_Send_Data(uint8_t data)
 void BSP_LCD_Clear(void)
 {
     BSP_LCD_Send_Cmd(LCD_CMD_CLEAR);
+    memset(lcd_shadow, ' ', sizeof(lcd_shadow));
 }
 
 /**
@@ -167,22 +564,21 @@ void BSP_LCD_Clear(void)
  */
 void BSP_LCD_SetCursor(uint8_t row, uint8_t col)
 {
-    uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};
-    
-    if (row > 1) row = 1;  // Limit to 2 rows for 16x2 LCD
-    if (col > 15) col = 15; // Limit to 16 columns
+    if (row >= LCD_ROWS) row = LCD_ROWS - 1;
+    if (col >= LCD_COLS) col = LCD_COLS - 1;
     
     BSP_LCD_Send_Cmd(LCD_CMD_SET_DDRAM | (col + row_offsets[row]));
 }
 
 /**
- * @brief Send string to LCD
+ * @brief Send string to LCD as a single burst
  */
 void BSP_LCD_Send_String(const char *str)
 {
     while (*str) {
-        BSP_LCD_Send_Data(*str++);
+        lcd_queue_data((uint8_t)*str++);
     }
+    lcd_burst_flush();
 }
 
 /**
@@ -193,6 +589,188 @@ void BSP_LCD_Backlight(bool state)
     backlight_state = state;
     
     // Update backlight immediately
-    uint8_t data = backlight_state ? LCD_PIN_BL : 0;
-    lcd_write_i2c(data);
+    lcd_burst[lcd_burst_len++] = backlight_state ? LCD_PIN_BL : 0;
+    lcd_burst_flush();
+}
+
+/**
+ * @brief Switch the panel on or off
+ * @note  DDRAM and CGRAM are kept while off, so the last screen
+ *        reappears when switched back on.
+ */
+void BSP_LCD_Display(bool on)
+{
+    BSP_LCD_Send_Cmd(on ? LCD_CMD_DISPLAY_ON : LCD_CMD_DISPLAY_OFF);
+}
+
+/**
+ * @brief Upload a 5x8 custom character into a CGRAM slot
+ * @note  Leaves the address counter in CGRAM; the next DDRAM write
+ *        (or commit) re-addresses DDRAM first.
+ */
+void BSP_LCD_LoadGlyph(uint8_t slot, const uint8_t pattern[LCD_GLYPH_ROWS])
+{
+    if (slot >= LCD_CGRAM_SLOTS) {
+        return;
+    }
+    
+    lcd_queue_cmd(LCD_CMD_SET_CGRAM | (slot << 3));
+    for (uint8_t i = 0; i < LCD_GLYPH_ROWS; i++) {
+        lcd_queue_data(pattern[i] & 0x1F);
+    }
+    lcd_burst_flush();
+}
+
+/**
+ * @brief Fill the shadow framebuffer with spaces (no I2C traffic)
+ */
+void BSP_LCD_Buffer_Clear(void)
+{
+    memset(lcd_shadow, ' ', sizeof(lcd_shadow));
+}
+
+/**
+ * @brief Write a string into the shadow framebuffer, clipped at the row end
+ */
+void BSP_LCD_Buffer_Write(uint8_t row, uint8_t col, const char *str)
+{
+    if (row >= LCD_ROWS) {
+        return;
+    }
+    
+    while (*str && col < LCD_COLS) {
+        lcd_shadow[row][col++] = *str++;
+    }
+}
+
+/**
+ * @brief Write a whole row into the shadow framebuffer, padding with spaces
+ */
+void BSP_LCD_Buffer_WriteLine(uint8_t row, const char *str)
+{
+    if (row >= LCD_ROWS) {
+        return;
+    }
+    
+    uint8_t col = 0;
+    while (*str && col < LCD_COLS) {
+        lcd_shadow[row][col++] = *str++;
+    }
+    while (col < LCD_COLS) {
+        lcd_shadow[row][col++] = ' ';
+    }
+}
+
+/**
+ * @brief Send only the cells that differ between shadow and panel
+ * @note  A cursor jump is issued only when the next dirty cell is not
+ *        the one the address counter already points at. All changes go
+ *        out as bursts of up to LCD_BURST_SIZE expander bytes.
+ */
+void BSP_LCD_Commit(void)
+{
+#if LCD_USE_ASYNC
+    // Set from the I2C interrupt, applied here so a commit in progress
+    // never sees the mirror change under it
+    if (lcd_panel_lost) {
+        lcd_panel_lost = false;
+        lcd_mark_stale();
+    }
+#endif
+    
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        for (uint8_t col = 0; col < LCD_COLS; col++) {
+            if (lcd_shadow[row][col] == lcd_panel[row][col]) {
+                continue;
+            }
+            
+            uint8_t addr = row_offsets[row] + col;
+            if (lcd_addr != addr) {
+                lcd_queue_cmd(LCD_CMD_SET_DDRAM | addr);
+            }
+            lcd_queue_data((uint8_t)lcd_shadow[row][col]);
+        }
+    }
+    
+    lcd_burst_flush();
+    
+    // Numbered once queued, so the drain cannot report it done early
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    lcd_commit_seq++;
+#if LCD_USE_ASYNC
+    lcd_commit_end[lcd_commit_seq & LCD_DONE_MASK] = lcd_queued_count;
+#endif
+    lcd_check_done();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Number of the latest BSP_LCD_Commit()
+ */
+uint32_t BSP_LCD_GetCommitSeq(void)
+{
+    return lcd_commit_seq;
+}
+
+/**
+ * @brief Check if commit number seq is fully sent to the panel
+ * @param cycles BSP_Time_Cycles() when its last byte left the bus
+ * @note  Commits more than LCD_DONE_HISTORY behind the latest done one
+ *        report the oldest stamp kept, which is later than their own
+ */
+bool BSP_LCD_GetCommitDone(uint32_t seq, uint32_t *cycles)
+{
+    uint32_t primask = __get_PRIMASK();
+    bool done;
+    
+    __disable_irq();
+    done = (int32_t)(lcd_done_seq - seq) >= 0;
+    if (done) {
+        if (lcd_done_seq - seq >= LCD_DONE_HISTORY) {
+            seq = lcd_done_seq - (LCD_DONE_HISTORY - 1U);
+        }
+        *cycles = lcd_done_cycles[seq & LCD_DONE_MASK];
+    }
+    __set_PRIMASK(primask);
+    return done;
+}
+
+/**
+ * @brief SysTick hook: resume the queue once a timed gap has elapsed, or
+ *        retry a transfer the HAL refused to start
+ */
+void BSP_LCD_Tick(void)
+{
+#if LCD_USE_ASYNC
+    if (lcd_async_active && !lcd_tx_busy &&
+        (lcd_gap_ms != 0 || lcd_queue_head != lcd_queue_tail)) {
+        lcd_async_kick();
+    }
+#endif
+}
+
+/**
+ * @brief Block until all queued LCD traffic has been sent
+ * @note  I2C2 is shared with the RTC: call before any blocking transfer
+ *        to another device so the two never overlap. Gives up and drops
+ *        the queue after LCD_SYNC_TIMEOUT_MS without progress.
+ */
+void BSP_LCD_Sync(void)
+{
+#if LCD_USE_ASYNC
+    uint16_t tail = lcd_queue_tail;
+    uint32_t start = HAL_GetTick();
+    
+    while (lcd_queue_head != lcd_queue_tail || lcd_tx_busy || lcd_gap_ms != 0) {
+        if (lcd_queue_tail != tail) {
+            tail = lcd_queue_tail;
+            start = HAL_GetTick();
+        } else if ((HAL_GetTick() - start) > LCD_SYNC_TIMEOUT_MS) {
+            lcd_async_abort();
+            break;
+        }
+        lcd_async_kick();
+    }
+#endif
 }
@@ -0,0 +1,178 @@
+/**
+ * @file    bsp_log.c
+ * @brief   Tokenized log frames (LOG_TOKENIZED=1) and the per-site rate limit
+ */
+
+#include "bsp_log.h"
+
+#if LOG_TOKENIZED
+#include "bsp_uart.h"
+
+#define LOG_HEADER_SIZE     4       // Start, length, 16-bit string id
+
+/* Start of the log_fmt section: the linker script defines it at 0 on the
+ * target, GNU ld provides it on host builds.
+ */
+extern const char __start_log_fmt[];
+
+/**
+ * @brief Start a frame for a format string placed in log_fmt
+ */
+void BSP_Log_Begin(LogFrame_t *frame, const char *fmt)
+{
+    uint16_t id = (uint16_t)(fmt - __start_log_fmt);
+    
+    frame->data[0] = LOG_FRAME_START;
+    frame->data[2] = (uint8_t)id;
+    frame->data[3] = (uint8_t)(id >> 8);
+    frame->len = LOG_HEADER_SIZE;
+}
+
+/**
+ * @brief Append an integer argument (4 bytes, little-endian)
+ */
+void BSP_Log_Int(LogFrame_t *frame, uint32_t value)
+{
+    if (frame->len + 4 > LOG_FRAME_MAX) {
+        return;
+    }
+    
+    for (uint8_t i = 0; i < 4; i++) {
+        frame->data[frame->len++] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Append a string argument, cut to fit the frame
+ */
+void BSP_Log_Str(LogFrame_t *frame, const char *str)
+{
+    if (frame->len >= LOG_FRAME_MAX) {
+        return;
+    }
+    
+    while (*str && frame->len < LOG_FRAME_MAX - 1) {
+        frame->data[frame->len++] = (uint8_t)*str++;
+    }
+    frame->data[frame->len++] = '\0';
+}
+
+/**
+ * @brief Queue the frame for the UART
+ */
+void BSP_Log_End(LogFrame_t *frame)
+{
+    frame->data[1] = (uint8_t)(frame->len - 2);
+    BSP_UART_Write(frame->data, frame->len);
+}
+
+#endif /* LOG_TOKENIZED */
+
+#if LOG_LIMIT
+#include "stm32f1xx_hal.h"
+
+#if LOG_TOKENIZED
+/* %@ takes a format id and prints that format's prefix (log_decode) */
+static const char log_repeat_fmt[] __attribute__((section("log_fmt"))) =
+    "%@(repeated %u times)\r\n";
+#endif
+
+static LogSite_t *log_pending = NULL;      // Sites with a count to report
+
+/**
+ * @brief Report how many messages a site dropped
+ * @note  Text mode names the site by the start of its format: leading
+ *        line breaks skipped, up to the first conversion or line break,
+ *        at most LOG_REPEAT_PREFIX characters, trailing spaces trimmed,
+ *        then one space. log_decode applies the same rule to %@.
+ */
+static void log_repeated(LogSite_t *site)
+{
+#if LOG_TOKENIZED
+    LogFrame_t frame;
+    
+    BSP_Log_Begin(&frame, log_repeat_fmt);
+    BSP_Log_Int(&frame, (uint32_t)(site->fmt - __start_log_fmt));
+    BSP_Log_Int(&frame, site->suppressed);
+    BSP_Log_End(&frame);
+#else
+    char prefix[LOG_REPEAT_PREFIX + 2];
+    const char *p = site->fmt;
+    uint8_t n = 0;
+    
+    while (*p == '\r' || *p == '\n') {
+        p++;
+    }
+    while (*p && *p != '%' && *p != '\r' && *p != '\n' && n < LOG_REPEAT_PREFIX) {
+        prefix[n++] = *p++;
+    }
+    while (n > 0 && prefix[n - 1] == ' ') {
+        n--;
+    }
+    if (n > 0) {
+        prefix[n++] = ' ';
+    }
+    prefix[n] = '\0';
+    printf("%s(repeated %u times)\r\n", prefix, (unsigned)site->suppressed);
+#endif
+    site->suppressed = 0;
+}
+
+/**
+ * @brief Decide whether a call site may print now
+ * @return true to print, false if the message is counted instead
+ * @note  Main loop context only, like the printf behind LOG()
+ */
+bool BSP_Log_Allow(LogSite_t *site)
+{
+    uint32_t now = HAL_GetTick();
+    
+    if (now - site->window_start >= LOG_LIMIT_WINDOW_MS) {
+        if (site->suppressed > 0) {
+            log_repeated(site);     // Still firing: report before going on
+        }
+        site->window_start = now;
+        site->count = 0;
+    }
+    
+    if (site->count < LOG_LIMIT_BURST) {
+        site->count++;
+        return true;
+    }
+    
+    if (site->suppressed < UINT16_MAX) {
+        site->suppressed++;
+    }
+    if (!site->pending) {
+        site->pending = true;
+        site->next = log_pending;
+        log_pending = site;
+    }
+    return false;
+}
+
+/**
+ * @brief Report counts of sites whose window is over (main loop)
+ * @note  Only sites with dropped messages are visited
+ */
+void BSP_Log_Process(void)
+{
+    LogSite_t **link = &log_pending;
+    uint32_t now = HAL_GetTick();
+    
+    while (*link != NULL) {
+        LogSite_t *site = *link;
+    
+        if (site->suppressed > 0 && now - site->window_start < LOG_LIMIT_WINDOW_MS) {
+            link = &site->next;
+            continue;
+        }
+        if (site->suppressed > 0) {
+            log_repeated(site);
+        }
+        *link = site->next;
+        site->pending = false;
+    }
+}
+
+#endif /* LOG_LIMIT */
@@ -0,0 +1,210 @@
+/**
+ * @file    bsp_modbus.c
+ * @brief   BSP implementation for the Modbus RTU link
+ *
+ * The USART1 receive interrupt appends each byte to the frame buffer,
+ * updates the CRC and restarts TIM2 (one-pulse, 1 us ticks). TIM2 raises
+ * CC1 after 1.5 and update after 3.5 character times of silence. At 3.5
+ * the frame is complete: if it is intact and addressed to us, it stays in
+ * the buffer for the main loop, which answers in place with
+ * BSP_Modbus_Reply(). Bytes arriving meanwhile are counted and dropped,
+ * so the interrupt never touches a frame being handled. Each interrupt
+ * does a fixed amount of work, whatever the traffic.
+ */
+
+#include "bsp_modbus.h"
+#include "bsp_uart.h"
+
+#define MODBUS_BROADCAST        0x00
+#define MODBUS_FRAME_MIN        4       // Address, function, CRC
+
+/* Silence timing: 11 bits per character; fixed above 19200 baud */
+#define MODBUS_CHAR_US          (11U * 1000000U / MODBUS_BAUD)
+#if MODBUS_BAUD > 19200
+#define MODBUS_T15_US           750U
+#define MODBUS_T35_US           1750U
+#else
+#define MODBUS_T15_US           (MODBUS_CHAR_US * 3U / 2U)
+#define MODBUS_T35_US           (MODBUS_CHAR_US * 7U / 2U)
+#endif
+
+static uint8_t modbus_frame[MODBUS_FRAME_MAX];
+static volatile uint16_t modbus_len = 0;        // Bytes received or waiting
+static volatile uint16_t modbus_crc = 0xFFFF;   // Running CRC of the frame
+static volatile bool modbus_gap = false;        // 1.5 characters of silence seen
+static volatile bool modbus_bad = false;        // Drop the frame at its end
+static volatile bool modbus_ready = false;      // Frame waiting for the main loop
+static uint8_t modbus_address = 1;
+
+static volatile Modbus_Stats_t modbus_stats = {0};
+
+/* CRC-16/MODBUS (reflected 0xA001), one lookup per nibble */
+static const uint16_t modbus_crc_nibble[16] = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+
+static uint16_t modbus_crc_update(uint16_t crc, uint8_t byte)
+{
+    crc = (uint16_t)((crc >> 4) ^ modbus_crc_nibble[(crc ^ byte) & 0x0F]);
+    crc = (uint16_t)((crc >> 4) ^ modbus_crc_nibble[(crc ^ (byte >> 4)) & 0x0F]);
+    return crc;
+}
+
+/**
+ * @brief Byte received (USART1 interrupt): store it, restart the timer
+ */
+static void modbus_rx_byte(uint8_t byte)
+{
+    uint16_t len = modbus_len;
+
+    if (modbus_ready) {
+        modbus_stats.overruns++;
+        modbus_bad = true;      // Also spoils what follows a release
+    } else if ((modbus_gap && len > 0) || len >= MODBUS_FRAME_MAX) {
+        modbus_bad = true;
+    } else {
+        modbus_frame[len] = byte;
+        modbus_len = (uint16_t)(len + 1);
+        modbus_crc = modbus_crc_update(modbus_crc, byte);
+    }
+    modbus_gap = false;
+
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief 3.5 characters of silence: the frame is complete
+ */
+static void modbus_frame_end(void)
+{
+    uint16_t len = modbus_len;
+
+    if (modbus_ready) {
+        // Bytes during a pending frame were counted as overruns
+    } else if (modbus_bad || len < MODBUS_FRAME_MIN) {
+        modbus_stats.frame_errors++;
+    } else if (modbus_crc != 0) {
+        modbus_stats.crc_errors++;
+    } else if (modbus_frame[0] != modbus_address && modbus_frame[0] != MODBUS_BROADCAST) {
+        modbus_stats.ignored++;
+    } else {
+        modbus_stats.frames++;
+        modbus_ready = true;
+    }
+
+    if (!modbus_ready) {
+        modbus_len = 0;
+    }
+    modbus_crc = 0xFFFF;
+    modbus_bad = false;
+    modbus_gap = false;
+}
+
+/**
+ * @brief TIM2 interrupt, called from TIM2_IRQHandler()
+ */
+void BSP_Modbus_TIM_IRQHandler(void)
+{
+    uint32_t sr = TIM2->SR;
+
+    if (sr & TIM_SR_CC1IF) {
+        TIM2->SR = (uint32_t)~TIM_SR_CC1IF;
+        modbus_gap = true;
+    }
+    if (sr & TIM_SR_UIF) {
+        TIM2->SR = (uint32_t)~TIM_SR_UIF;
+        modbus_frame_end();
+    }
+}
+
+/**
+ * @brief Take over USART1 for Modbus RTU
+ * @param huart USART1 handle (TX DMA linked, as for BSP_UART_Init)
+ * @param address Slave address, 1-247
+ * @note  Switches the UART to MODBUS_BAUD and starts TIM2; USART1 must
+ *        carry nothing else from now on.
+ */
+void BSP_Modbus_Init(UART_HandleTypeDef *huart, uint8_t address)
+{
+    modbus_address = address;
+    modbus_len = 0;
+    modbus_crc = 0xFFFF;
+    modbus_gap = false;
+    modbus_bad = false;
+    modbus_ready = false;
+
+    huart->Init.BaudRate = MODBUS_BAUD;
+    HAL_UART_Init(huart);
+    BSP_UART_Init(huart);
+    BSP_UART_SetRxHandler(modbus_rx_byte);
+
+    // TIM2 clock is 2 x PCLK1 = SystemCoreClock: 1 us ticks, one pulse per gap
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    TIM2->CR1 = TIM_CR1_OPM | TIM_CR1_URS;
+    TIM2->PSC = SystemCoreClock / 1000000U - 1U;
+    TIM2->ARR = MODBUS_T35_US - 1U;
+    TIM2->CCR1 = MODBUS_T15_US;
+    TIM2->EGR = TIM_EGR_UG;     // Load PSC; URS keeps this from interrupting
+    TIM2->SR = 0;
+    TIM2->DIER = TIM_DIER_UIE | TIM_DIER_CC1IE;
+
+    // Same priority as USART1, so the two handlers never preempt each other
+    HAL_NVIC_SetPriority(TIM2_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+/**
+ * @brief Get the frame waiting to be handled
+ * @param frame Set to the frame: address, function code, data
+ * @return Length without the CRC, 0 if no frame is waiting
+ * @note  The frame stays valid until BSP_Modbus_Reply/Release()
+ */
+uint16_t BSP_Modbus_Receive(uint8_t **frame)
+{
+    if (!modbus_ready) {
+        return 0;
+    }
+    *frame = modbus_frame;
+    return (uint16_t)(modbus_len - 2U);
+}
+
+/**
+ * @brief Send the reply built in the frame buffer and release it
+ * @param len Reply length without the CRC (address included)
+ */
+void BSP_Modbus_Reply(uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    if (modbus_ready && len <= MODBUS_FRAME_MAX - 2U) {
+        for (uint16_t i = 0; i < len; i++) {
+            crc = modbus_crc_update(crc, modbus_frame[i]);
+        }
+        modbus_frame[len] = (uint8_t)(crc & 0xFF);
+        modbus_frame[len + 1] = (uint8_t)(crc >> 8);
+        BSP_UART_Write(modbus_frame, (uint16_t)(len + 2U));
+    }
+    BSP_Modbus_Release();
+}
+
+/**
+ * @brief Drop the waiting frame without a reply (e.g. broadcast)
+ */
+void BSP_Modbus_Release(void)
+{
+    modbus_len = 0;
+    modbus_ready = false;
+}
+
+/**
+ * @brief Read the link counters
+ */
+void BSP_Modbus_GetStats(Modbus_Stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = modbus_stats;
+    __set_PRIMASK(primask);
+}
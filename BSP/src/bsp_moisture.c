@@ -6,11 +6,14 @@
 #include "bsp_moisture.h"
 
 static ADC_HandleTypeDef *moisture_adc = NULL;
+static uint16_t moisture_last_raw = 0;
 
 /* Calibration values (adjust based on sensor) */
 #define MOISTURE_DRY_VALUE   3800  // ADC value when dry (0%)
 #define MOISTURE_WET_VALUE   1500  // ADC value when wet (100%)
 
+static MoistureCalibration_t moisture_cal = {MOISTURE_DRY_VALUE, MOISTURE_WET_VALUE};
+
 /**
  * @brief Initialize moisture sensor
  */
@@ -44,15 +47,34 @@ uint8_t BSP_Moisture_Get_Percent(void)
     uint16_t raw = BSP_Moisture_Read_Raw();
     int32_t percent;
     
+    moisture_last_raw = raw;
+    
     // Convert to percentage (inverted: lower ADC = higher moisture)
-    if (raw >= MOISTURE_DRY_VALUE) {
+    if (raw >= moisture_cal.dry) {
         percent = 0;
-    } else if (raw <= MOISTURE_WET_VALUE) {
+    } else if (raw <= moisture_cal.wet) {
         percent = 100;
     } else {
-        percent = 100 - ((raw - MOISTURE_WET_VALUE) * 100) / 
-                  (MOISTURE_DRY_VALUE - MOISTURE_WET_VALUE);
+        percent = 100 - ((raw - moisture_cal.wet) * 100) / 
+                  (moisture_cal.dry - moisture_cal.wet);
     }
     
     return (uint8_t)percent;
 }
+
+/**
+ * @brief Raw ADC value behind the last BSP_Moisture_Get_Percent() result
+ */
+uint16_t BSP_Moisture_Get_Last_Raw(void)
+{
+    return moisture_last_raw;
+}
+
+/**
+ * @brief Live calibration, changed in place by the parameter table
+ * @note  Callers must keep dry > wet
+ */
+MoistureCalibration_t *BSP_Moisture_GetCalibration(void)
+{
+    return &moisture_cal;
+}
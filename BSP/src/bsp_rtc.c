@@ -3,7 +3,10 @@
  * @brief   BSP implementation for DS3231 RTC
  */
 
+#define LOG_MODULE  LOG_MODULE_BSP
+
 #include "bsp_rtc.h"
+#include "bsp_log.h"
 #include <stdio.h>
 
 static I2C_HandleTypeDef *rtc_i2c = NULL;
@@ -30,43 +33,43 @@ bool BSP_RTC_Init(I2C_HandleTypeDef *hi2c)
     rtc_i2c = hi2c;
     
     // Check if DS3231 is accessible
-    printf("Checking DS3231 at address 0x%02X...\r\n", DS3231_I2C_ADDR >> 1);
+    LOG_DEBUG("Checking DS3231 at address 0x%02X...\r\n", DS3231_I2C_ADDR >> 1);
     
     if (HAL_I2C_IsDeviceReady(rtc_i2c, DS3231_I2C_ADDR, 3, 100) != HAL_OK) {
-        printf("ERROR: DS3231 not found on I2C bus!\r\n");
+        LOG_ERROR("ERROR: DS3231 not found on I2C bus!\r\n");
         return false;
     }
     
-    printf("DS3231 detected!\r\n");
+    LOG_INFO("DS3231 detected!\r\n");
     
     // Read Control Register
     uint8_t control_reg;
     uint8_t reg_addr = DS3231_REG_CONTROL;
     
     if (HAL_I2C_Master_Transmit(rtc_i2c, DS3231_I2C_ADDR, &reg_addr, 1, 100) != HAL_OK) {
-        printf("ERROR: Failed to read DS3231 control register\r\n");
+        LOG_ERROR("ERROR: Failed to read DS3231 control register\r\n");
         return false;
     }
     
     if (HAL_I2C_Master_Receive(rtc_i2c, DS3231_I2C_ADDR, &control_reg, 1, 100) != HAL_OK) {
-        printf("ERROR: Failed to receive DS3231 control data\r\n");
+        LOG_ERROR("ERROR: Failed to receive DS3231 control data\r\n");
         return false;
     }
     
-    printf("DS3231 Control Register: 0x%02X\r\n", control_reg);
+    LOG_DEBUG("DS3231 Control Register: 0x%02X\r\n", control_reg);
     
     // Enable oscillator if disabled (clear EOSC bit)
     // DS3231: EOSC = 0 means oscillator enabled
     if (control_reg & DS3231_CONTROL_EOSC) {
-        printf("DS3231 oscillator disabled, enabling...\r\n");
+        LOG_INFO("DS3231 oscillator disabled, enabling...\r\n");
         control_reg &= ~DS3231_CONTROL_EOSC;  // Clear EOSC to enable
         
         uint8_t buffer[2] = {DS3231_REG_CONTROL, control_reg};
         if (HAL_I2C_Master_Transmit(rtc_i2c, DS3231_I2C_ADDR, buffer, 2, 100) != HAL_OK) {
-            printf("ERROR: Failed to enable DS3231 oscillator\r\n");
+            LOG_ERROR("ERROR: Failed to enable DS3231 oscillator\r\n");
             return false;
         }
-        printf("DS3231 oscillator enabled\r\n");
+        LOG_INFO("DS3231 oscillator enabled\r\n");
     }
     
     // Check Oscillator Stop Flag (OSF) in Status Register
@@ -76,10 +79,10 @@ bool BSP_RTC_Init(I2C_HandleTypeDef *hi2c)
     HAL_I2C_Master_Transmit(rtc_i2c, DS3231_I2C_ADDR, &reg_addr, 1, 100);
     HAL_I2C_Master_Receive(rtc_i2c, DS3231_I2C_ADDR, &status_reg, 1, 100);
     
-    printf("DS3231 Status Register: 0x%02X\r\n", status_reg);
+    LOG_DEBUG("DS3231 Status Register: 0x%02X\r\n", status_reg);
     
     if (status_reg & DS3231_STATUS_OSF) {
-        printf("WARNING: DS3231 Oscillator Stop Flag set! Time may be invalid.\r\n");
+        LOG_WARN("WARNING: DS3231 Oscillator Stop Flag set! Time may be invalid.\r\n");
         
         // Clear OSF flag
         status_reg &= ~DS3231_STATUS_OSF;
@@ -89,7 +92,7 @@ bool BSP_RTC_Init(I2C_HandleTypeDef *hi2c)
         // Set default time: 2025-01-01 00:00:00
         RTC_Time_t default_time = {0, 0, 0, 1, 1, 1, 25};
         BSP_RTC_SetTime(&default_time);
-        printf("DS3231 initialized with default time\r\n");
+        LOG_INFO("DS3231 initialized with default time\r\n");
     }
     
     return true;
@@ -177,7 +180,7 @@ bool BSP_RTC_SetTime(const RTC_Time_t *time)
     uint8_t clear_buffer[2] = {DS3231_REG_STATUS, status_reg};
     HAL_I2C_Master_Transmit(rtc_i2c, DS3231_I2C_ADDR, clear_buffer, 2, 100);
     
-    printf("Time set: %02d:%02d:%02d\r\n", time->hours, time->minutes, time->seconds);
+    LOG_INFO("Time set: %02d:%02d:%02d\r\n", time->hours, time->minutes, time->seconds);
     
     return true;
 }
@@ -0,0 +1,415 @@
+/**
+ * @file    bsp_ssd1306.c
+ * @brief   BSP implementation for SSD1306 OLED text display
+ *
+ * Text is kept in a character grid like the LCD shadow framebuffer.
+ * Commit renders only the changed cells into a 1 KB pixel framebuffer
+ * and sends only the pages (8-pixel text rows) that changed, one
+ * 128-byte transfer each. When every page changed, the whole frame goes
+ * out in a single transfer.
+ */
+
+#define LOG_MODULE  LOG_MODULE_BSP
+
+#include "bsp_ssd1306.h"
+#include "font5x7.h"
+#include "bsp_log.h"
+#include "bsp_time.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SSD1306_TIMEOUT_MS      100
+#define SSD1306_GLYPH_OFFSET    1       // Blank column left of each glyph
+#define SSD1306_ALL_PAGES       ((1U << SSD1306_PAGES) - 1U)
+#define SSD1306_CELL_REDRAW     '\0'    // oled_drawn marker: cell is stale
+
+static I2C_HandleTypeDef *oled_i2c = NULL;
+
+/* Pixel framebuffer, one byte = 8 vertical pixels (bit 0 on top).
+ * oled_frame[0] holds the data control byte so a full frame can be sent
+ * in place; pages start at oled_frame + 1.
+ */
+static uint8_t oled_frame[1 + SSD1306_PAGES * SSD1306_WIDTH];
+static uint8_t oled_page_tx[1 + SSD1306_WIDTH];
+static uint8_t oled_dirty = 0;          // One bit per page
+
+/* Text grid
+ * oled_text:  characters the upper layers want on screen
+ * oled_drawn: characters rendered into oled_frame
+ */
+static char oled_text[SSD1306_TEXT_ROWS][SSD1306_TEXT_COLS];
+static char oled_drawn[SSD1306_TEXT_ROWS][SSD1306_TEXT_COLS];
+
+/* Custom characters as font columns */
+static uint8_t oled_glyphs[SSD1306_GLYPH_SLOTS][FONT5X7_WIDTH];
+
+static SSD1306_Stats_t oled_stats = {0};
+static uint32_t oled_commit_seq = 0;
+static uint32_t oled_done_seq = 0;      // Latest commit with no page left dirty
+static uint32_t oled_done_cycles[SSD1306_DONE_HISTORY];  // When each commit returned
+
+_Static_assert((SSD1306_DONE_HISTORY & (SSD1306_DONE_HISTORY - 1)) == 0,
+               "SSD1306_DONE_HISTORY must be a power of 2");
+
+/**
+ * @brief Send a command sequence in one transfer
+ */
+static bool oled_send_cmds(const uint8_t *cmds, uint8_t len)
+{
+    uint8_t buffer[32];
+    
+    if (len >= sizeof(buffer)) {
+        return false;
+    }
+    
+    buffer[0] = SSD1306_CTRL_CMD;
+    memcpy(&buffer[1], cmds, len);
+    oled_stats.bytes += len + 1U;
+    
+    if (HAL_I2C_Master_Transmit(oled_i2c, SSD1306_I2C_ADDR, buffer, len + 1U,
+                                SSD1306_TIMEOUT_MS) != HAL_OK) {
+        LOG_ERROR("OLED I2C Error\r\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Send display data (data[0] must be SSD1306_CTRL_DATA)
+ */
+static bool oled_send_data(uint8_t *data, uint16_t len)
+{
+    oled_stats.bytes += len;
+    
+    if (HAL_I2C_Master_Transmit(oled_i2c, SSD1306_I2C_ADDR, data, len,
+                                SSD1306_TIMEOUT_MS) != HAL_OK) {
+        LOG_ERROR("OLED I2C Error\r\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Set the GDDRAM window to full width and a range of pages
+ */
+static bool oled_set_window(uint8_t first_page, uint8_t last_page)
+{
+    const uint8_t cmds[] = {
+        SSD1306_CMD_COLUMN_ADDR, 0, SSD1306_WIDTH - 1,
+        SSD1306_CMD_PAGE_ADDR, first_page, last_page,
+    };
+    return oled_send_cmds(cmds, sizeof(cmds));
+}
+
+/**
+ * @brief Send the dirty pages to the panel
+ * @note  A page that did not go out stays dirty, so the next commit
+ *        resends it even if its text has not changed since
+ */
+static void oled_flush(void)
+{
+    if (oled_i2c == NULL || oled_dirty == 0) {
+        return;
+    }
+    
+    if (oled_dirty == SSD1306_ALL_PAGES) {
+        if (oled_set_window(0, SSD1306_PAGES - 1)) {
+            oled_frame[0] = SSD1306_CTRL_DATA;
+            if (oled_send_data(oled_frame, sizeof(oled_frame))) {
+                oled_dirty = 0;
+            }
+            oled_stats.full_writes++;
+        }
+    } else {
+        for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+            if ((oled_dirty & (1U << page)) == 0) {
+                continue;
+            }
+            if (!oled_set_window(page, page)) {
+                break;
+            }
+            oled_page_tx[0] = SSD1306_CTRL_DATA;
+            memcpy(&oled_page_tx[1], &oled_frame[1 + page * SSD1306_WIDTH], SSD1306_WIDTH);
+            if (oled_send_data(oled_page_tx, sizeof(oled_page_tx))) {
+                oled_dirty &= (uint8_t)~(1U << page);
+            }
+            oled_stats.page_writes++;
+        }
+    }
+}
+
+/**
+ * @brief Stamp the commits made so far as done once no page is dirty
+ */
+static void oled_check_done(void)
+{
+    uint32_t now;
+    
+    if (oled_dirty != 0) {
+        return;
+    }
+    now = BSP_Time_Cycles();
+    while (oled_done_seq != oled_commit_seq) {
+        oled_done_seq++;
+        oled_done_cycles[oled_done_seq & (SSD1306_DONE_HISTORY - 1)] = now;
+    }
+}
+
+/**
+ * @brief Render one text cell into the framebuffer
+ */
+static void oled_draw_cell(uint8_t row, uint8_t col)
+{
+    uint8_t *cell = &oled_frame[1 + row * SSD1306_WIDTH + col * SSD1306_CELL_WIDTH];
+    uint8_t c = (uint8_t)oled_text[row][col];
+    const uint8_t *columns;
+    
+    if (c >= 0x08 && c < 0x08 + SSD1306_GLYPH_SLOTS) {
+        columns = oled_glyphs[c - 0x08];
+    } else if (c >= FONT5X7_FIRST && c <= FONT5X7_LAST) {
+        columns = font5x7[c - FONT5X7_FIRST];
+    } else {
+        columns = font5x7['?' - FONT5X7_FIRST];
+    }
+    
+    memset(cell, 0, SSD1306_CELL_WIDTH);
+    memcpy(&cell[SSD1306_GLYPH_OFFSET], columns, FONT5X7_WIDTH);
+    
+    oled_drawn[row][col] = (char)c;
+    oled_dirty |= (uint8_t)(1U << row);
+}
+
+/**
+ * @brief Initialize SSD1306 (128x64, internal charge pump)
+ * @param hi2c Pointer to I2C handle
+ * @return true if successful, false if device not found
+ */
+bool BSP_SSD1306_Init(I2C_HandleTypeDef *hi2c)
+{
+    static const uint8_t init_cmds[] = {
+        SSD1306_CMD_DISPLAY_OFF,
+        SSD1306_CMD_CLOCK_DIV, 0x80,
+        SSD1306_CMD_MULTIPLEX, SSD1306_HEIGHT - 1,
+        SSD1306_CMD_DISPLAY_OFFSET, 0x00,
+        SSD1306_CMD_START_LINE,
+        SSD1306_CMD_CHARGE_PUMP, 0x14,      // Enable internal charge pump
+        SSD1306_CMD_MEMORY_MODE, 0x00,      // Horizontal addressing
+        SSD1306_CMD_SEG_REMAP,
+        SSD1306_CMD_COM_SCAN_DEC,
+        SSD1306_CMD_COM_PINS, 0x12,
+        SSD1306_CMD_CONTRAST, SSD1306_CONTRAST_NORMAL,
+        SSD1306_CMD_PRECHARGE, 0xF1,
+        SSD1306_CMD_VCOM_DETECT, 0x40,
+        SSD1306_CMD_RESUME_RAM,
+        SSD1306_CMD_NORMAL,
+    };
+    static const uint8_t display_on = SSD1306_CMD_DISPLAY_ON;
+    
+    oled_i2c = hi2c;
+    oled_dirty = 0;
+    
+    LOG_DEBUG("Initializing OLED at address 0x%02X (8-bit: 0x%02X)...\r\n",
+           SSD1306_I2C_ADDR >> 1, SSD1306_I2C_ADDR);
+    
+    if (HAL_I2C_IsDeviceReady(oled_i2c, SSD1306_I2C_ADDR, 3, 100) != HAL_OK) {
+        LOG_ERROR("ERROR: SSD1306 not responding at address 0x%02X\r\n",
+               SSD1306_I2C_ADDR >> 1);
+        oled_i2c = NULL;
+        return false;
+    }
+    
+    if (!oled_send_cmds(init_cmds, sizeof(init_cmds))) {
+        oled_i2c = NULL;
+        return false;
+    }
+    
+    // GDDRAM content is random at power-up: send a blank frame once
+    memset(oled_text, ' ', sizeof(oled_text));
+    memset(oled_drawn, ' ', sizeof(oled_drawn));
+    memset(oled_frame, 0, sizeof(oled_frame));
+    BSP_SSD1306_Refresh();
+    
+    oled_send_cmds(&display_on, 1);
+    
+    LOG_INFO("OLED initialized successfully!\r\n");
+    return true;
+}
+
+/**
+ * @brief Send the whole framebuffer, regardless of what changed
+ */
+void BSP_SSD1306_Refresh(void)
+{
+    oled_dirty = SSD1306_ALL_PAGES;
+    oled_flush();
+    oled_check_done();
+}
+
+/**
+ * @brief Set cursor position
+ * @note  The OLED shows no text cursor (like the LCD with cursor off);
+ *        kept so both backends offer the same API.
+ */
+void BSP_SSD1306_SetCursor(uint8_t row, uint8_t col)
+{
+    (void)row;
+    (void)col;
+}
+
+/**
+ * @brief Switch the panel on or off
+ * @note  GDDRAM is kept while off; the panel draws almost no current.
+ */
+void BSP_SSD1306_Display(bool on)
+{
+    uint8_t cmd = on ? SSD1306_CMD_DISPLAY_ON : SSD1306_CMD_DISPLAY_OFF;
+    
+    if (oled_i2c != NULL) {
+        oled_send_cmds(&cmd, 1);
+    }
+}
+
+/**
+ * @brief Lower the contrast (the OLED has no backlight)
+ */
+void BSP_SSD1306_Dim(bool dim)
+{
+    const uint8_t cmds[] = {
+        SSD1306_CMD_CONTRAST, dim ? SSD1306_CONTRAST_DIM : SSD1306_CONTRAST_NORMAL,
+    };
+    
+    if (oled_i2c != NULL) {
+        oled_send_cmds(cmds, sizeof(cmds));
+    }
+}
+
+/**
+ * @brief Define a 5x8 custom character
+ * @note  Cells showing the slot are redrawn by the next commit.
+ */
+void BSP_SSD1306_LoadGlyph(uint8_t slot, const uint8_t pattern[SSD1306_GLYPH_ROWS])
+{
+    if (slot >= SSD1306_GLYPH_SLOTS) {
+        return;
+    }
+    
+    // Row-major LCD pattern (bit 4 = left pixel) to font columns
+    for (uint8_t x = 0; x < FONT5X7_WIDTH; x++) {
+        uint8_t column = 0;
+        for (uint8_t y = 0; y < SSD1306_GLYPH_ROWS; y++) {
+            if (pattern[y] & (0x10 >> x)) {
+                column |= (uint8_t)(1U << y);
+            }
+        }
+        oled_glyphs[slot][x] = column;
+    }
+    
+    for (uint8_t row = 0; row < SSD1306_TEXT_ROWS; row++) {
+        for (uint8_t col = 0; col < SSD1306_TEXT_COLS; col++) {
+            if (oled_drawn[row][col] == SSD1306_GLYPH_CODE(slot)) {
+                oled_drawn[row][col] = SSD1306_CELL_REDRAW;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Read the transfer counters
+ */
+void BSP_SSD1306_GetStats(SSD1306_Stats_t *stats)
+{
+    *stats = oled_stats;
+}
+
+/**
+ * @brief Framebuffer pages, SSD1306_PAGES x SSD1306_WIDTH bytes
+ */
+const uint8_t *BSP_SSD1306_GetFramebuffer(void)
+{
+    return &oled_frame[1];
+}
+
+/**
+ * @brief Fill the text buffer with spaces (no I2C traffic)
+ */
+void BSP_SSD1306_Buffer_Clear(void)
+{
+    memset(oled_text, ' ', sizeof(oled_text));
+}
+
+/**
+ * @brief Write a string into the text buffer, clipped at the row end
+ */
+void BSP_SSD1306_Buffer_Write(uint8_t row, uint8_t col, const char *str)
+{
+    if (row >= SSD1306_TEXT_ROWS) {
+        return;
+    }
+    
+    while (*str && col < SSD1306_TEXT_COLS) {
+        oled_text[row][col++] = *str++;
+    }
+}
+
+/**
+ * @brief Replace a whole row in the text buffer, padding with spaces
+ */
+void BSP_SSD1306_Buffer_WriteLine(uint8_t row, const char *str)
+{
+    uint8_t col = 0;
+    
+    if (row >= SSD1306_TEXT_ROWS) {
+        return;
+    }
+    
+    while (*str && col < SSD1306_TEXT_COLS) {
+        oled_text[row][col++] = *str++;
+    }
+    while (col < SSD1306_TEXT_COLS) {
+        oled_text[row][col++] = ' ';
+    }
+}
+
+/**
+ * @brief Render changed cells and send the pages they are on
+ */
+void BSP_SSD1306_Commit(void)
+{
+    for (uint8_t row = 0; row < SSD1306_TEXT_ROWS; row++) {
+        for (uint8_t col = 0; col < SSD1306_TEXT_COLS; col++) {
+            if (oled_text[row][col] != oled_drawn[row][col]) {
+                oled_draw_cell(row, col);
+            }
+        }
+    }
+    
+    oled_flush();
+    oled_commit_seq++;
+    oled_check_done();
+}
+
+/**
+ * @brief Number of the latest BSP_SSD1306_Commit()
+ */
+uint32_t BSP_SSD1306_GetCommitSeq(void)
+{
+    return oled_commit_seq;
+}
+
+/**
+ * @brief Check if commit number seq is on the panel
+ * @param cycles BSP_Time_Cycles() when its last page went out
+ * @note  Commits more than SSD1306_DONE_HISTORY old report the oldest
+ *        stamp kept, which is later than their own
+ */
+bool BSP_SSD1306_GetCommitDone(uint32_t seq, uint32_t *cycles)
+{
+    if ((int32_t)(oled_done_seq - seq) < 0) {
+        return false;
+    }
+    if (oled_done_seq - seq >= SSD1306_DONE_HISTORY) {
+        seq = oled_done_seq - (SSD1306_DONE_HISTORY - 1U);
+    }
+    *cycles = oled_done_cycles[seq & (SSD1306_DONE_HISTORY - 1)];
+    return true;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file    bsp_time.c
+ * @brief   BSP implementation for cycle-accurate timestamps
+ */
+
+#include "bsp_time.h"
+
+/**
+ * @brief Start the DWT cycle counter
+ * @note  Safe to call again (BSP_DHT11_Init enables the same counter)
+ */
+void BSP_Time_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Convert a cycle count difference to microseconds
+ */
+uint32_t BSP_Time_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
@@ -0,0 +1,327 @@
+/**
+ * @file    bsp_uart.c
+ * @brief   BSP implementation for the non-blocking debug UART
+ *
+ * Single producer (main loop, through _write) and single consumer (the
+ * DMA completion interrupt). The producer only moves head and the
+ * consumer only moves tail, so queuing needs no lock; only starting a
+ * transfer and UART_TX_DROP_OLDEST take a short PRIMASK section.
+ * Each transfer is copied to a separate DMA buffer, so the whole ring
+ * stays writable while the DMA runs.
+ *
+ * RX is the mirror image: the receive interrupt is the producer, one byte
+ * at a time, and BSP_UART_Read() in the main loop the consumer. Bytes
+ * arriving with the ring full are counted and discarded; the interrupt
+ * never waits. A protocol that needs every byte as it arrives (Modbus RTU
+ * timing) can take them in the interrupt instead, see
+ * BSP_UART_SetRxHandler().
+ */
+
+#include "bsp_uart.h"
+#include <string.h>
+
+#define UART_TX_MASK            (UART_TX_BUFFER_SIZE - 1)
+#define UART_RX_MASK            (UART_RX_BUFFER_SIZE - 1)
+
+_Static_assert((UART_TX_BUFFER_SIZE & UART_TX_MASK) == 0,
+               "UART_TX_BUFFER_SIZE must be a power of 2");
+_Static_assert(UART_TX_BUFFER_SIZE <= 32768, "Ring indices are 16-bit");
+_Static_assert((UART_RX_BUFFER_SIZE & UART_RX_MASK) == 0,
+               "UART_RX_BUFFER_SIZE must be a power of 2");
+_Static_assert(UART_RX_BUFFER_SIZE <= 32768, "Ring indices are 16-bit");
+
+static UART_HandleTypeDef *uart_tx = NULL;
+
+static uint8_t uart_ring[UART_TX_BUFFER_SIZE];
+static volatile uint16_t uart_head = 0;     // Free-running, producer
+static volatile uint16_t uart_tail = 0;     // Free-running, consumer
+static volatile bool uart_tx_busy = false;
+static uint8_t uart_dma_buf[UART_TX_CHUNK];
+
+static uint8_t uart_rx_ring[UART_RX_BUFFER_SIZE];
+static volatile uint16_t uart_rx_head = 0;  // Free-running, RX interrupt
+static volatile uint16_t uart_rx_tail = 0;  // Free-running, main loop
+static uint8_t uart_rx_byte;                // Target of the 1-byte receive
+static volatile UART_RxHandler_t uart_rx_handler = NULL;
+
+static volatile UART_Stats_t uart_stats = {0};
+
+/**
+ * @brief Start the next DMA transfer if the UART is idle
+ * @note  Safe to call from main loop and interrupts
+ */
+static void uart_kick(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (!uart_tx_busy && uart_tx != NULL) {
+        uint16_t tail = uart_tail;
+        uint16_t len = (uint16_t)(uart_head - tail);
+        
+        if (len > UART_TX_CHUNK) {
+            len = UART_TX_CHUNK;
+        }
+        
+        for (uint16_t i = 0; i < len; i++) {
+            uart_dma_buf[i] = uart_ring[(tail + i) & UART_TX_MASK];
+        }
+        
+        // Consume bytes only once the transfer is actually running
+        if (len > 0 && HAL_UART_Transmit_DMA(uart_tx, uart_dma_buf, len) == HAL_OK) {
+            uart_tx_busy = true;
+            uart_tail = (uint16_t)(tail + len);
+            uart_stats.bytes_sent += len;
+        }
+    }
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Make room for up to len bytes according to UART_TX_POLICY
+ * @return Bytes that may be queued now
+ */
+static uint16_t uart_reserve(uint16_t len)
+{
+    uint16_t space = (uint16_t)(UART_TX_BUFFER_SIZE - (uint16_t)(uart_head - uart_tail));
+    
+#if UART_TX_POLICY == UART_TX_BLOCK
+    // Waiting only works where the DMA interrupt can still run
+    if (__get_IPSR() == 0 && __get_PRIMASK() == 0) {
+        while (space == 0) {
+            uart_kick();
+            space = (uint16_t)(UART_TX_BUFFER_SIZE - (uint16_t)(uart_head - uart_tail));
+        }
+    }
+    return (len < space) ? len : space;
+#elif UART_TX_POLICY == UART_TX_DROP_OLDEST
+    if (len > UART_TX_BUFFER_SIZE) {
+        len = UART_TX_BUFFER_SIZE;
+    }
+    if (space < len) {
+        uint32_t primask = __get_PRIMASK();
+        uint16_t drop;
+        
+        __disable_irq();
+        space = (uint16_t)(UART_TX_BUFFER_SIZE - (uint16_t)(uart_head - uart_tail));
+        drop = (space < len) ? (uint16_t)(len - space) : 0;
+        uart_tail = (uint16_t)(uart_tail + drop);
+        uart_stats.bytes_dropped += drop;
+        __set_PRIMASK(primask);
+    }
+    return len;
+#else
+    // All or nothing, so a line is never cut in half
+    return (len <= space) ? len : 0;
+#endif
+}
+
+/**
+ * @brief Copy bytes into the ring, publish them and start the DMA
+ */
+static void uart_push(const uint8_t *data, uint16_t count)
+{
+    uint16_t head = uart_head;
+    uint16_t fill;
+    
+    for (uint16_t i = 0; i < count; i++) {
+        uart_ring[(head + i) & UART_TX_MASK] = data[i];
+    }
+    uart_head = (uint16_t)(head + count);
+    
+    fill = (uint16_t)(uart_head - uart_tail);
+    if (fill > uart_stats.peak) {
+        uart_stats.peak = fill;
+    }
+    
+    uart_kick();
+}
+
+/**
+ * @brief Arm the interrupt-driven receive of the next byte
+ */
+static void uart_rx_arm(void)
+{
+    HAL_UART_Receive_IT(uart_tx, &uart_rx_byte, 1);
+}
+
+/**
+ * @brief DMA transfer complete: send what was queued meanwhile
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == uart_tx) {
+        uart_tx_busy = false;
+        uart_kick();
+    }
+}
+
+/**
+ * @brief Byte received: store it and re-arm
+ */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == uart_tx) {
+        uint16_t head = uart_rx_head;
+        
+        if (uart_rx_handler != NULL) {
+            uart_stats.rx_bytes++;
+            uart_rx_handler(uart_rx_byte);
+        } else if ((uint16_t)(head - uart_rx_tail) < UART_RX_BUFFER_SIZE) {
+            uart_rx_ring[head & UART_RX_MASK] = uart_rx_byte;
+            uart_rx_head = (uint16_t)(head + 1);
+            uart_stats.rx_bytes++;
+        } else {
+            uart_stats.rx_dropped++;
+        }
+        uart_rx_arm();
+    }
+}
+
+/**
+ * @brief UART error: a TX chunk is lost and/or reception was stopped
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != uart_tx) {
+        return;
+    }
+    
+    if (huart->ErrorCode & HAL_UART_ERROR_DMA) {
+        uart_stats.errors++;
+        uart_tx_busy = false;
+        uart_kick();
+    }
+    if (huart->ErrorCode & (HAL_UART_ERROR_ORE | HAL_UART_ERROR_FE |
+                            HAL_UART_ERROR_NE | HAL_UART_ERROR_PE)) {
+        uart_stats.rx_errors++;
+    }
+    // Overrun ends the receive; restart it, keep draining TX
+    if (huart->RxState == HAL_UART_STATE_READY) {
+        uart_rx_arm();
+    }
+}
+
+/**
+ * @brief Initialize the TX ring for a UART with TX DMA linked
+ * @param huart Pointer to UART handle
+ */
+void BSP_UART_Init(UART_HandleTypeDef *huart)
+{
+    uart_tx = huart;
+    uart_head = 0;
+    uart_tail = 0;
+    uart_tx_busy = false;
+    uart_rx_head = 0;
+    uart_rx_tail = 0;
+    memset((void *)&uart_stats, 0, sizeof(uart_stats));
+    
+    uart_rx_arm();
+}
+
+/**
+ * @brief Queue bytes for transmission
+ * @param data Bytes to send
+ * @param len Number of bytes
+ * @return Number of bytes queued; the rest was dropped
+ * @note  Copies into the ring and returns; call from one context only
+ *        (the main loop).
+ */
+uint16_t BSP_UART_Write(const uint8_t *data, uint16_t len)
+{
+    uint16_t queued = 0;
+    
+    if (uart_tx == NULL) {
+        return 0;
+    }
+    
+#if UART_TX_POLICY == UART_TX_BLOCK
+    while (queued < len) {
+        uint16_t count = uart_reserve(len - queued);
+        
+        if (count == 0) {
+            break;  // Full and unable to wait
+        }
+        uart_push(data + queued, count);
+        queued += count;
+    }
+#else
+    // DROP_OLDEST keeps the end of an oversized write
+    queued = uart_reserve(len);
+    uart_push(data + (len - queued), queued);
+#endif
+    
+    if (queued < len) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        uart_stats.bytes_dropped += len - queued;
+        __set_PRIMASK(primask);
+    }
+    
+    return queued;
+}
+
+/**
+ * @brief Wait until everything queued has been handed to the DMA
+ */
+void BSP_UART_Flush(void)
+{
+    if (uart_tx == NULL) {
+        return;
+    }
+    
+    while (uart_head != uart_tail || uart_tx_busy) {
+        uart_kick();
+    }
+}
+
+/**
+ * @brief Bytes the TX ring can take right now without dropping anything
+ */
+uint16_t BSP_UART_TxSpace(void)
+{
+    return (uint16_t)(UART_TX_BUFFER_SIZE - (uint16_t)(uart_head - uart_tail));
+}
+
+/**
+ * @brief Take received bytes out of the RX ring
+ * @param data Destination
+ * @param max Bytes wanted at most
+ * @return Bytes copied, 0 if nothing is pending; never waits
+ */
+uint16_t BSP_UART_Read(uint8_t *data, uint16_t max)
+{
+    uint16_t tail = uart_rx_tail;
+    uint16_t count = (uint16_t)(uart_rx_head - tail);
+    
+    if (count > max) {
+        count = max;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        data[i] = uart_rx_ring[(tail + i) & UART_RX_MASK];
+    }
+    uart_rx_tail = (uint16_t)(tail + count);
+    
+    return count;
+}
+
+/**
+ * @brief Hand received bytes to a function instead of the RX ring
+ * @param handler Called from the receive interrupt, NULL for the ring
+ */
+void BSP_UART_SetRxHandler(UART_RxHandler_t handler)
+{
+    uart_rx_handler = handler;
+}
+
+/**
+ * @brief Read the transmit and receive counters
+ */
+void BSP_UART_GetStats(UART_Stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = uart_stats;
+    __set_PRIMASK(primask);
+}
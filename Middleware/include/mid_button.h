@@ -1,6 +1,19 @@
 /**
  * @file    mid_button.h
  * @brief   Middleware for button event handling with debouncing
+ *
+ * MID_Button_Update() turns debounced edges into event records, in the
+ * order they happened across all buttons, and queues them;
+ * MID_Button_GetEvent() takes the oldest. A press gives PRESSED, plus
+ * DOUBLE_CLICK when it follows a short click of the same button within
+ * DOUBLE_CLICK_MS, plus HOLD (long press) once it has lasted
+ * HOLD_TIME_MS; letting go gives RELEASED.
+ *
+ * Buttons in BUTTON_REPEAT_MASK also repeat while held, from the HOLD on:
+ * every REPEAT_SLOW_MS at first, every REPEAT_FAST_MS after
+ * REPEAT_FAST_AFTER_MS, then in steps of 10 every REPEAT_SLOW_MS after
+ * REPEAT_TENS_AFTER_MS. Repeats that fall due in the same pass come as one
+ * REPEAT whose step is their sum.
  */
 
 #ifndef MID_BUTTON_H
@@ -10,19 +23,50 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifndef HOLD_TIME_MS
+#define HOLD_TIME_MS            1000    // Long press
+#endif
+
+#ifndef DOUBLE_CLICK_MS
+#define DOUBLE_CLICK_MS         300     // Release to next press
+#endif
+
+#ifndef BUTTON_REPEAT_MASK
+#define BUTTON_REPEAT_MASK      ((1U << BUTTON_INC) | (1U << BUTTON_DEC))
+#endif
+
+#define REPEAT_SLOW_MS          200     // Repeat period, step 1 then 10
+#define REPEAT_FAST_MS          50      // Repeat period, step 1
+#define REPEAT_FAST_AFTER_MS    1000    // Held past HOLD_TIME_MS
+#define REPEAT_TENS_AFTER_MS    3000    // Held past HOLD_TIME_MS
+
+#define BUTTON_EVENT_QUEUE      16      // Events, must be a power of 2
+
 /* Button event types */
 typedef enum {
     BUTTON_EVENT_NONE = 0,
     BUTTON_EVENT_PRESSED,
     BUTTON_EVENT_RELEASED,
-    BUTTON_EVENT_HOLD
+    BUTTON_EVENT_HOLD,
+    BUTTON_EVENT_DOUBLE_CLICK,
+    BUTTON_EVENT_REPEAT
 } ButtonEvent_t;
 
+/* One queued event */
+typedef struct {
+    uint32_t time;          // HAL tick (ms) it happened
+    uint32_t cycles;        // BSP_Time_Cycles() of the edge, or of the pass
+    uint8_t button;         // Button_t
+    uint8_t event;          // ButtonEvent_t
+    uint8_t step;           // REPEAT: steps it stands for, others: 1
+} ButtonEventRecord_t;
+
 /* Middleware Function Prototypes */
 void MID_Button_Init(void);
 void MID_Button_Update(void);
-bool MID_Button_IsPressed(Button_t button);
-bool MID_Button_IsReleased(Button_t button);
+bool MID_Button_GetEvent(ButtonEventRecord_t *event);
 bool MID_Button_IsHeld(Button_t button);
+bool MID_Button_HadActivity(void);
+const char *MID_Button_Name(Button_t button);
 
 #endif /* MID_BUTTON_H */
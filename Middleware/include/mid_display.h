@@ -6,10 +6,32 @@
 #ifndef MID_DISPLAY_H
 #define MID_DISPLAY_H
 
-#include "bsp_lcd.h"
+#include "mid_display_port.h"
 #include "bsp_rtc.h"
 #include <stdint.h>
 
+/* Refresh scheduler */
+#define DISPLAY_MAX_FPS         10      // Renders per second at most
+#define DISPLAY_FRAME_MS        (1000 / DISPLAY_MAX_FPS)
+#define DISPLAY_PAGE_MS         5000    // 2-row panels: MANUAL/AUTO rotate through their pages
+
+/* Idle power management: without a button event or pump change the
+ * backlight goes off (OLED: dimmed), then the panel is switched off.
+ * Rendering stops while the panel is off. 0 disables a stage.
+ */
+#ifndef DISPLAY_DIM_MS
+#define DISPLAY_DIM_MS          30000
+#endif
+
+#ifndef DISPLAY_SLEEP_MS
+#define DISPLAY_SLEEP_MS        120000
+#endif
+
+/* 4-row panels show every reading at once instead of a separate DHT page;
+ * the history replaces the overview only while show_history is set.
+ */
+#define DISPLAY_HAS_OVERVIEW    (DISPLAY_ROWS >= 4)
+
 /* Display modes */
 typedef enum {
     DISPLAY_MODE_MENU,
@@ -21,16 +43,49 @@ typedef enum {
     DISPLAY_MODE_TIMER_SET_SCHEDULE
 } DisplayMode_t;
 
+/* Screen model: everything the screens show. The application publishes it
+ * whenever it likes; the display layer decides how and when to draw it.
+ * Clear unused fields so unchanged screens compare equal.
+ */
+typedef struct {
+    DisplayMode_t mode;
+    uint8_t moisture;               // %
+    bool pump_on;
+    int16_t temperature_x10;        // 0.1 degC
+    uint16_t humidity_x10;          // 0.1 %RH
+    RTC_Time_t time;                // Current time, or the time being edited
+    uint8_t menu_selection;         // TIMER_MENU: 0 = Set Time, 1 = Set Schedule
+    uint8_t cursor_pos;             // SET_TIME / SET_SCHEDULE field being edited
+    uint8_t schedule_hour;
+    uint8_t schedule_minute;
+    uint8_t schedule_duration;      // Minutes
+    uint32_t history_seq;           // MID_History_GetSeq(): redraws the sparkline
+    bool show_history;              // 4-row MANUAL/AUTO: sparkline instead of the overview
+} DisplayModel_t;
+
+/* Panel power state */
+typedef enum {
+    DISPLAY_POWER_ON,
+    DISPLAY_POWER_DIMMED,
+    DISPLAY_POWER_ASLEEP
+} DisplayPower_t;
+
+/* Scheduler statistics */
+typedef struct {
+    uint32_t published;             // Models that differed from the previous one
+    uint32_t renders;               // Frames actually drawn
+    uint32_t sleeps;                // Times the panel was switched off
+} DisplayStats_t;
+
 /* Middleware Function Prototypes */
 void MID_Display_Init(I2C_HandleTypeDef *hi2c);
-void MID_Display_ShowMenu(void);
-void MID_Display_ShowAuto(uint8_t moisture, bool pump_on);
-void MID_Display_ShowTime(const RTC_Time_t *time);
-void MID_Display_ShowTimerMenu(void);
-void MID_Display_ShowSetTime(const RTC_Time_t *time, uint8_t cursor_pos);
-void MID_Display_ShowSetSchedule(uint8_t hour, uint8_t minute, uint8_t duration, uint8_t cursor_pos);
+bool MID_Display_Publish(const DisplayModel_t *model);
+void MID_Display_Process(void);
+void MID_Display_Refresh(void);
 void MID_Display_Clear(void);
-void MID_Display_ShowDHT(float temperature, float humidity);
-void MID_Display_ShowManual(uint8_t moisture);
+void MID_Display_Sync(void);
+void MID_Display_Wake(void);
+DisplayPower_t MID_Display_GetPower(void);
+void MID_Display_GetStats(DisplayStats_t *stats);
 
 #endif /* MID_DISPLAY_H */
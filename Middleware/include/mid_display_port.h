@@ -0,0 +1,69 @@
+/**
+ * @file    mid_display_port.h
+ * @brief   Display backend selection for the display middleware
+ *
+ * The middleware draws text into a character grid; the backend turns it
+ * into HD44780 DDRAM writes or SSD1306 pixels. Both offer the same
+ * buffer/commit API, mapped here to DISP_* names.
+ * Select with -DDISPLAY_BACKEND=DISPLAY_BACKEND_SSD1306.
+ */
+
+#ifndef MID_DISPLAY_PORT_H
+#define MID_DISPLAY_PORT_H
+
+#define DISPLAY_BACKEND_HD44780     0
+#define DISPLAY_BACKEND_SSD1306     1
+
+#ifndef DISPLAY_BACKEND
+#define DISPLAY_BACKEND             DISPLAY_BACKEND_HD44780
+#endif
+
+#if DISPLAY_BACKEND == DISPLAY_BACKEND_HD44780
+#include "bsp_lcd.h"
+
+#define DISPLAY_ROWS                LCD_ROWS
+#define DISPLAY_COLS                LCD_COLS
+#define DISPLAY_GLYPH_SLOTS         LCD_CGRAM_SLOTS
+#define DISPLAY_GLYPH_ROWS          LCD_GLYPH_ROWS
+#define DISPLAY_GLYPH_CODE(slot)    LCD_GLYPH_CODE(slot)
+
+#define DISP_Init                   BSP_LCD_Init
+#define DISP_SetCursor              BSP_LCD_SetCursor
+#define DISP_Display                BSP_LCD_Display
+#define DISP_Dim(dim)               BSP_LCD_Backlight(!(dim))   // On/off only
+#define DISP_LoadGlyph              BSP_LCD_LoadGlyph
+#define DISP_Buffer_Clear           BSP_LCD_Buffer_Clear
+#define DISP_Buffer_Write           BSP_LCD_Buffer_Write
+#define DISP_Buffer_WriteLine       BSP_LCD_Buffer_WriteLine
+#define DISP_Commit                 BSP_LCD_Commit
+#define DISP_Sync                   BSP_LCD_Sync
+#define DISP_GetCommitSeq           BSP_LCD_GetCommitSeq
+#define DISP_GetCommitDone          BSP_LCD_GetCommitDone
+
+#elif DISPLAY_BACKEND == DISPLAY_BACKEND_SSD1306
+#include "bsp_ssd1306.h"
+
+#define DISPLAY_ROWS                SSD1306_TEXT_ROWS
+#define DISPLAY_COLS                SSD1306_TEXT_COLS
+#define DISPLAY_GLYPH_SLOTS         SSD1306_GLYPH_SLOTS
+#define DISPLAY_GLYPH_ROWS          SSD1306_GLYPH_ROWS
+#define DISPLAY_GLYPH_CODE(slot)    SSD1306_GLYPH_CODE(slot)
+
+#define DISP_Init                   BSP_SSD1306_Init
+#define DISP_SetCursor              BSP_SSD1306_SetCursor
+#define DISP_Display                BSP_SSD1306_Display
+#define DISP_Dim                    BSP_SSD1306_Dim
+#define DISP_LoadGlyph              BSP_SSD1306_LoadGlyph
+#define DISP_Buffer_Clear           BSP_SSD1306_Buffer_Clear
+#define DISP_Buffer_Write           BSP_SSD1306_Buffer_Write
+#define DISP_Buffer_WriteLine       BSP_SSD1306_Buffer_WriteLine
+#define DISP_Commit                 BSP_SSD1306_Commit
+#define DISP_Sync()                 ((void)0)   // Transfers are blocking
+#define DISP_GetCommitSeq           BSP_SSD1306_GetCommitSeq
+#define DISP_GetCommitDone          BSP_SSD1306_GetCommitDone
+
+#else
+#error "Unsupported DISPLAY_BACKEND"
+#endif
+
+#endif /* MID_DISPLAY_PORT_H */
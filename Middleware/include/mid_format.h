@@ -0,0 +1,27 @@
+/**
+ * @file    mid_format.h
+ * @brief   Middleware for integer and fixed-point text formatting
+ *
+ * Replaces snprintf() on the display paths. Every function appends to the
+ * text at p, never writes at or past end - 1, keeps the result NUL
+ * terminated and returns the new end of text, so calls can be chained:
+ *
+ *     char line[DISPLAY_COLS + 1];
+ *     char *p = MID_Format_Str(line, line + sizeof(line), "Temp: ");
+ *     p = MID_Format_Tenths(p, line + sizeof(line), temp_x10, 0);
+ */
+
+#ifndef MID_FORMAT_H
+#define MID_FORMAT_H
+
+#include <stdint.h>
+
+/* Middleware Function Prototypes */
+char *MID_Format_Str(char *p, char *end, const char *str);
+char *MID_Format_Char(char *p, char *end, char c);
+char *MID_Format_Uint(char *p, char *end, uint32_t value, uint8_t width, char pad);
+char *MID_Format_Tenths(char *p, char *end, int32_t tenths, uint8_t width);
+char *MID_Format_Percent(char *p, char *end, uint32_t value, uint8_t width);
+char *MID_Format_Clock(char *p, char *end, uint8_t hours, uint8_t minutes, uint8_t seconds);
+
+#endif /* MID_FORMAT_H */
@@ -0,0 +1,40 @@
+/**
+ * @file    mid_glyph.h
+ * @brief   Middleware for custom LCD characters (CGRAM glyph cache)
+ */
+
+#ifndef MID_GLYPH_H
+#define MID_GLYPH_H
+
+#include "mid_display_port.h"
+#include <stdint.h>
+
+/* Glyph identifiers */
+typedef enum {
+    GLYPH_DEGREE = 0,
+    GLYPH_DROPLET,
+    GLYPH_PUMP,
+    GLYPH_BAR_1,            // Vertical bar, 1/8 .. 8/8 filled from the bottom
+    GLYPH_BAR_2,
+    GLYPH_BAR_3,
+    GLYPH_BAR_4,
+    GLYPH_BAR_5,
+    GLYPH_BAR_6,
+    GLYPH_BAR_7,
+    GLYPH_BAR_8,
+    GLYPH_COUNT
+} Glyph_t;
+
+/* Cache statistics */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;        // Each miss uploads one glyph
+    uint32_t evictions;
+} GlyphStats_t;
+
+/* Middleware Function Prototypes */
+void MID_Glyph_Init(void);
+char MID_Glyph_Get(Glyph_t glyph);
+void MID_Glyph_GetStats(GlyphStats_t *stats);
+
+#endif /* MID_GLYPH_H */
@@ -0,0 +1,35 @@
+/**
+ * @file    mid_history.h
+ * @brief   Middleware for the moisture history ring buffer
+ */
+
+#ifndef MID_HISTORY_H
+#define MID_HISTORY_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Fixed time window: HISTORY_LENGTH samples of HISTORY_SAMPLE_MS each.
+ * Readings added within one sample period are averaged into one sample.
+ */
+#ifndef HISTORY_LENGTH
+#define HISTORY_LENGTH          16
+#endif
+
+#ifndef HISTORY_SAMPLE_MS
+#define HISTORY_SAMPLE_MS       60000   // 16 minutes in total
+#endif
+
+#define HISTORY_WINDOW_MS       ((uint32_t)HISTORY_LENGTH * HISTORY_SAMPLE_MS)
+#define HISTORY_EMPTY           0xFF    // Slot holds no reading
+
+/* Middleware Function Prototypes */
+void MID_History_Init(void);
+void MID_History_Add(uint8_t value);
+uint8_t MID_History_Get(uint8_t slot);
+uint8_t MID_History_GetNewest(void);
+uint32_t MID_History_GetSeq(void);
+uint32_t MID_History_GetPeriods(void);
+
+#endif /* MID_HISTORY_H */
@@ -0,0 +1,49 @@
+/**
+ * @file    mid_journal.h
+ * @brief   Middleware for the in-RAM event journal
+ *
+ * A fixed ring of JOURNAL_LENGTH binary records, each a millisecond tick,
+ * an event id and two arguments. Recording is a few stores with interrupts
+ * masked, so it is cheap enough to call from anywhere, including ISRs; once
+ * the ring is full the oldest record is overwritten. Records are numbered
+ * from boot, which lets a reader walk the ring while new events come in
+ * and tell how many it has lost. The shell "events" command dumps it.
+ */
+
+#ifndef MID_JOURNAL_H
+#define MID_JOURNAL_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef JOURNAL_LENGTH
+#define JOURNAL_LENGTH          64      // Records, must be a power of 2
+#endif
+
+/* Event ids and their arguments */
+typedef enum {
+    JOURNAL_BOOT = 0,                   // -, -
+    JOURNAL_STATE,                      // old SystemState_t, new SystemState_t
+    JOURNAL_PUMP,                       // 1 on / 0 off, moisture %
+    JOURNAL_WATERING,                   // 1 start / 0 end, duration (min)
+    JOURNAL_EVENT_COUNT
+} JournalEvent_t;
+
+/* One record (8 bytes) */
+typedef struct {
+    uint32_t tick;                      // HAL tick (ms)
+    uint8_t id;                         // JournalEvent_t
+    uint8_t a;
+    uint16_t b;
+} JournalRecord_t;
+
+/* Middleware Function Prototypes */
+void MID_Journal_Init(void);
+void MID_Journal_Record(JournalEvent_t id, uint8_t a, uint16_t b);
+uint32_t MID_Journal_GetSeq(void);
+uint32_t MID_Journal_GetOldest(void);
+bool MID_Journal_Read(uint32_t seq, JournalRecord_t *record);
+const char *MID_Journal_Name(uint8_t id);
+
+#endif /* MID_JOURNAL_H */
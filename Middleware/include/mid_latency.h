@@ -0,0 +1,39 @@
+/**
+ * @file    mid_latency.h
+ * @brief   Middleware for press-to-display latency statistics
+ *
+ * A sample runs from the first edge of a button press (its EXTI stamp, or
+ * the loop pass that saw it in polled builds) to the moment the first
+ * display commit after the press has left the I2C bus. The application
+ * calls MID_Latency_Start() for a press that changed the screen model,
+ * before MID_Display_Process() can render it; MID_Latency_Process() closes
+ * the samples whose commit is done. Each button keeps a count, min/avg/max
+ * and a histogram with power-of-2 millisecond buckets. The shell "latency"
+ * command prints them.
+ */
+
+#ifndef MID_LATENCY_H
+#define MID_LATENCY_H
+
+#include "mid_button.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LATENCY_BUCKETS         10      // < 1, 2, 4 ... 256 ms, then the rest
+
+/* Statistics of one button */
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint16_t histogram[LATENCY_BUCKETS];    // Bucket k < 2^k ms, the last >= 256 ms
+} LatencyStats_t;
+
+/* Middleware Function Prototypes */
+void MID_Latency_Init(void);
+void MID_Latency_Start(Button_t button, uint32_t cycles);
+void MID_Latency_Process(void);
+void MID_Latency_Get(Button_t button, LatencyStats_t *stats);
+
+#endif /* MID_LATENCY_H */
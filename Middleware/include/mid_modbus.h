@@ -0,0 +1,48 @@
+/**
+ * @file    mid_modbus.h
+ * @brief   Middleware for the Modbus RTU slave (function codes, register map)
+ *
+ * Functions 03 (read holding), 04 (read input), 06 (write single) and
+ * 16 (write multiple). Both register maps point at live variables and are
+ * read or written in place, so there is no copy to keep in sync:
+ *
+ *   holding register n   the n-th entry of the mid_param table (same range
+ *                        and rule checks as the UART shell)
+ *   input register n     the n-th entry of the table given to Init
+ *
+ * Broadcast (address 0) writes are carried out without a reply.
+ */
+
+#ifndef MID_MODBUS_H
+#define MID_MODBUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MODBUS_READ_MAX         125     // Registers per 03/04 request
+#define MODBUS_WRITE_MAX        123     // Registers per 16 request
+
+/* Exception codes */
+#define MODBUS_EX_FUNCTION      0x01    // Function code not supported
+#define MODBUS_EX_ADDRESS       0x02    // Register outside the map
+#define MODBUS_EX_VALUE         0x03    // Bad count, out of range or rejected
+
+/* One input register: a live variable, or a getter for state owned by
+ * another layer. Variables of 4 bytes (enums) give their low 16 bits,
+ * signed ones their two's complement.
+ */
+typedef struct {
+    const volatile void *value;         // NULL if read is used
+    uint8_t size;                       // sizeof(*value): 1, 2 or 4
+    uint16_t (*read)(void);
+} ModbusInput_t;
+
+#define MODBUS_INPUT(var)       {&(var), sizeof(var), NULL}
+#define MODBUS_INPUT_FN(fn)     {NULL, 0, (fn)}
+
+/* Middleware Function Prototypes */
+void MID_Modbus_Init(const ModbusInput_t *inputs, uint8_t count);
+void MID_Modbus_Process(void);
+uint32_t MID_Modbus_GetExceptions(void);
+
+#endif /* MID_MODBUS_H */
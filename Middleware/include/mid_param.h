@@ -0,0 +1,47 @@
+/**
+ * @file    mid_param.h
+ * @brief   Middleware for the runtime parameter table
+ *
+ * The application registers a table of named parameters, each pointing at
+ * the live variable it describes. Readers and writers (the UART shell)
+ * work on that variable in place, so there is no copy to keep in sync.
+ */
+
+#ifndef MID_PARAM_H
+#define MID_PARAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    PARAM_U8 = 0,
+    PARAM_U16
+} ParamType_t;
+
+typedef enum {
+    PARAM_OK = 0,
+    PARAM_RANGE,            // Outside min..max
+    PARAM_REJECTED          // Refused by the check function
+} ParamResult_t;
+
+/* One parameter; keep tables in flash (const) */
+typedef struct {
+    const char *name;
+    void *value;                        // Live variable, read and written in place
+    ParamType_t type;
+    uint16_t min;
+    uint16_t max;
+    bool (*check)(uint16_t value);      // Cross-parameter rule, NULL if none
+} Param_t;
+
+/* Middleware Function Prototypes */
+void MID_Param_Register(const Param_t *table, uint8_t count);
+uint8_t MID_Param_Count(void);
+const Param_t *MID_Param_At(uint8_t index);
+const Param_t *MID_Param_Find(const char *name);
+uint16_t MID_Param_Get(const Param_t *param);
+ParamResult_t MID_Param_Check(const Param_t *param, uint16_t value);
+void MID_Param_Store(const Param_t *param, uint16_t value);
+ParamResult_t MID_Param_Set(const Param_t *param, uint16_t value);
+
+#endif /* MID_PARAM_H */
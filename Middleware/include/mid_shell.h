@@ -0,0 +1,40 @@
+/**
+ * @file    mid_shell.h
+ * @brief   Middleware for the UART command shell
+ *
+ * Line commands on USART1 (115200 8N1, CR and/or LF ends a line):
+ *
+ *     list                 all parameters with value and range
+ *     get <name>           one parameter
+ *     set <name> <value>   change a parameter (range and rules checked)
+ *     events               event journal, oldest first: "<tick> <event> <a> <b>"
+ *                          lines, then "events=<sent> lost=<overwritten>"
+ *     latency [clear]      press-to-display latency per button with samples:
+ *                          "<button> n=<count> min=<us> avg=<us> max=<us> us"
+ *                          and "<button> hist <10 counts>" (< 1, 2, 4 ... 256 ms,
+ *                          more), then "latency=<samples>"; clear resets
+ *     help                 command summary
+ *
+ * Replies are single lines starting with the result or "ERR ...", except
+ * for the events dump and the latency report.
+ */
+
+#ifndef MID_SHELL_H
+#define MID_SHELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SHELL_LINE_MAX
+#define SHELL_LINE_MAX          48      // Characters per command line
+#endif
+
+#ifndef SHELL_POLL_BYTES
+#define SHELL_POLL_BYTES        32      // Bytes taken per MID_Shell_Process()
+#endif
+
+/* Middleware Function Prototypes */
+void MID_Shell_Init(void);
+void MID_Shell_Process(void);
+
+#endif /* MID_SHELL_H */
@@ -0,0 +1,76 @@
+/**
+ * @file    mid_telemetry.h
+ * @brief   Middleware for the binary telemetry stream on the debug UART
+ *
+ * Each snapshot is a packed little-endian packet with a CRC-16, COBS
+ * encoded and framed by 0x00 on both sides, so it can share USART1 with
+ * text: a decoder drops anything between delimiters that fails the CRC.
+ * Tools/telemetry decodes and records the stream.
+ *
+ * Packet (TELEMETRY_PACKET_SIZE bytes before COBS):
+ *   0  u8   TELEMETRY_TYPE_SNAPSHOT
+ *   1  u16  sequence number
+ *   3  u32  HAL tick (ms)
+ *   7  u8   SystemState_t
+ *   8  u16  moisture ADC raw
+ *  10  u8   moisture %
+ *  11  u8   pump on
+ *  12  i16  temperature (0.1 degC)
+ *  14  u16  humidity (0.1 %RH)
+ *  16  u8   hours, minutes, seconds (RTC)
+ *  19  u16  main loop passes since the previous snapshot
+ *  21  u16  longest loop pass (us)
+ *  23  u16  average loop pass (us)
+ *  25  u16  CRC-16/CCITT-FALSE of bytes 0-24
+ */
+
+#ifndef MID_TELEMETRY_H
+#define MID_TELEMETRY_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Snapshots per second at boot, 0 = off */
+#ifndef TELEMETRY_RATE_HZ
+#define TELEMETRY_RATE_HZ       0
+#endif
+
+#define TELEMETRY_MAX_RATE_HZ   50
+#define TELEMETRY_TYPE_SNAPSHOT 0x01
+#define TELEMETRY_PACKET_SIZE   27
+#define TELEMETRY_FRAME_MAX     (TELEMETRY_PACKET_SIZE + 3)   // COBS + 2 delimiters
+
+/* One snapshot of the application state */
+typedef struct {
+    uint8_t state;
+    uint16_t adc_raw;
+    uint8_t moisture;
+    bool pump_on;
+    int16_t temperature_x10;
+    uint16_t humidity_x10;
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+    uint16_t loop_count;
+    uint16_t loop_max_us;
+    uint16_t loop_avg_us;
+} Telemetry_t;
+
+/* Stream counters */
+typedef struct {
+    uint32_t sent;
+    uint32_t dropped;       // UART ring full, frame discarded whole
+} TelemetryStats_t;
+
+/* Middleware Function Prototypes */
+void MID_Telemetry_Init(void);
+bool MID_Telemetry_SetRate(uint8_t hz);
+uint8_t MID_Telemetry_GetRate(void);
+bool MID_Telemetry_Due(void);
+void MID_Telemetry_Send(const Telemetry_t *snapshot);
+uint8_t MID_Telemetry_Encode(const Telemetry_t *snapshot, uint16_t seq, uint32_t tick,
+                             uint8_t *frame);
+void MID_Telemetry_GetStats(TelemetryStats_t *stats);
+
+#endif /* MID_TELEMETRY_H */
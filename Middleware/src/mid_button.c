@@ -1,23 +1,172 @@
 /**
  * @file    mid_button.c
  * @brief   Middleware implementation for button handling
+ *
+ * Debouncing is done in bsp_button; this layer turns its edge masks into
+ * event records. With BUTTON_USE_EXTI an edge is dated from its first
+ * interrupt, not from the loop pass that noticed it, so hold timing and
+ * the order of events do not depend on how long the loop took. The
+ * events of one pass are sorted by time before they are queued; without
+ * stamps, a press and release seen in the same pass are put in the order
+ * the debounced state implies.
+ *
+ * Producer and consumer are both the main loop, so the queue needs no
+ * locking. A full queue drops new events.
  */
 
 #include "mid_button.h"
+#include "bsp_time.h"
 
-#define DEBOUNCE_TIME_MS    50
-#define HOLD_TIME_MS        1000
+#define BUTTON_EVENT_MASK       (BUTTON_EVENT_QUEUE - 1)
+#define BUTTON_PASS_MAX         (BUTTON_COUNT * 5)  // Release, press, double, hold, repeat
 
+_Static_assert((BUTTON_EVENT_QUEUE & BUTTON_EVENT_MASK) == 0 && BUTTON_EVENT_QUEUE <= 256,
+               "BUTTON_EVENT_QUEUE must be a power of 2, 256 at most");
+
+static ButtonEventRecord_t button_queue[BUTTON_EVENT_QUEUE];
+static uint8_t button_queue_head = 0;       // Free-running, Update
+static uint8_t button_queue_tail = 0;       // Free-running, GetEvent
+
+/* Per-button flags as masks, bit n = Button_t n (see bsp_button.h) */
+static uint16_t button_armed = 0;           // Down with PRESSED reported
+static uint16_t button_hold_flags = 0;      // Down, HOLD reported
+static uint16_t button_click_armed = 0;     // Short click, may become double
+static uint16_t button_second_click = 0;    // Down as the 2nd of a double
+static uint32_t button_press_time[BUTTON_COUNT];
+static uint32_t button_release_time[BUTTON_COUNT];
+static uint32_t button_repeat_due[BUTTON_COUNT];    // Next repeat, ms after the press
+#if BUTTON_USE_EXTI
+static uint32_t button_edge_cycles[2][BUTTON_COUNT];    // [1] press, [0] release
+static uint16_t button_edge_valid[2] = {0};
+#endif
+static bool button_activity = false;    // Any edge since the last query
+
+/* When an event happened */
 typedef struct {
-    bool current_state;
-    bool last_state;
-    bool pressed_flag;
-    bool released_flag;
-    bool hold_flag;
-    uint32_t press_time;
-} ButtonState_t;
+    uint32_t time;          // HAL tick
+    uint32_t cycles;        // BSP_Time_Cycles()
+} ButtonStamp_t;
+
+static const char * const button_names[BUTTON_COUNT] = {
+    [BUTTON_MANUAL] = "manual",
+    [BUTTON_AUTO]   = "auto",
+    [BUTTON_TIMER]  = "timer",
+    [BUTTON_RESET]  = "reset",
+    [BUTTON_INC]    = "inc",
+    [BUTTON_DEC]    = "dec",
+};
+
+/**
+ * @brief When button i went down (press) or up, from its EXTI stamp if any
+ */
+static ButtonStamp_t button_edge_stamp(uint8_t i, uint8_t press, const ButtonStamp_t *now)
+{
+    ButtonStamp_t stamp = *now;
+    
+#if BUTTON_USE_EXTI
+    if (button_edge_valid[press] & (1U << i)) {
+        stamp.cycles = button_edge_cycles[press][i];
+        stamp.time = now->time - BSP_Time_CyclesToUs(now->cycles - stamp.cycles) / 1000U;
+    }
+#else
+    (void)i;
+    (void)press;
+#endif
+    return stamp;
+}
+
+/**
+ * @brief Insert into the events of this pass, keeping them in time order
+ * @note  Stable: equal times stay in the order they were added
+ */
+static void button_add(ButtonEventRecord_t *list, uint8_t *count, const ButtonStamp_t *at,
+                       uint8_t button, ButtonEvent_t event, uint8_t step)
+{
+    uint8_t n = *count;
+    
+    while (n > 0 && (int32_t)(list[n - 1].time - at->time) > 0) {
+        list[n] = list[n - 1];
+        n--;
+    }
+    list[n].time = at->time;
+    list[n].cycles = at->cycles;
+    list[n].button = button;
+    list[n].event = (uint8_t)event;
+    list[n].step = step;
+    (*count)++;
+}
 
-static ButtonState_t button_states[BUTTON_COUNT] = {0};
+static void button_on_press(ButtonEventRecord_t *list, uint8_t *count, uint8_t i,
+                            const ButtonStamp_t *at)
+{
+    uint16_t bit = (uint16_t)(1U << i);
+    
+    button_press_time[i] = at->time;
+    button_armed |= bit;
+    button_hold_flags &= (uint16_t)~bit;
+    button_add(list, count, at, i, BUTTON_EVENT_PRESSED, 1);
+    
+    if ((button_click_armed & bit) && (at->time - button_release_time[i]) <= DOUBLE_CLICK_MS) {
+        button_add(list, count, at, i, BUTTON_EVENT_DOUBLE_CLICK, 1);
+        button_second_click |= bit;
+    } else {
+        button_second_click &= (uint16_t)~bit;
+    }
+    button_click_armed &= (uint16_t)~bit;
+}
+
+static void button_on_release(ButtonEventRecord_t *list, uint8_t *count, uint8_t i,
+                              const ButtonStamp_t *at)
+{
+    uint16_t bit = (uint16_t)(1U << i);
+    
+    button_add(list, count, at, i, BUTTON_EVENT_RELEASED, 1);
+    
+    // Only a short single click can start a double click
+    if ((button_hold_flags | button_second_click | (uint16_t)~button_armed) & bit) {
+        button_click_armed &= (uint16_t)~bit;
+    } else {
+        button_click_armed |= bit;
+        button_release_time[i] = at->time;
+    }
+    button_armed &= (uint16_t)~bit;
+    button_hold_flags &= (uint16_t)~bit;
+    button_second_click &= (uint16_t)~bit;
+}
+
+/**
+ * @brief Add one REPEAT for all repeats of button i due by now
+ */
+static void button_repeat(ButtonEventRecord_t *list, uint8_t *count, uint8_t i,
+                          const ButtonStamp_t *now)
+{
+    uint32_t held = now->time - button_press_time[i];
+    uint32_t due = button_repeat_due[i];
+    uint32_t last = due;
+    uint32_t step = 0;
+    
+    while (due <= held) {
+        last = due;
+        if (due < HOLD_TIME_MS + REPEAT_FAST_AFTER_MS) {
+            step += 1;
+            due += REPEAT_SLOW_MS;
+        } else if (due < HOLD_TIME_MS + REPEAT_TENS_AFTER_MS) {
+            step += 1;
+            due += REPEAT_FAST_MS;
+        } else {
+            step += 10;
+            due += REPEAT_SLOW_MS;
+        }
+    }
+    button_repeat_due[i] = due;
+    
+    if (step != 0) {
+        ButtonStamp_t at = {button_press_time[i] + last, now->cycles};
+        
+        button_add(list, count, &at, i, BUTTON_EVENT_REPEAT, (uint8_t)(step > 255 ? 255 : step));
+        button_activity = true;     // Keeps the display awake while held
+    }
+}
 
 /**
  * @brief Initialize button middleware
@@ -26,88 +175,147 @@ void MID_Button_Init(void)
 {
     BSP_Button_Init();
     
-    for (int i = 0; i < BUTTON_COUNT; i++) {
-        button_states[i].current_state = false;
-        button_states[i].last_state = false;
-        button_states[i].pressed_flag = false;
-        button_states[i].released_flag = false;
-        button_states[i].hold_flag = false;
-        button_states[i].press_time = 0;
-    }
+    button_queue_head = 0;
+    button_queue_tail = 0;
+    button_armed = 0;
+    button_hold_flags = 0;
+    button_click_armed = 0;
+    button_second_click = 0;
+    button_activity = false;
+#if BUTTON_USE_EXTI
+    button_edge_valid[0] = 0;
+    button_edge_valid[1] = 0;
+#endif
 }
 
 /**
- * @brief Update button states (call periodically)
+ * @brief Turn new edges, holds and repeats into queued events (call every pass)
+ * @note  Only buttons with an edge or down are visited; the rest is mask
+ *        arithmetic
  */
 void MID_Button_Update(void)
 {
-    uint32_t current_tick = HAL_GetTick();
+    ButtonStamp_t now = {HAL_GetTick(), BSP_Time_Cycles()};
+    ButtonEventRecord_t pass[BUTTON_PASS_MAX];
+    uint8_t count = 0;
+    ButtonScan_t scan;
     
-    // Update BSP debounce first
-    BSP_Button_Update();
+#if BUTTON_USE_EXTI
+    ButtonEdge_t edge;
     
-    for (int i = 0; i < BUTTON_COUNT; i++) {
-        // Read debounced state from BSP
-        bool reading = BSP_Button_Read_Debounced((Button_t)i);
-        
-        // Detect edge events
-        if (reading != button_states[i].last_state) {
-            if (reading) {
-                // Rising edge - button pressed
-                button_states[i].pressed_flag = true;
-                button_states[i].press_time = current_tick;
-                button_states[i].hold_flag = false;
+    // Edges first: a change accepted below may have its edge still queued
+    while (BSP_Button_GetEdge(&edge)) {
+        for (uint16_t m = edge.lines; m != 0; m &= (uint16_t)(m - 1U)) {
+            uint8_t i = (uint8_t)__builtin_ctz(m);
+            uint8_t press = (edge.levels >> i) & 1U;
+    
+            button_edge_cycles[press][i] = edge.cycles;
+            button_edge_valid[press] |= (uint16_t)(1U << i);
+        }
+    }
+#endif
+    BSP_Button_Update(&scan);
+    
+    if (scan.changed) {
+        button_activity = true;
+    }
+    
+    for (uint16_t m = scan.changed; m != 0; m &= (uint16_t)(m - 1U)) {
+        uint8_t i = (uint8_t)__builtin_ctz(m);
+        uint16_t bit = (uint16_t)(1U << i);
+        ButtonStamp_t down = button_edge_stamp(i, 1, &now);
+        ButtonStamp_t up = button_edge_stamp(i, 0, &now);
+    
+        if ((scan.pressed & bit) && (scan.released & bit)) {
+            // Both in one pass: down now means it was released first
+            if (scan.state & bit) {
+                button_on_release(pass, &count, i, &up);
+                button_on_press(pass, &count, i, &down);
             } else {
-                // Falling edge - button released
-                button_states[i].released_flag = true;
+                button_on_press(pass, &count, i, &down);
+                button_on_release(pass, &count, i, &up);
             }
-            button_states[i].last_state = reading;
+        } else if (scan.pressed & bit) {
+            button_on_press(pass, &count, i, &down);
+        } else {
+            button_on_release(pass, &count, i, &up);
         }
+    }
+#if BUTTON_USE_EXTI
+    button_edge_valid[1] &= (uint16_t)~scan.pressed;
+    button_edge_valid[0] &= (uint16_t)~scan.released;
+#endif
+    
+    // Hold, then auto-repeat while still held; a button already down at
+    // init never gave PRESSED, so it gets neither
+    for (uint16_t m = scan.state & button_armed; m != 0; m &= (uint16_t)(m - 1U)) {
+        uint8_t i = (uint8_t)__builtin_ctz(m);
+        uint16_t bit = (uint16_t)(1U << i);
         
-        // Check for hold event
-        if (reading && !button_states[i].hold_flag) {
-            if ((current_tick - button_states[i].press_time) >= HOLD_TIME_MS) {
-                button_states[i].hold_flag = true;
-            }
+        if ((now.time - button_press_time[i]) < HOLD_TIME_MS) {
+            continue;
+        }
+        if (!(button_hold_flags & bit)) {
+            ButtonStamp_t at = {button_press_time[i] + HOLD_TIME_MS, now.cycles};
+            
+            button_hold_flags |= bit;
+            button_repeat_due[i] = HOLD_TIME_MS;
+            button_add(pass, &count, &at, i, BUTTON_EVENT_HOLD, 1);
+        }
+        if (bit & BUTTON_REPEAT_MASK) {
+            button_repeat(pass, &count, i, &now);
         }
-        
-        button_states[i].current_state = reading;
+    }
+    
+    for (uint8_t n = 0; n < count; n++) {
+        if ((uint8_t)(button_queue_head - button_queue_tail) >= BUTTON_EVENT_QUEUE) {
+            break;
+        }
+        button_queue[button_queue_head & BUTTON_EVENT_MASK] = pass[n];
+        button_queue_head++;
     }
 }
 
 /**
- * @brief Check if button was pressed (clears flag)
+ * @brief Take the oldest button event
+ * @return false if none is waiting
  */
-bool MID_Button_IsPressed(Button_t button)
+bool MID_Button_GetEvent(ButtonEventRecord_t *event)
 {
-    if (button >= BUTTON_COUNT) return false;
-    
-    if (button_states[button].pressed_flag) {
-        button_states[button].pressed_flag = false;
-        return true;
+    if (button_queue_tail == button_queue_head) {
+        return false;
     }
-    return false;
+    *event = button_queue[button_queue_tail & BUTTON_EVENT_MASK];
+    button_queue_tail++;
+    return true;
 }
 
 /**
- * @brief Check if button was released (clears flag)
+ * @brief Check if button is down and has been for HOLD_TIME_MS
  */
-bool MID_Button_IsReleased(Button_t button)
+bool MID_Button_IsHeld(Button_t button)
 {
     if (button >= BUTTON_COUNT) return false;
-    
-    if (button_states[button].released_flag) {
-        button_states[button].released_flag = false;
+    return (button_hold_flags >> button) & 1U;
+}
+
+/**
+ * @brief Check if any button was pressed or released (clears flag)
+ * @note  Does not consume the queued events
+ */
+bool MID_Button_HadActivity(void)
+{
+    if (button_activity) {
+        button_activity = false;
         return true;
     }
     return false;
 }
 
 /**
- * @brief Check if button is held
+ * @brief Button name for logs and reports
  */
-bool MID_Button_IsHeld(Button_t button)
+const char *MID_Button_Name(Button_t button)
 {
-    if (button >= BUTTON_COUNT) return false;
-    return button_states[button].hold_flag;
+    return (button < BUTTON_COUNT) ? button_names[button] : "?";
 }
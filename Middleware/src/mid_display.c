@@ -3,170 +3,547 @@
  * @brief   Middleware implementation for display
  */
 
+#define LOG_MODULE  LOG_MODULE_MID
+
 #include "mid_display.h"
+#include "mid_glyph.h"
+#include "mid_format.h"
+#include "mid_history.h"
+#include "bsp_log.h"
 #include <stdio.h>
+#include <string.h>
+
+/* Layout check: a fixed text, or a worst-case sample of a formatted row
+ * ('#' marks a glyph), must fit one row of the configured panel.
+ */
+#define LAYOUT_CHECK(text) \
+    _Static_assert(sizeof(text) - 1 <= DISPLAY_COLS, "Row \"" text "\" exceeds DISPLAY_COLS")
+
+LAYOUT_CHECK("  CHOOSE MODE");
+LAYOUT_CHECK("MANL/AUTO/TIMER");
+LAYOUT_CHECK("#Moisture: 100%");
+LAYOUT_CHECK("Temp: -99.9#C");
+LAYOUT_CHECK("Humi: 100.0%");
+LAYOUT_CHECK("#100%   # OFF");
+LAYOUT_CHECK(">TIME SCHEDULE");
+LAYOUT_CHECK("Set Schedule:");
+LAYOUT_CHECK(" 23:59:59");
+LAYOUT_CHECK("23:59 D:99m");
+LAYOUT_CHECK("History     100%");
+#if DISPLAY_HAS_OVERVIEW
+LAYOUT_CHECK("MANUAL  23:59:59");
+#endif
+_Static_assert(HISTORY_LENGTH <= DISPLAY_COLS, "Sparkline exceeds DISPLAY_COLS");
+
+#if !DISPLAY_HAS_OVERVIEW
+/* MANUAL/AUTO pages, rotated every DISPLAY_PAGE_MS */
+typedef enum {
+    DISPLAY_PAGE_STATUS = 0,
+    DISPLAY_PAGE_DHT,
+    DISPLAY_PAGE_HISTORY,
+    DISPLAY_PAGE_COUNT
+} DisplayPage_t;
+#endif
+
+/* Scheduler state */
+static DisplayModel_t display_model;        // Latest published model
+static bool display_dirty = false;          // Model changed since the last render
+static uint32_t display_last_render = 0;
+static DisplayStats_t display_stats = {0};
+#if !DISPLAY_HAS_OVERVIEW
+static uint8_t display_page = DISPLAY_PAGE_STATUS;
+static uint32_t display_page_start = 0;
+#endif
+
+/* Idle manager */
+static DisplayPower_t display_power = DISPLAY_POWER_ON;
+static uint32_t display_activity = 0;       // Last wake event
+
+/* Sparkline on screen: only the newest column needs drawing */
+static bool display_history_drawn = false;
+static uint32_t display_history_periods = 0;
 
 /**
- * @brief Initialize display middleware
+ * @brief Blank the rows a screen does not use, then send the changes
  */
-void MID_Display_Init(I2C_HandleTypeDef *hi2c)
+static void display_commit(uint8_t rows_used)
 {
-    if (!BSP_LCD_Init(hi2c)) {
-        printf("WARNING: LCD initialization failed! Display disabled.\r\n");
+    for (uint8_t row = rows_used; row < DISPLAY_ROWS; row++) {
+        DISP_Buffer_WriteLine(row, "");
     }
+    DISP_Commit();
+}
+
+/**
+ * @brief Draw "<droplet> 42%   <pump> ON" on one row
+ */
+static void display_moisture_pump(uint8_t row, uint8_t moisture, bool pump_on)
+{
+    char buffer[DISPLAY_COLS + 1];
+    char *end = buffer + sizeof(buffer);
+    char *p = buffer;
+    
+    p = MID_Format_Char(p, end, MID_Glyph_Get(GLYPH_DROPLET));
+    p = MID_Format_Percent(p, end, moisture, 3);
+    p = MID_Format_Str(p, end, "   ");
+    p = MID_Format_Char(p, end, MID_Glyph_Get(GLYPH_PUMP));
+    MID_Format_Str(p, end, pump_on ? " ON" : " OFF");
+    DISP_Buffer_WriteLine(row, buffer);
+}
+
+/**
+ * @brief Draw temperature and humidity on two consecutive rows
+ */
+static void display_dht(uint8_t row, int16_t temperature_x10, uint16_t humidity_x10)
+{
+    char buffer[DISPLAY_COLS + 1];
+    char *end = buffer + sizeof(buffer);
+    char *p;
+    
+    p = MID_Format_Str(buffer, end, "Temp: ");
+    p = MID_Format_Tenths(p, end, temperature_x10, 0);
+    p = MID_Format_Char(p, end, MID_Glyph_Get(GLYPH_DEGREE));
+    MID_Format_Char(p, end, 'C');
+    DISP_Buffer_WriteLine(row, buffer);
+    
+    p = MID_Format_Str(buffer, end, "Humi: ");
+    p = MID_Format_Tenths(p, end, humidity_x10, 0);
+    MID_Format_Char(p, end, '%');
+    DISP_Buffer_WriteLine(row + 1, buffer);
+}
+
+/**
+ * @brief Draw the menu screen
+ */
+static void display_show_menu(void)
+{
+    DISP_Buffer_WriteLine(0, "  CHOOSE MODE");
+    DISP_Buffer_WriteLine(1, "MANL/AUTO/TIMER");
+    display_commit(2);
+}
+
+#if !DISPLAY_HAS_OVERVIEW
+/**
+ * @brief Draw the MANUAL mode screen
+ */
+static void display_show_manual(const DisplayModel_t *m)
+{
+    char buffer[DISPLAY_COLS + 1];
+    char *end = buffer + sizeof(buffer);
+    char *p;
+    
+    DISP_Buffer_WriteLine(0, "Mode: MANUAL");
+    
+    p = MID_Format_Char(buffer, end, MID_Glyph_Get(GLYPH_DROPLET));
+    p = MID_Format_Str(p, end, "Moisture: ");
+    MID_Format_Percent(p, end, m->moisture, 3);
+    DISP_Buffer_WriteLine(1, buffer);
+    display_commit(2);
 }
 
+/**
+ * @brief Draw the DHT sensor screen
+ */
+static void display_show_dht(const DisplayModel_t *m)
+{
+    display_dht(0, m->temperature_x10, m->humidity_x10);
+    display_commit(2);
+}
 
 /**
- * @brief Show menu screen
+ * @brief Draw the AUTO mode screen
  */
-void MID_Display_ShowMenu(void)
+static void display_show_auto(const DisplayModel_t *m)
 {
-    BSP_LCD_Clear();
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("  CHOOSE MODE   ");
-    BSP_LCD_SetCursor(1, 0);
-    BSP_LCD_Send_String("MANL/AUTO/TIMER");
+    DISP_Buffer_WriteLine(0, "Mode: AUTO");
+    display_moisture_pump(1, m->moisture, m->pump_on);
+    display_commit(2);
 }
 
+#else
 /**
- * @brief Show Manual mode
+ * @brief Draw mode, time, moisture, pump and DHT readings on one screen
  */
-void MID_Display_ShowManual(uint8_t moisture)
+static void display_show_overview(const DisplayModel_t *m)
 {
-    char buffer[17];
+    char buffer[DISPLAY_COLS + 1];
     
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("Mode: MANUAL    ");
+    // Mode label left, clock right-aligned in the last 8 columns
+    DISP_Buffer_WriteLine(0, (m->mode == DISPLAY_MODE_AUTO) ? "AUTO" : "MANUAL");
+    MID_Format_Clock(buffer, buffer + sizeof(buffer),
+                     m->time.hours, m->time.minutes, m->time.seconds);
+    DISP_Buffer_Write(0, DISPLAY_COLS - 8, buffer);
     
-    BSP_LCD_SetCursor(1, 0);
-    snprintf(buffer, sizeof(buffer), "Moisture: %3d%%", moisture);
-    buffer[16] = '\0';  // Ensure null termination
-    BSP_LCD_Send_String(buffer);
+    display_moisture_pump(1, m->moisture, m->pump_on);
+    display_dht(2, m->temperature_x10, m->humidity_x10);
+    display_commit(4);
 }
+#endif
 
 /**
-* @brief Show DHT sensor data
-*/
-void MID_Display_ShowDHT(float temperature, float humidity)
+ * @brief Bar for one history sample: 8 levels, blank when empty
+ */
+static char display_history_bar(uint8_t slot)
 {
-    char buffer[17];
-    BSP_LCD_SetCursor(0, 0);
-    snprintf(buffer, sizeof(buffer), "Temp: %.1fC     ", temperature);
-    buffer[16] = '\0';
-    BSP_LCD_Send_String(buffer);
+    uint8_t value = MID_History_Get(slot);
     
-    BSP_LCD_SetCursor(1, 0);
-    snprintf(buffer, sizeof(buffer), "Humi: %.1f%%    ", humidity);
-    buffer[16] = '\0';
-    BSP_LCD_Send_String(buffer);
+    if (value == HISTORY_EMPTY) {
+        return ' ';
+    }
+    if (value > 100) {
+        value = 100;
+    }
+    return MID_Glyph_Get((Glyph_t)(GLYPH_BAR_1 + (value * 8U) / 101U));
 }
 
 /**
- * @brief Show AUTO mode
+ * @brief Draw the moisture history as a sparkline
+ * @note  Slots map to fixed columns, so while the screen stays up only
+ *        the newest column (and the one before it, once a new sample
+ *        period starts) is drawn again. Up to 8 bar glyphs are visible,
+ *        all of them used since this screen was entered, so the glyph
+ *        cache never evicts one that is on screen.
  */
-void MID_Display_ShowAuto(uint8_t moisture, bool pump_on)
+static void display_show_history(const DisplayModel_t *m)
 {
-    char buffer[17];
+    char buffer[DISPLAY_COLS + 1];
+    uint32_t periods = MID_History_GetPeriods();
+    uint8_t newest = MID_History_GetNewest();
     
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("Mode: AUTO      ");
+    DISP_Buffer_WriteLine(0, "History");
+    MID_Format_Percent(buffer, buffer + sizeof(buffer), m->moisture, 3);
+    DISP_Buffer_Write(0, DISPLAY_COLS - 4, buffer);
+    
+    if (display_history_drawn && (periods - display_history_periods) <= 1) {
+        uint8_t previous = (uint8_t)((newest + HISTORY_LENGTH - 1) % HISTORY_LENGTH);
+        
+        buffer[1] = '\0';
+        if (periods != display_history_periods) {
+            buffer[0] = display_history_bar(previous);
+            DISP_Buffer_Write(1, previous, buffer);
+        }
+        buffer[0] = display_history_bar(newest);
+        DISP_Buffer_Write(1, newest, buffer);
+        DISP_Commit();
+    } else {
+        for (uint8_t slot = 0; slot < HISTORY_LENGTH; slot++) {
+            buffer[slot] = display_history_bar(slot);
+        }
+        buffer[HISTORY_LENGTH] = '\0';
+        DISP_Buffer_WriteLine(1, buffer);
+        display_commit(2);
+    }
     
-    BSP_LCD_SetCursor(1, 0);
-    snprintf(buffer, sizeof(buffer), "M:%3d%% P:%s", 
-             moisture, pump_on ? "ON " : "OFF");
-    buffer[16] = '\0';  // Ensure null termination
-    BSP_LCD_Send_String(buffer);
+    display_history_periods = periods;
 }
 
 /**
- * @brief Show current time
+ * @brief Draw the current time screen
  */
-void MID_Display_ShowTime(const RTC_Time_t *time)
+static void display_show_time(const DisplayModel_t *m)
 {
-    char buffer[17];
+    char buffer[DISPLAY_COLS + 1];
     
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("Mode: TIMER     ");
+    DISP_Buffer_WriteLine(0, "Mode: TIMER");
     
-    BSP_LCD_SetCursor(1, 0);
-    // Fixed buffer size to prevent truncation warning
-    snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d",
-             time->hours, time->minutes, time->seconds);
-    buffer[16] = '\0';  // Ensure null termination
-    BSP_LCD_Send_String(buffer);
+    MID_Format_Clock(buffer, buffer + sizeof(buffer),
+                     m->time.hours, m->time.minutes, m->time.seconds);
+    DISP_Buffer_WriteLine(1, buffer);
+    display_commit(2);
+}
+
+/**
+ * @brief Draw the timer menu (choose set time or schedule)
+ */
+static void display_show_timer_menu(const DisplayModel_t *m)
+{
+    DISP_Buffer_WriteLine(0, "TIMER: INC/DEC");
+    DISP_Buffer_WriteLine(1, (m->menu_selection == 0) ? ">TIME SCHEDULE"
+                                                         : " TIME>SCHEDULE");
+    display_commit(2);
 }
 
 /**
- * @brief Show time setting screen
+ * @brief Draw the time setting screen
  */
-void MID_Display_ShowSetTime(const RTC_Time_t *time, uint8_t cursor_pos)
+static void display_show_set_time(const DisplayModel_t *m)
 {
-    char buffer[17];
+    char buffer[DISPLAY_COLS + 1];
+    char *end = buffer + sizeof(buffer);
     
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("Set Time:       ");
+    DISP_Buffer_WriteLine(0, "Set Time:");
     
-    BSP_LCD_SetCursor(1, 0);
-    // Fixed buffer size and format to prevent truncation
-    snprintf(buffer, sizeof(buffer), " %02d:%02d:%02d",
-             time->hours, time->minutes, time->seconds);
-    buffer[16] = '\0';  // Ensure null termination
-    BSP_LCD_Send_String(buffer);
+    MID_Format_Clock(MID_Format_Char(buffer, end, ' '), end,
+                     m->time.hours, m->time.minutes, m->time.seconds);
+    DISP_Buffer_WriteLine(1, buffer);
+    display_commit(2);
     
-    // Use cursor_pos to suppress unused parameter warning
     // Show cursor indicator based on position
-    if (cursor_pos == 0) {
-        BSP_LCD_SetCursor(1, 1);  // Hour position
-    } else if (cursor_pos == 1) {
-        BSP_LCD_SetCursor(1, 4);  // Minute position
-    } else if (cursor_pos == 2) {
-        BSP_LCD_SetCursor(1, 7);  // Second position
+    if (m->cursor_pos == 0) {
+        DISP_SetCursor(1, 1);  // Hour position
+    } else if (m->cursor_pos == 1) {
+        DISP_SetCursor(1, 4);  // Minute position
+    } else if (m->cursor_pos == 2) {
+        DISP_SetCursor(1, 7);  // Second position
+    }
+}
+
+/**
+ * @brief Draw the schedule setting screen
+ */
+static void display_show_set_schedule(const DisplayModel_t *m)
+{
+    char buffer[DISPLAY_COLS + 1];
+    char *end = buffer + sizeof(buffer);
+    char *p;
+    
+    DISP_Buffer_WriteLine(0, "Set Schedule:");
+    
+    p = MID_Format_Uint(buffer, end, m->schedule_hour, 2, '0');
+    p = MID_Format_Char(p, end, ':');
+    p = MID_Format_Uint(p, end, m->schedule_minute, 2, '0');
+    p = MID_Format_Str(p, end, " D:");
+    p = MID_Format_Uint(p, end, m->schedule_duration, 2, '0');
+    MID_Format_Char(p, end, 'm');
+    DISP_Buffer_WriteLine(1, buffer);
+    display_commit(2);
+    
+    // Show cursor indicator
+    if (m->cursor_pos == 0) {
+        DISP_SetCursor(1, 0);  // Hour
+    } else if (m->cursor_pos == 1) {
+        DISP_SetCursor(1, 3);  // Minute
+    } else if (m->cursor_pos == 2) {
+        DISP_SetCursor(1, 8);  // Duration
+    }
+}
+
+/**
+ * @brief Draw the screen for a model
+ */
+static void display_render(const DisplayModel_t *m)
+{
+#if DISPLAY_HAS_OVERVIEW
+    bool history = m->show_history;  // The overview stays up until a button asks
+#else
+    bool history = display_page == DISPLAY_PAGE_HISTORY;
+#endif
+    
+    history = history && (m->mode == DISPLAY_MODE_MANUAL || m->mode == DISPLAY_MODE_AUTO);
+    
+    switch (m->mode) {
+        case DISPLAY_MODE_MENU:
+            display_show_menu();
+            break;
+#if DISPLAY_HAS_OVERVIEW
+        case DISPLAY_MODE_MANUAL:
+        case DISPLAY_MODE_AUTO:
+            if (history) {
+                display_show_history(m);
+            } else {
+                display_show_overview(m);
+            }
+            break;
+#else
+        case DISPLAY_MODE_MANUAL:
+        case DISPLAY_MODE_AUTO:
+            if (history) {
+                display_show_history(m);
+            } else if (display_page == DISPLAY_PAGE_DHT) {
+                display_show_dht(m);
+            } else if (m->mode == DISPLAY_MODE_AUTO) {
+                display_show_auto(m);
+            } else {
+                display_show_manual(m);
+            }
+            break;
+#endif
+        case DISPLAY_MODE_TIMER_DISPLAY:
+            display_show_time(m);
+            break;
+        case DISPLAY_MODE_TIMER_MENU:
+            display_show_timer_menu(m);
+            break;
+        case DISPLAY_MODE_TIMER_SET_TIME:
+            display_show_set_time(m);
+            break;
+        case DISPLAY_MODE_TIMER_SET_SCHEDULE:
+            display_show_set_schedule(m);
+            break;
+        default:
+            break;
+    }
+    
+    display_history_drawn = history;
+    display_dirty = false;
+    display_last_render = HAL_GetTick();
+    display_stats.renders++;
+}
+
+/**
+ * @brief Dim, then switch the panel off after DISPLAY_DIM_MS / DISPLAY_SLEEP_MS idle
+ */
+static void display_idle(uint32_t now)
+{
+    uint32_t idle = now - display_activity;
+    
+    if (display_power != DISPLAY_POWER_ASLEEP && DISPLAY_SLEEP_MS != 0 &&
+        idle >= DISPLAY_SLEEP_MS) {
+        DISP_Display(false);
+        if (display_power == DISPLAY_POWER_ON) {
+            DISP_Dim(true);
+        }
+        display_power = DISPLAY_POWER_ASLEEP;
+        display_stats.sleeps++;
+    } else if (display_power == DISPLAY_POWER_ON && DISPLAY_DIM_MS != 0 &&
+               idle >= DISPLAY_DIM_MS) {
+        DISP_Dim(true);
+        display_power = DISPLAY_POWER_DIMMED;
+    }
+}
+
+/**
+ * @brief Initialize display middleware
+ */
+void MID_Display_Init(I2C_HandleTypeDef *hi2c)
+{
+    if (!DISP_Init(hi2c)) {
+        LOG_WARN("WARNING: Display initialization failed! Display disabled.\r\n");
+    }
+    
+    MID_Glyph_Init();
+    
+    memset(&display_model, 0, sizeof(display_model));
+    display_model.mode = DISPLAY_MODE_MENU;
+    display_dirty = true;
+    display_last_render = HAL_GetTick();
+    display_power = DISPLAY_POWER_ON;
+    display_activity = HAL_GetTick();
+}
+
+/**
+ * @brief Publish the screen model to display
+ * @note  Cheap: only copies the model. Several publishes within one frame
+ *        are merged into a single render by MID_Display_Process().
+ * @return true if the model differs from the previous one
+ */
+bool MID_Display_Publish(const DisplayModel_t *model)
+{
+    if (memcmp(model, &display_model, sizeof(display_model)) == 0) {
+        return false;
+    }
+    
+#if !DISPLAY_HAS_OVERVIEW
+    if (model->mode != display_model.mode) {
+        display_page = DISPLAY_PAGE_STATUS;  // Entering a mode starts on its own screen
+        display_page_start = HAL_GetTick();
+    }
+#endif
+    
+    display_model = *model;
+    display_dirty = true;
+    display_stats.published++;
+    return true;
+}
+
+/**
+ * @brief Render the latest model if it changed, at most DISPLAY_MAX_FPS
+ * @note  Call from the main loop
+ */
+void MID_Display_Process(void)
+{
+    uint32_t now = HAL_GetTick();
+    
+    display_idle(now);
+    if (display_power == DISPLAY_POWER_ASLEEP) {
+        return;  // Nothing is drawn on a dark panel
+    }
+    
+    if ((now - display_last_render) < DISPLAY_FRAME_MS) {
+        return;
+    }
+    
+#if !DISPLAY_HAS_OVERVIEW
+    if ((display_model.mode == DISPLAY_MODE_MANUAL || display_model.mode == DISPLAY_MODE_AUTO) &&
+        (now - display_page_start) >= DISPLAY_PAGE_MS) {
+        display_page = (uint8_t)((display_page + 1) % DISPLAY_PAGE_COUNT);
+        display_page_start = now;
+        display_dirty = true;
+    }
+#endif
+    
+    if (display_dirty) {
+        display_render(&display_model);
+    }
+}
+
+/**
+ * @brief Render the latest model now if it changed, ignoring the rate limit
+ */
+void MID_Display_Refresh(void)
+{
+    if (display_dirty && display_power != DISPLAY_POWER_ASLEEP) {
+        display_render(&display_model);
     }
 }
 
 /**
  * @brief Clear display
+ * @note  Only the shadow is cleared; the current screen is drawn again
+ *        in full on the next frame.
  */
 void MID_Display_Clear(void)
 {
-    BSP_LCD_Clear();
+    DISP_Buffer_Clear();
+    display_history_drawn = false;
+    display_dirty = true;
 }
 
 /**
- * @brief Show timer menu (choose set time or schedule)
+ * @brief Wait until queued display traffic is on the bus
+ * @note  Call before using another device on the shared I2C bus
  */
-void MID_Display_ShowTimerMenu(void)
+void MID_Display_Sync(void)
 {
-    BSP_LCD_Clear();
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("TIMER: INC/DEC");
-    BSP_LCD_SetCursor(1, 0);
-    BSP_LCD_Send_String("TIME/SCHEDULE");
+    DISP_Sync();
 }
 
 /**
- * @brief Show schedule setting screen
+ * @brief Restart the idle timer and light the panel up again
+ * @note  Call on any button event or pump state change. A screen changed
+ *        while asleep is drawn right away.
  */
-void MID_Display_ShowSetSchedule(uint8_t hour, uint8_t minute, uint8_t duration, uint8_t cursor_pos)
+void MID_Display_Wake(void)
 {
-    char buffer[17];
+    display_activity = HAL_GetTick();
     
-    BSP_LCD_SetCursor(0, 0);
-    BSP_LCD_Send_String("Set Schedule:   ");
+    if (display_power == DISPLAY_POWER_ON) {
+        return;
+    }
     
-    BSP_LCD_SetCursor(1, 0);
-    snprintf(buffer, sizeof(buffer), "%02d:%02d D:%02dm",
-             hour, minute, duration);
-    buffer[16] = '\0';
-    BSP_LCD_Send_String(buffer);
+    if (display_power == DISPLAY_POWER_ASLEEP) {
+        DISP_Display(true);
+    }
+    DISP_Dim(false);
+    display_power = DISPLAY_POWER_ON;
     
-    // Show cursor indicator
-    if (cursor_pos == 0) {
-        BSP_LCD_SetCursor(1, 0);  // Hour
-    } else if (cursor_pos == 1) {
-        BSP_LCD_SetCursor(1, 3);  // Minute
-    } else if (cursor_pos == 2) {
-        BSP_LCD_SetCursor(1, 8);  // Duration
-    }
-}
\ No newline at end of file
+    if (display_dirty) {
+        display_render(&display_model);
+    }
+}
+
+/**
+ * @brief Current panel power state
+ */
+DisplayPower_t MID_Display_GetPower(void)
+{
+    return display_power;
+}
+
+/**
+ * @brief Read the refresh scheduler statistics
+ */
+void MID_Display_GetStats(DisplayStats_t *stats)
+{
+    *stats = display_stats;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file    mid_format.c
+ * @brief   Middleware implementation for text formatting
+ *
+ * Integer only: no float, no heap, no newlib printf. Digits are produced
+ * by repeated division by 10, which the Cortex-M3 does in hardware.
+ */
+
+#include "mid_format.h"
+
+#define FORMAT_MAX_DIGITS   10      // UINT32_MAX
+
+/**
+ * @brief Append a string
+ */
+char *MID_Format_Str(char *p, char *end, const char *str)
+{
+    while (*str && p < end - 1) {
+        *p++ = *str++;
+    }
+    if (p < end) {
+        *p = '\0';
+    }
+    return p;
+}
+
+/**
+ * @brief Append one character
+ */
+char *MID_Format_Char(char *p, char *end, char c)
+{
+    if (p < end - 1) {
+        *p++ = c;
+    }
+    if (p < end) {
+        *p = '\0';
+    }
+    return p;
+}
+
+/**
+ * @brief Append an unsigned integer, right-aligned
+ * @param width Minimum field width (0 = as many digits as needed)
+ * @param pad   Fill character for the field, e.g. '0' or ' '
+ */
+char *MID_Format_Uint(char *p, char *end, uint32_t value, uint8_t width, char pad)
+{
+    char digits[FORMAT_MAX_DIGITS];
+    uint8_t count = 0;
+    
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    
+    while (width > count) {
+        p = MID_Format_Char(p, end, pad);
+        width--;
+    }
+    while (count > 0) {
+        p = MID_Format_Char(p, end, digits[--count]);
+    }
+    return p;
+}
+
+/**
+ * @brief Append a fixed-point value with one decimal, e.g. 253 -> "25.3"
+ * @param tenths Value in units of 0.1
+ * @param width  Minimum field width including sign and point, space padded
+ */
+char *MID_Format_Tenths(char *p, char *end, int32_t tenths, uint8_t width)
+{
+    uint32_t magnitude = (tenths < 0) ? 0U - (uint32_t)tenths : (uint32_t)tenths;
+    uint32_t whole = magnitude / 10;
+    uint8_t length = 2;  // Point and decimal digit
+    
+    // Length of the integer part and sign, for the padding
+    for (uint32_t v = whole; ; v /= 10) {
+        length++;
+        if (v < 10) {
+            break;
+        }
+    }
+    if (tenths < 0) {
+        length++;
+    }
+    
+    while (width > length) {
+        p = MID_Format_Char(p, end, ' ');
+        width--;
+    }
+    if (tenths < 0) {
+        p = MID_Format_Char(p, end, '-');
+    }
+    p = MID_Format_Uint(p, end, whole, 0, ' ');
+    p = MID_Format_Char(p, end, '.');
+    return MID_Format_Char(p, end, (char)('0' + magnitude % 10));
+}
+
+/**
+ * @brief Append a percentage, e.g. 42 with width 3 -> " 42%"
+ * @param width Minimum width of the number, space padded
+ */
+char *MID_Format_Percent(char *p, char *end, uint32_t value, uint8_t width)
+{
+    p = MID_Format_Uint(p, end, value, width, ' ');
+    return MID_Format_Char(p, end, '%');
+}
+
+/**
+ * @brief Append a time of day as HH:MM:SS
+ */
+char *MID_Format_Clock(char *p, char *end, uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+    p = MID_Format_Uint(p, end, hours, 2, '0');
+    p = MID_Format_Char(p, end, ':');
+    p = MID_Format_Uint(p, end, minutes, 2, '0');
+    p = MID_Format_Char(p, end, ':');
+    return MID_Format_Uint(p, end, seconds, 2, '0');
+}
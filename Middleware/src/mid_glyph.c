@@ -0,0 +1,118 @@
+/**
+ * @file    mid_glyph.c
+ * @brief   Middleware implementation for the CGRAM glyph cache
+ *
+ * The HD44780 holds only 8 custom characters. Glyphs are mapped onto the
+ * slots on demand and the least recently used one is replaced when all
+ * slots are taken, so the LCD only sees CGRAM writes on a miss.
+ * A screen must not use more than DISPLAY_GLYPH_SLOTS distinct glyphs: a glyph
+ * evicted while still visible changes shape on the panel.
+ */
+
+#include "mid_glyph.h"
+
+#define GLYPH_NONE          0xFF
+
+typedef struct {
+    uint8_t glyph;          // Glyph_t held by the slot, or GLYPH_NONE
+    uint32_t last_use;      // Use stamp for LRU replacement
+} GlyphSlot_t;
+
+/* 5x8 patterns, one byte per row, bits 4..0 are the pixels */
+static const uint8_t glyph_patterns[GLYPH_COUNT][DISPLAY_GLYPH_ROWS] = {
+    [GLYPH_DEGREE]  = {0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00},
+    [GLYPH_DROPLET] = {0x04, 0x04, 0x0A, 0x0A, 0x11, 0x11, 0x11, 0x0E},
+    [GLYPH_PUMP]    = {0x0E, 0x04, 0x1F, 0x1F, 0x03, 0x00, 0x01, 0x01},
+    [GLYPH_BAR_1]   = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},
+    [GLYPH_BAR_2]   = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F},
+    [GLYPH_BAR_3]   = {0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F},
+    [GLYPH_BAR_4]   = {0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F},
+    [GLYPH_BAR_5]   = {0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F},
+    [GLYPH_BAR_6]   = {0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F},
+    [GLYPH_BAR_7]   = {0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F},
+    [GLYPH_BAR_8]   = {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F},
+};
+
+static GlyphSlot_t glyph_slots[DISPLAY_GLYPH_SLOTS];
+static uint8_t glyph_slot_of[GLYPH_COUNT];     // Reverse map, GLYPH_NONE if not loaded
+static uint32_t glyph_clock = 0;
+static GlyphStats_t glyph_stats = {0};
+
+/**
+ * @brief Initialize the glyph cache
+ * @note  Call after the display init: CGRAM content is undefined at power-up,
+ *        so every slot starts empty.
+ */
+void MID_Glyph_Init(void)
+{
+    for (uint8_t i = 0; i < DISPLAY_GLYPH_SLOTS; i++) {
+        glyph_slots[i].glyph = GLYPH_NONE;
+        glyph_slots[i].last_use = 0;
+    }
+    for (uint8_t i = 0; i < GLYPH_COUNT; i++) {
+        glyph_slot_of[i] = GLYPH_NONE;
+    }
+    
+    glyph_clock = 0;
+    glyph_stats.hits = 0;
+    glyph_stats.misses = 0;
+    glyph_stats.evictions = 0;
+}
+
+/**
+ * @brief Get the character code that displays a glyph, loading it if needed
+ * @param glyph Glyph identifier
+ * @return Character code (0x08-0x0F) to place in display strings,
+ *         or '?' for an invalid glyph
+ */
+char MID_Glyph_Get(Glyph_t glyph)
+{
+    uint8_t slot;
+    
+    if (glyph >= GLYPH_COUNT) {
+        return '?';
+    }
+    
+    glyph_clock++;
+    
+    slot = glyph_slot_of[glyph];
+    if (slot != GLYPH_NONE) {
+        glyph_stats.hits++;
+        glyph_slots[slot].last_use = glyph_clock;
+        return DISPLAY_GLYPH_CODE(slot);
+    }
+    
+    // Miss: take a free slot, otherwise the least recently used one
+    slot = 0;
+    for (uint8_t i = 0; i < DISPLAY_GLYPH_SLOTS; i++) {
+        if (glyph_slots[i].glyph == GLYPH_NONE) {
+            slot = i;
+            break;
+        }
+        if (glyph_slots[i].last_use < glyph_slots[slot].last_use) {
+            slot = i;
+        }
+    }
+    
+    if (glyph_slots[slot].glyph != GLYPH_NONE) {
+        glyph_slot_of[glyph_slots[slot].glyph] = GLYPH_NONE;
+        glyph_stats.evictions++;
+    }
+    
+    glyph_slots[slot].glyph = (uint8_t)glyph;
+    glyph_slots[slot].last_use = glyph_clock;
+    glyph_slot_of[glyph] = slot;
+    glyph_stats.misses++;
+    
+    DISP_LoadGlyph(slot, glyph_patterns[glyph]);
+    
+    return DISPLAY_GLYPH_CODE(slot);
+}
+
+/**
+ * @brief Read the cache statistics
+ */
+void MID_Glyph_GetStats(GlyphStats_t *stats)
+{
+    *stats = glyph_stats;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file    mid_history.c
+ * @brief   Middleware implementation for the moisture history ring buffer
+ *
+ * Each slot holds the average of the readings taken during one sample
+ * period, as one byte. The newest slot is the open period and is updated
+ * with every reading; when the period ends the next slot, holding the
+ * oldest sample, is reused. Slots stay in place, so a viewer only has to
+ * redraw the newest one.
+ */
+
+#include "mid_history.h"
+#include <string.h>
+
+static uint8_t history_samples[HISTORY_LENGTH];
+static uint8_t history_head = 0;            // Slot of the open period
+static uint32_t history_period_start = 0;
+static uint32_t history_sum = 0;            // Readings in the open period
+static uint16_t history_count = 0;
+static uint32_t history_periods = 0;        // Periods opened since init
+static uint32_t history_seq = 0;            // Readings added since init
+
+/**
+ * @brief Initialize the history (all slots empty)
+ */
+void MID_History_Init(void)
+{
+    memset(history_samples, HISTORY_EMPTY, sizeof(history_samples));
+    history_head = 0;
+    history_period_start = HAL_GetTick();
+    history_sum = 0;
+    history_count = 0;
+    history_periods = 0;
+    history_seq = 0;
+}
+
+/**
+ * @brief Add a reading
+ * @param value Reading, 0-254
+ * @note  Periods without readings are left empty, so the buffer always
+ *        covers the last HISTORY_WINDOW_MS.
+ */
+void MID_History_Add(uint8_t value)
+{
+    uint32_t elapsed = HAL_GetTick() - history_period_start;
+    
+    if (elapsed >= HISTORY_SAMPLE_MS) {
+        uint32_t periods = elapsed / HISTORY_SAMPLE_MS;
+        
+        history_period_start += periods * HISTORY_SAMPLE_MS;
+        history_periods += periods;
+        if (periods > HISTORY_LENGTH) {
+            periods = HISTORY_LENGTH;
+        }
+        while (periods-- > 0) {
+            history_head = (uint8_t)((history_head + 1) % HISTORY_LENGTH);
+            history_samples[history_head] = HISTORY_EMPTY;
+        }
+        history_sum = 0;
+        history_count = 0;
+    }
+    
+    if (value == HISTORY_EMPTY) {
+        value = HISTORY_EMPTY - 1;
+    }
+    
+    history_sum += value;
+    history_count++;
+    history_samples[history_head] = (uint8_t)(history_sum / history_count);
+    history_seq++;
+}
+
+/**
+ * @brief Read one slot
+ * @return Sample, or HISTORY_EMPTY
+ */
+uint8_t MID_History_Get(uint8_t slot)
+{
+    if (slot >= HISTORY_LENGTH) {
+        return HISTORY_EMPTY;
+    }
+    return history_samples[slot];
+}
+
+/**
+ * @brief Slot of the newest sample (the open period)
+ */
+uint8_t MID_History_GetNewest(void)
+{
+    return history_head;
+}
+
+/**
+ * @brief Number of readings added, changes with every MID_History_Add()
+ */
+uint32_t MID_History_GetSeq(void)
+{
+    return history_seq;
+}
+
+/**
+ * @brief Number of sample periods started since init
+ */
+uint32_t MID_History_GetPeriods(void)
+{
+    return history_periods;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file    mid_journal.c
+ * @brief   Middleware implementation for the in-RAM event journal
+ *
+ * journal_seq counts records since init; record n lives in slot
+ * n % JOURNAL_LENGTH until record n + JOURNAL_LENGTH replaces it. Writer
+ * and reader both hold interrupts off for the 8-byte copy only, so a
+ * record is never seen half written.
+ */
+
+#include "mid_journal.h"
+
+#define JOURNAL_MASK            (JOURNAL_LENGTH - 1)
+
+_Static_assert((JOURNAL_LENGTH & JOURNAL_MASK) == 0,
+               "JOURNAL_LENGTH must be a power of 2");
+
+static JournalRecord_t journal_ring[JOURNAL_LENGTH];
+static volatile uint32_t journal_seq = 0;   // Records written since init
+
+static const char * const journal_names[JOURNAL_EVENT_COUNT] = {
+    [JOURNAL_BOOT]      = "boot",
+    [JOURNAL_STATE]     = "state",
+    [JOURNAL_PUMP]      = "pump",
+    [JOURNAL_WATERING]  = "watering",
+};
+
+/**
+ * @brief Empty the journal
+ */
+void MID_Journal_Init(void)
+{
+    journal_seq = 0;
+}
+
+/**
+ * @brief Append a record, overwriting the oldest once full
+ * @note  O(1), safe from the main loop and interrupts
+ */
+void MID_Journal_Record(JournalEvent_t id, uint8_t a, uint16_t b)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    JournalRecord_t *record = &journal_ring[journal_seq & JOURNAL_MASK];
+    record->tick = HAL_GetTick();
+    record->id = (uint8_t)id;
+    record->a = a;
+    record->b = b;
+    journal_seq++;
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Sequence number the next record will get
+ */
+uint32_t MID_Journal_GetSeq(void)
+{
+    return journal_seq;
+}
+
+/**
+ * @brief Sequence number of the oldest record still held
+ */
+uint32_t MID_Journal_GetOldest(void)
+{
+    uint32_t seq = journal_seq;
+    
+    return (seq > JOURNAL_LENGTH) ? seq - JOURNAL_LENGTH : 0;
+}
+
+/**
+ * @brief Copy out record seq
+ * @return false if it was overwritten or is not written yet
+ */
+bool MID_Journal_Read(uint32_t seq, JournalRecord_t *record)
+{
+    bool valid;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    valid = (journal_seq - seq - 1U) < JOURNAL_LENGTH;
+    if (valid) {
+        *record = journal_ring[seq & JOURNAL_MASK];
+    }
+    
+    __set_PRIMASK(primask);
+    return valid;
+}
+
+/**
+ * @brief Short name of an event id, "?" if unknown
+ */
+const char *MID_Journal_Name(uint8_t id)
+{
+    if (id >= JOURNAL_EVENT_COUNT || journal_names[id] == NULL) {
+        return "?";
+    }
+    return journal_names[id];
+}
@@ -0,0 +1,115 @@
+/**
+ * @file    mid_latency.c
+ * @brief   Middleware implementation for press-to-display latency
+ *
+ * A started sample waits for display commit number latency_target, the
+ * first one after the press was published, and ends when the display
+ * backend reports that commit fully on the panel. The backend keeps the
+ * time each recent commit got there, so a sample is charged its own
+ * commit even if later ones finished before this pass looked. A new
+ * press of a button that is still waiting replaces the old sample.
+ */
+
+#include "mid_latency.h"
+#include "mid_display_port.h"
+#include "bsp_time.h"
+#include <string.h>
+
+/* Running totals of one button */
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint16_t histogram[LATENCY_BUCKETS];
+} LatencyTotals_t;
+
+static LatencyTotals_t latency_totals[BUTTON_COUNT];
+static uint16_t latency_pending = 0;                // Bit n = Button_t n waiting
+static uint32_t latency_start[BUTTON_COUNT];        // Press, BSP_Time_Cycles()
+static uint32_t latency_target[BUTTON_COUNT];       // Commit that shows it
+
+/**
+ * @brief Histogram bucket: 0 below 1 ms, k below 2^k ms
+ */
+static uint8_t latency_bucket(uint32_t us)
+{
+    uint32_t ms = us / 1000U;
+    uint8_t bucket = (ms == 0) ? 0 : (uint8_t)(32 - __builtin_clz(ms));
+    
+    return (bucket < LATENCY_BUCKETS) ? bucket : LATENCY_BUCKETS - 1;
+}
+
+/**
+ * @brief Clear all statistics and pending samples
+ */
+void MID_Latency_Init(void)
+{
+    memset(latency_totals, 0, sizeof(latency_totals));
+    latency_pending = 0;
+}
+
+/**
+ * @brief Start a sample: a press of button at cycles changed the screen
+ * @note  Call after publishing the new model, before MID_Display_Process()
+ */
+void MID_Latency_Start(Button_t button, uint32_t cycles)
+{
+    if (button >= BUTTON_COUNT) {
+        return;
+    }
+    latency_start[button] = cycles;
+    latency_target[button] = DISP_GetCommitSeq() + 1U;
+    latency_pending |= (uint16_t)(1U << button);
+}
+
+/**
+ * @brief Close the samples whose screen reached the panel (main loop)
+ */
+void MID_Latency_Process(void)
+{
+    for (uint16_t m = latency_pending; m != 0; m &= (uint16_t)(m - 1U)) {
+        uint8_t i = (uint8_t)__builtin_ctz(m);
+        LatencyTotals_t *totals = &latency_totals[i];
+        uint32_t done_cycles;
+        uint32_t us;
+        
+        if (!DISP_GetCommitDone(latency_target[i], &done_cycles)) {
+            continue;
+        }
+        latency_pending &= (uint16_t)~(1U << i);
+        
+        us = BSP_Time_CyclesToUs(done_cycles - latency_start[i]);
+        if (totals->count == 0 || us < totals->min_us) {
+            totals->min_us = us;
+        }
+        if (us > totals->max_us) {
+            totals->max_us = us;
+        }
+        totals->sum_us += us;
+        totals->count++;
+        
+        uint16_t *bin = &totals->histogram[latency_bucket(us)];
+        if (*bin < UINT16_MAX) {
+            (*bin)++;
+        }
+    }
+}
+
+/**
+ * @brief Statistics of one button, all zero if it has no samples
+ */
+void MID_Latency_Get(Button_t button, LatencyStats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (button >= BUTTON_COUNT || latency_totals[button].count == 0) {
+        return;
+    }
+    
+    const LatencyTotals_t *totals = &latency_totals[button];
+    stats->count = totals->count;
+    stats->min_us = totals->min_us;
+    stats->avg_us = (uint32_t)(totals->sum_us / totals->count);
+    stats->max_us = totals->max_us;
+    memcpy(stats->histogram, totals->histogram, sizeof(stats->histogram));
+}
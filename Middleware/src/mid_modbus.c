@@ -0,0 +1,218 @@
+/**
+ * @file    mid_modbus.c
+ * @brief   Middleware implementation for the Modbus RTU slave
+ *
+ * MID_Modbus_Process() handles at most one frame per call, in the frame
+ * buffer of bsp_modbus: request fields are decoded first, then the reply
+ * is written over them. The worst case is a 125-register read, so each
+ * call has a fixed upper bound whatever the master sends.
+ */
+
+#include "mid_modbus.h"
+#include "mid_param.h"
+#include "bsp_modbus.h"
+
+#define MODBUS_BROADCAST        0x00
+
+#define MODBUS_FC_READ_HOLDING  0x03
+#define MODBUS_FC_READ_INPUT    0x04
+#define MODBUS_FC_WRITE_SINGLE  0x06
+#define MODBUS_FC_WRITE_MULTI   0x10
+
+static const ModbusInput_t *modbus_inputs = NULL;
+static uint8_t modbus_input_count = 0;
+static uint32_t modbus_exceptions = 0;
+
+static uint16_t get_be16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void put_be16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)(value & 0xFF);
+}
+
+/**
+ * @brief Current value of an input register
+ */
+static uint16_t modbus_input_value(const ModbusInput_t *input)
+{
+    if (input->read != NULL) {
+        return input->read();
+    }
+    if (input->size == 1) {
+        return *(const volatile uint8_t *)input->value;
+    }
+    if (input->size == 2) {
+        return *(const volatile uint16_t *)input->value;
+    }
+    return (uint16_t)*(const volatile uint32_t *)input->value;
+}
+
+/**
+ * @brief Turn the frame into an exception reply
+ * @return Reply length
+ */
+static uint16_t modbus_exception(uint8_t *frame, uint8_t code)
+{
+    modbus_exceptions++;
+    frame[1] |= 0x80;
+    frame[2] = code;
+    return 3;
+}
+
+/**
+ * @brief Function 03/04: read count registers from start
+ */
+static uint16_t modbus_read(uint8_t *frame, uint16_t len)
+{
+    uint16_t start = get_be16(&frame[2]);
+    uint16_t count = get_be16(&frame[4]);
+    uint16_t size = (frame[1] == MODBUS_FC_READ_HOLDING) ? MID_Param_Count()
+                                                         : modbus_input_count;
+    uint8_t *out = &frame[3];
+
+    if (len != 6 || count == 0 || count > MODBUS_READ_MAX) {
+        return modbus_exception(frame, MODBUS_EX_VALUE);
+    }
+    if ((uint32_t)start + count > size) {
+        return modbus_exception(frame, MODBUS_EX_ADDRESS);
+    }
+
+    frame[2] = (uint8_t)(count * 2U);
+    for (uint16_t i = start; i < start + count; i++) {
+        uint16_t value = (frame[1] == MODBUS_FC_READ_HOLDING)
+                         ? MID_Param_Get(MID_Param_At((uint8_t)i))
+                         : modbus_input_value(&modbus_inputs[i]);
+        put_be16(out, value);
+        out += 2;
+    }
+    return (uint16_t)(3U + count * 2U);
+}
+
+/**
+ * @brief Function 06: write one holding register, reply is the request
+ */
+static uint16_t modbus_write_single(uint8_t *frame, uint16_t len)
+{
+    uint16_t address = get_be16(&frame[2]);
+
+    if (len != 6) {
+        return modbus_exception(frame, MODBUS_EX_VALUE);
+    }
+    if (address >= MID_Param_Count()) {
+        return modbus_exception(frame, MODBUS_EX_ADDRESS);
+    }
+    if (MID_Param_Set(MID_Param_At((uint8_t)address), get_be16(&frame[4])) != PARAM_OK) {
+        return modbus_exception(frame, MODBUS_EX_VALUE);
+    }
+    return 6;
+}
+
+/**
+ * @brief Function 16: write count holding registers from start
+ * @note  All or nothing. Values are range-checked, stored, and then the
+ *        rules are checked against the complete new set, so a pair like
+ *        auto_low/auto_high can be moved together in either direction.
+ *        The old values are kept in the request data for the rollback.
+ */
+static uint16_t modbus_write_multi(uint8_t *frame, uint16_t len)
+{
+    uint16_t start = get_be16(&frame[2]);
+    uint16_t count = get_be16(&frame[4]);
+    uint8_t *data = &frame[7];
+
+    if (len < 7 || count == 0 || count > MODBUS_WRITE_MAX ||
+        frame[6] != count * 2U || len != 7U + frame[6]) {
+        return modbus_exception(frame, MODBUS_EX_VALUE);
+    }
+    if ((uint32_t)start + count > MID_Param_Count()) {
+        return modbus_exception(frame, MODBUS_EX_ADDRESS);
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        const Param_t *param = MID_Param_At((uint8_t)(start + i));
+        uint16_t value = get_be16(&data[i * 2U]);
+
+        if (value < param->min || value > param->max) {
+            return modbus_exception(frame, MODBUS_EX_VALUE);
+        }
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        const Param_t *param = MID_Param_At((uint8_t)(start + i));
+        uint16_t value = get_be16(&data[i * 2U]);
+
+        put_be16(&data[i * 2U], MID_Param_Get(param));
+        MID_Param_Store(param, value);
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        const Param_t *param = MID_Param_At((uint8_t)(start + i));
+
+        if (MID_Param_Check(param, MID_Param_Get(param)) != PARAM_OK) {
+            for (uint16_t j = 0; j < count; j++) {
+                MID_Param_Store(MID_Param_At((uint8_t)(start + j)), get_be16(&data[j * 2U]));
+            }
+            return modbus_exception(frame, MODBUS_EX_VALUE);
+        }
+    }
+    return 6;
+}
+
+/**
+ * @brief Register the input register table
+ * @param inputs Entries, must stay valid (static const)
+ * @param count Number of entries
+ * @note  Holding registers are the mid_param table, registered separately
+ */
+void MID_Modbus_Init(const ModbusInput_t *inputs, uint8_t count)
+{
+    modbus_inputs = inputs;
+    modbus_input_count = count;
+    modbus_exceptions = 0;
+}
+
+/**
+ * @brief Answer the waiting request, if any (call every main loop pass)
+ */
+void MID_Modbus_Process(void)
+{
+    uint8_t *frame;
+    uint16_t len = BSP_Modbus_Receive(&frame);
+    uint16_t reply;
+
+    if (len == 0) {
+        return;
+    }
+
+    switch (frame[1]) {
+        case MODBUS_FC_READ_HOLDING:
+        case MODBUS_FC_READ_INPUT:
+            reply = modbus_read(frame, len);
+            break;
+        case MODBUS_FC_WRITE_SINGLE:
+            reply = modbus_write_single(frame, len);
+            break;
+        case MODBUS_FC_WRITE_MULTI:
+            reply = modbus_write_multi(frame, len);
+            break;
+        default:
+            reply = modbus_exception(frame, MODBUS_EX_FUNCTION);
+            break;
+    }
+
+    if (frame[0] == MODBUS_BROADCAST) {
+        BSP_Modbus_Release();
+    } else {
+        BSP_Modbus_Reply(reply);
+    }
+}
+
+/**
+ * @brief Exception replies sent (or suppressed for broadcasts) so far
+ */
+uint32_t MID_Modbus_GetExceptions(void)
+{
+    return modbus_exceptions;
+}
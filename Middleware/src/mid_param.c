@@ -0,0 +1,99 @@
+/**
+ * @file    mid_param.c
+ * @brief   Middleware implementation for the runtime parameter table
+ */
+
+#include "mid_param.h"
+#include <string.h>
+
+static const Param_t *param_table = NULL;
+static uint8_t param_count = 0;
+
+/**
+ * @brief Register the application's parameter table
+ * @param table Parameters, must stay valid (static const)
+ * @param count Number of entries
+ */
+void MID_Param_Register(const Param_t *table, uint8_t count)
+{
+    param_table = table;
+    param_count = count;
+}
+
+uint8_t MID_Param_Count(void)
+{
+    return param_count;
+}
+
+/**
+ * @brief Parameter by position, NULL past the end
+ */
+const Param_t *MID_Param_At(uint8_t index)
+{
+    return (index < param_count) ? &param_table[index] : NULL;
+}
+
+/**
+ * @brief Parameter by name, NULL if unknown
+ */
+const Param_t *MID_Param_Find(const char *name)
+{
+    for (uint8_t i = 0; i < param_count; i++) {
+        if (strcmp(param_table[i].name, name) == 0) {
+            return &param_table[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Current value of a parameter
+ */
+uint16_t MID_Param_Get(const Param_t *param)
+{
+    if (param->type == PARAM_U8) {
+        return *(const uint8_t *)param->value;
+    }
+    return *(const uint16_t *)param->value;
+}
+
+/**
+ * @brief Range and rule checks for a value, against the other live values
+ */
+ParamResult_t MID_Param_Check(const Param_t *param, uint16_t value)
+{
+    if (value < param->min || value > param->max) {
+        return PARAM_RANGE;
+    }
+    if (param->check != NULL && !param->check(value)) {
+        return PARAM_REJECTED;
+    }
+    return PARAM_OK;
+}
+
+/**
+ * @brief Write the live variable without checks
+ * @note  For group writes that check afterwards and restore on failure
+ */
+void MID_Param_Store(const Param_t *param, uint16_t value)
+{
+    if (param->type == PARAM_U8) {
+        *(uint8_t *)param->value = (uint8_t)value;
+    } else {
+        *(uint16_t *)param->value = value;
+    }
+}
+
+/**
+ * @brief Write a parameter after range and rule checks
+ * @return PARAM_OK if the live variable now holds value
+ */
+ParamResult_t MID_Param_Set(const Param_t *param, uint16_t value)
+{
+    ParamResult_t result = MID_Param_Check(param, value);
+    
+    if (result == PARAM_OK) {
+        MID_Param_Store(param, value);
+    }
+    return result;
+}
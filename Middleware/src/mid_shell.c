@@ -0,0 +1,353 @@
+/**
+ * @file    mid_shell.c
+ * @brief   Middleware implementation for the UART command shell
+ *
+ * The line is assembled incrementally from the RX ring. Each call looks at
+ * no more than SHELL_POLL_BYTES bytes and runs at most one command, so a
+ * flood of input costs the main loop a bounded slice per pass; what the
+ * loop cannot take piles up in the RX ring and is dropped there. Overlong
+ * lines are discarded up to the next line end. Replies are built with
+ * mid_format and queued whole on the TX ring, never waiting for it.
+ *
+ * The journal dump is too long for the TX ring, so "events" only marks
+ * the records to send; each later pass sends up to SHELL_DUMP_LINES of
+ * them while the ring has room for a full line, and input waits until the
+ * dump is over. The latency report is paced the same way, one button
+ * (two lines) at a time.
+ */
+
+#include "mid_shell.h"
+#include "mid_param.h"
+#include "mid_format.h"
+#include "mid_journal.h"
+#include "mid_latency.h"
+#include "bsp_uart.h"
+#include <string.h>
+
+#define SHELL_REPLY_MAX         64
+#define SHELL_DUMP_LINES        4       // Journal records per pass at most
+#define SHELL_LATENCY_IDLE      0xFF    // shell_latency_next: no report running
+
+static char shell_line[SHELL_LINE_MAX + 1];
+static uint8_t shell_len = 0;
+static bool shell_overflow = false;     // Current line is too long
+
+static bool shell_dumping = false;
+static uint32_t shell_dump_seq;         // Next journal record to send
+static uint32_t shell_dump_end;         // Journal sequence when asked
+static uint32_t shell_dump_sent;
+static uint32_t shell_dump_lost;        // Overwritten before they were sent
+
+static uint8_t shell_latency_next = SHELL_LATENCY_IDLE;    // Button to report next
+static uint32_t shell_latency_samples;
+
+/**
+ * @brief Queue one reply line (CRLF appended)
+ */
+static void shell_reply(const char *text)
+{
+    char line[SHELL_REPLY_MAX];
+    char *end = line + sizeof(line) - 2;
+    char *p = MID_Format_Str(line, end, text);
+    
+    *p++ = '\r';
+    *p++ = '\n';
+    BSP_UART_Write((const uint8_t *)line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Queue "name=value", with the range when asked
+ */
+static void shell_reply_param(const Param_t *param, bool with_range)
+{
+    char line[SHELL_REPLY_MAX];
+    char *end = line + sizeof(line);
+    char *p = MID_Format_Str(line, end, param->name);
+    
+    p = MID_Format_Char(p, end, '=');
+    p = MID_Format_Uint(p, end, MID_Param_Get(param), 0, ' ');
+    if (with_range) {
+        p = MID_Format_Str(p, end, " (");
+        p = MID_Format_Uint(p, end, param->min, 0, ' ');
+        p = MID_Format_Char(p, end, '-');
+        p = MID_Format_Uint(p, end, param->max, 0, ' ');
+        MID_Format_Char(p, end, ')');
+    }
+    shell_reply(line);
+}
+
+/**
+ * @brief Send the next few journal records, then the summary line
+ */
+static void shell_dump(void)
+{
+    JournalRecord_t record;
+    
+    for (uint8_t i = 0; i < SHELL_DUMP_LINES; i++) {
+        char line[SHELL_REPLY_MAX];
+        char *end = line + sizeof(line);
+        char *p;
+        
+        if (BSP_UART_TxSpace() < SHELL_REPLY_MAX) {
+            return;     // Let the DMA drain, carry on next pass
+        }
+        if (shell_dump_seq == shell_dump_end) {
+            p = MID_Format_Str(line, end, "events=");
+            p = MID_Format_Uint(p, end, shell_dump_sent, 0, ' ');
+            p = MID_Format_Str(p, end, " lost=");
+            MID_Format_Uint(p, end, shell_dump_lost, 0, ' ');
+            shell_reply(line);
+            shell_dumping = false;
+            return;
+        }
+        if (!MID_Journal_Read(shell_dump_seq, &record)) {
+            uint32_t oldest = MID_Journal_GetOldest();
+            uint32_t next = (oldest < shell_dump_end) ? oldest : shell_dump_end;
+            
+            shell_dump_lost += next - shell_dump_seq;
+            shell_dump_seq = next;
+            continue;
+        }
+        
+        p = MID_Format_Uint(line, end, record.tick, 0, ' ');
+        p = MID_Format_Char(p, end, ' ');
+        p = MID_Format_Str(p, end, MID_Journal_Name(record.id));
+        p = MID_Format_Char(p, end, ' ');
+        p = MID_Format_Uint(p, end, record.a, 0, ' ');
+        p = MID_Format_Char(p, end, ' ');
+        MID_Format_Uint(p, end, record.b, 0, ' ');
+        shell_reply(line);
+        shell_dump_seq++;
+        shell_dump_sent++;
+    }
+}
+
+/**
+ * @brief Send the latency statistics of the next buttons, then the total
+ * @note  Buttons without samples are skipped
+ */
+static void shell_dump_latency(void)
+{
+    LatencyStats_t stats;
+    
+    for (uint8_t i = 0; i < SHELL_DUMP_LINES; i += 2) {
+        char line[SHELL_REPLY_MAX];
+        char *end = line + sizeof(line);
+        const char *name;
+        char *p;
+        
+        if (BSP_UART_TxSpace() < 2 * SHELL_REPLY_MAX) {
+            return;     // Let the DMA drain, carry on next pass
+        }
+        if (shell_latency_next >= BUTTON_COUNT) {
+            p = MID_Format_Str(line, end, "latency=");
+            MID_Format_Uint(p, end, shell_latency_samples, 0, ' ');
+            shell_reply(line);
+            shell_latency_next = SHELL_LATENCY_IDLE;
+            return;
+        }
+        
+        name = MID_Button_Name((Button_t)shell_latency_next);
+        MID_Latency_Get((Button_t)shell_latency_next, &stats);
+        shell_latency_next++;
+        if (stats.count == 0) {
+            continue;
+        }
+        shell_latency_samples += stats.count;
+        
+        p = MID_Format_Str(line, end, name);
+        p = MID_Format_Str(p, end, " n=");
+        p = MID_Format_Uint(p, end, stats.count, 0, ' ');
+        p = MID_Format_Str(p, end, " min=");
+        p = MID_Format_Uint(p, end, stats.min_us, 0, ' ');
+        p = MID_Format_Str(p, end, " avg=");
+        p = MID_Format_Uint(p, end, stats.avg_us, 0, ' ');
+        p = MID_Format_Str(p, end, " max=");
+        p = MID_Format_Uint(p, end, stats.max_us, 0, ' ');
+        MID_Format_Str(p, end, " us");
+        shell_reply(line);
+        
+        p = MID_Format_Str(line, end, name);
+        p = MID_Format_Str(p, end, " hist");
+        for (uint8_t k = 0; k < LATENCY_BUCKETS; k++) {
+            p = MID_Format_Char(p, end, ' ');
+            p = MID_Format_Uint(p, end, stats.histogram[k], 0, ' ');
+        }
+        shell_reply(line);
+    }
+}
+
+/**
+ * @brief Parse a decimal number 0-65535
+ */
+static bool shell_parse_u16(const char *text, uint16_t *value)
+{
+    uint32_t result = 0;
+    
+    if (*text == '\0') {
+        return false;
+    }
+    while (*text) {
+        if (*text < '0' || *text > '9') {
+            return false;
+        }
+        result = result * 10U + (uint32_t)(*text++ - '0');
+        if (result > 0xFFFF) {
+            return false;
+        }
+    }
+    *value = (uint16_t)result;
+    return true;
+}
+
+/**
+ * @brief Split off the next space-separated word (modifies the line)
+ */
+static char *shell_word(char **cursor)
+{
+    char *word = *cursor;
+    
+    while (*word == ' ') {
+        word++;
+    }
+    *cursor = word;
+    while (**cursor != '\0' && **cursor != ' ') {
+        (*cursor)++;
+    }
+    if (**cursor == ' ') {
+        *(*cursor)++ = '\0';
+    }
+    return word;
+}
+
+/**
+ * @brief Run one complete command line
+ */
+static void shell_execute(char *line)
+{
+    char *cursor = line;
+    char *cmd = shell_word(&cursor);
+    char *name = shell_word(&cursor);
+    char *arg = shell_word(&cursor);
+    const Param_t *param;
+    uint16_t value;
+    
+    if (*cmd == '\0') {
+        return;
+    }
+    
+    if (strcmp(cmd, "list") == 0) {
+        for (uint8_t i = 0; i < MID_Param_Count(); i++) {
+            shell_reply_param(MID_Param_At(i), true);
+        }
+        return;
+    }
+    if (strcmp(cmd, "help") == 0) {
+        shell_reply("list | get <name> | set <name> <value> | events | latency [clear]");
+        return;
+    }
+    if (strcmp(cmd, "events") == 0) {
+        shell_dump_end = MID_Journal_GetSeq();
+        shell_dump_seq = MID_Journal_GetOldest();
+        shell_dump_sent = 0;
+        shell_dump_lost = shell_dump_seq;   // Overwritten before the command
+        shell_dumping = true;
+        return;
+    }
+    if (strcmp(cmd, "latency") == 0) {
+        if (strcmp(name, "clear") == 0) {
+            MID_Latency_Init();
+            shell_reply("latency=0");
+            return;
+        }
+        shell_latency_next = 0;
+        shell_latency_samples = 0;
+        return;
+    }
+    if (strcmp(cmd, "get") != 0 && strcmp(cmd, "set") != 0) {
+        shell_reply("ERR unknown command");
+        return;
+    }
+    
+    param = MID_Param_Find(name);
+    if (param == NULL) {
+        shell_reply("ERR unknown parameter");
+        return;
+    }
+    if (cmd[0] == 'g') {
+        shell_reply_param(param, false);
+        return;
+    }
+    
+    if (!shell_parse_u16(arg, &value)) {
+        shell_reply("ERR bad value");
+        return;
+    }
+    switch (MID_Param_Set(param, value)) {
+        case PARAM_OK:
+            shell_reply_param(param, false);
+            break;
+        case PARAM_RANGE:
+            shell_reply_param(param, true);     // Show the allowed range
+            shell_reply("ERR out of range");
+            break;
+        default:
+            shell_reply("ERR rejected");
+            break;
+    }
+}
+
+/**
+ * @brief Reset the line editor
+ */
+void MID_Shell_Init(void)
+{
+    shell_len = 0;
+    shell_overflow = false;
+    shell_dumping = false;
+    shell_latency_next = SHELL_LATENCY_IDLE;
+}
+
+/**
+ * @brief Consume pending input and run at most one command
+ * @note  Call from the main loop; never waits for RX or TX.
+ */
+void MID_Shell_Process(void)
+{
+    uint8_t c;
+    
+    if (shell_dumping) {
+        shell_dump();
+        return;
+    }
+    if (shell_latency_next != SHELL_LATENCY_IDLE) {
+        shell_dump_latency();
+        return;
+    }
+    
+    for (uint8_t i = 0; i < SHELL_POLL_BYTES && BSP_UART_Read(&c, 1) == 1; i++) {
+        if (c == '\r' || c == '\n') {
+            if (shell_overflow) {
+                shell_reply("ERR line too long");
+            } else if (shell_len > 0) {
+                shell_line[shell_len] = '\0';
+                shell_execute(shell_line);
+            }
+            shell_len = 0;
+            shell_overflow = false;
+            return;     // One command per pass, the rest waits in the ring
+        }
+        
+        if (c == '\b' || c == 0x7F) {
+            if (shell_len > 0) {
+                shell_len--;
+            }
+        } else if (c >= ' ' && c <= '~') {
+            if (shell_len < SHELL_LINE_MAX) {
+                shell_line[shell_len++] = (char)c;
+            } else {
+                shell_overflow = true;
+            }
+        }
+    }
+}
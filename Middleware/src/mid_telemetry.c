@@ -0,0 +1,190 @@
+/**
+ * @file    mid_telemetry.c
+ * @brief   Middleware implementation for the binary telemetry stream
+ *
+ * Packets are built byte by byte (no packed structs), so the layout in
+ * mid_telemetry.h does not depend on the compiler. A frame is at most
+ * TELEMETRY_FRAME_MAX bytes and goes to the UART ring in one write.
+ */
+
+#include "mid_telemetry.h"
+#include "bsp_uart.h"
+
+_Static_assert(TELEMETRY_RATE_HZ <= TELEMETRY_MAX_RATE_HZ, "TELEMETRY_RATE_HZ too high");
+_Static_assert(TELEMETRY_PACKET_SIZE < 254, "One COBS block per packet");
+
+static uint8_t telemetry_rate_hz = TELEMETRY_RATE_HZ;
+static uint32_t telemetry_next_ms = 0;
+static uint16_t telemetry_seq = 0;
+static TelemetryStats_t telemetry_stats = {0};
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ */
+static uint16_t telemetry_crc16(const uint8_t *data, uint8_t len)
+{
+    uint16_t crc = 0xFFFF;
+    
+    while (len--) {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    *p++ = (uint8_t)value;
+    *p++ = (uint8_t)(value >> 8);
+    return p;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    p = put_u16(p, (uint16_t)value);
+    return put_u16(p, (uint16_t)(value >> 16));
+}
+
+/**
+ * @brief COBS-encode len bytes (len < 254) without the trailing delimiter
+ * @return Encoded length (len + 1)
+ */
+static uint8_t telemetry_cobs(const uint8_t *in, uint8_t len, uint8_t *out)
+{
+    uint8_t code_pos = 0;
+    uint8_t code = 1;
+    uint8_t o = 1;
+    
+    for (uint8_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            code++;
+        }
+    }
+    out[code_pos] = code;
+    return o;
+}
+
+/**
+ * @brief Initialize the stream at TELEMETRY_RATE_HZ
+ */
+void MID_Telemetry_Init(void)
+{
+    telemetry_rate_hz = TELEMETRY_RATE_HZ;
+    telemetry_next_ms = HAL_GetTick();
+    telemetry_seq = 0;
+    telemetry_stats.sent = 0;
+    telemetry_stats.dropped = 0;
+}
+
+/**
+ * @brief Change the snapshot rate
+ * @param hz Snapshots per second, 0 stops the stream
+ * @return false if above TELEMETRY_MAX_RATE_HZ (rate unchanged)
+ */
+bool MID_Telemetry_SetRate(uint8_t hz)
+{
+    if (hz > TELEMETRY_MAX_RATE_HZ) {
+        return false;
+    }
+    telemetry_rate_hz = hz;
+    telemetry_next_ms = HAL_GetTick();
+    return true;
+}
+
+uint8_t MID_Telemetry_GetRate(void)
+{
+    return telemetry_rate_hz;
+}
+
+/**
+ * @brief Check whether a snapshot should be sent now
+ * @note  Keeps a fixed cadence; after a stall it restarts from now
+ *        instead of sending a burst.
+ */
+bool MID_Telemetry_Due(void)
+{
+    uint32_t now;
+    uint32_t period;
+    
+    if (telemetry_rate_hz == 0) {
+        return false;
+    }
+    
+    now = HAL_GetTick();
+    if ((int32_t)(now - telemetry_next_ms) < 0) {
+        return false;
+    }
+    
+    period = 1000U / telemetry_rate_hz;
+    telemetry_next_ms += period;
+    if ((int32_t)(now - telemetry_next_ms) >= 0) {
+        telemetry_next_ms = now + period;
+    }
+    return true;
+}
+
+/**
+ * @brief Build a complete frame: 0x00, COBS(packet + CRC), 0x00
+ * @param frame Output, TELEMETRY_FRAME_MAX bytes
+ * @return Frame length
+ */
+uint8_t MID_Telemetry_Encode(const Telemetry_t *snapshot, uint16_t seq, uint32_t tick,
+                             uint8_t *frame)
+{
+    uint8_t packet[TELEMETRY_PACKET_SIZE];
+    uint8_t *p = packet;
+    uint8_t len;
+    
+    *p++ = TELEMETRY_TYPE_SNAPSHOT;
+    p = put_u16(p, seq);
+    p = put_u32(p, tick);
+    *p++ = snapshot->state;
+    p = put_u16(p, snapshot->adc_raw);
+    *p++ = snapshot->moisture;
+    *p++ = snapshot->pump_on ? 1 : 0;
+    p = put_u16(p, (uint16_t)snapshot->temperature_x10);
+    p = put_u16(p, snapshot->humidity_x10);
+    *p++ = snapshot->hours;
+    *p++ = snapshot->minutes;
+    *p++ = snapshot->seconds;
+    p = put_u16(p, snapshot->loop_count);
+    p = put_u16(p, snapshot->loop_max_us);
+    p = put_u16(p, snapshot->loop_avg_us);
+    p = put_u16(p, telemetry_crc16(packet, (uint8_t)(p - packet)));
+    
+    frame[0] = 0x00;
+    len = telemetry_cobs(packet, (uint8_t)(p - packet), &frame[1]);
+    frame[len + 1] = 0x00;
+    return (uint8_t)(len + 2);
+}
+
+/**
+ * @brief Queue a snapshot on the debug UART
+ * @note  A frame that does not fit in the ring is dropped whole.
+ */
+void MID_Telemetry_Send(const Telemetry_t *snapshot)
+{
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    uint8_t len = MID_Telemetry_Encode(snapshot, telemetry_seq++, HAL_GetTick(), frame);
+    
+    if (BSP_UART_Write(frame, len) == len) {
+        telemetry_stats.sent++;
+    } else {
+        telemetry_stats.dropped++;
+    }
+}
+
+/**
+ * @brief Read the stream counters
+ */
+void MID_Telemetry_GetStats(TelemetryStats_t *stats)
+{
+    *stats = telemetry_stats;
+}
@@ -0,0 +1,424 @@
+/**
+ * @file    bench_lcd.c
+ * @brief   Display throughput benchmark on the emulated PCF8574 + HD44780
+ *
+ * Publishes a model for every screen through the real BSP/Middleware
+ * code and reports, per frame, the I2C traffic and the time the caller
+ * spent blocked. The final DDRAM contents are checked against the
+ * expected layout, and no byte may reach the controller while BF is set
+ * or with RW changed in the same expander write that raises EN.
+ * Custom characters must be uploaded once, on first use only, and a
+ * burst of publishes must be merged into at most DISPLAY_MAX_FPS frames.
+ * A new history sample must only redraw its own sparkline column, and
+ * an idle panel must go dark and see no traffic until woken. On 4-row
+ * panels the overview must stay up, without a byte sent, for a whole
+ * DISPLAY_PAGE_MS; the history is only shown when the model asks for it.
+ */
+
+#include "sim.h"
+#include "sim_hd44780.h"
+#include "mid_display.h"
+#include "mid_glyph.h"
+#include "mid_history.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    DisplayModel_t model;
+    uint32_t wait_ms;               // Let the scheduler run this long first
+    const char *rows[LCD_ROWS];
+} Screen_t;
+
+static SIM_HD44780_t lcd;
+static I2C_HandleTypeDef hi2c2;
+static int failures = 0;
+
+/* Droplet, degree and pump */
+#define BENCH_GLYPHS_USED   3
+
+static const RTC_Time_t bench_time = {56, 34, 12, 1, 1, 1, 25};
+
+/* SysTick as wired in stm32f1xx_it.c */
+void SysTick_Handler(void)
+{
+    BSP_LCD_Tick();
+}
+
+#define MODEL_STATUS(m) \
+    {.mode = (m), .moisture = 42, .pump_on = true, \
+     .temperature_x10 = 250, .humidity_x10 = 600, .time = bench_time}
+
+/* Expected rows without trailing spaces; missing rows must be blank */
+static const Screen_t screens[] = {
+    {"Menu",        {.mode = DISPLAY_MODE_MENU}, 0,
+                    {"  CHOOSE MODE", "MANL/AUTO/TIMER"}},
+#if DISPLAY_HAS_OVERVIEW
+    /* Glyph slots are taken in order of first use: droplet, pump, degree */
+    {"Manual",      MODEL_STATUS(DISPLAY_MODE_MANUAL), 0,
+                    {LCD_COLS == 20 ? "MANUAL      12:34:56" : "MANUAL  12:34:56",
+                     "\x08 42%   \x09 ON", "Temp: 25.0\x0A" "C", "Humi: 60.0%"}},
+    {"Auto",        MODEL_STATUS(DISPLAY_MODE_AUTO), 0,
+                    {LCD_COLS == 20 ? "AUTO        12:34:56" : "AUTO    12:34:56",
+                     "\x08 42%   \x09 ON", "Temp: 25.0\x0A" "C", "Humi: 60.0%"}},
+#else
+    {"Manual",      MODEL_STATUS(DISPLAY_MODE_MANUAL), 0,
+                    {"Mode: MANUAL", "\x08Moisture:  42%"}},
+    {"DHT",         MODEL_STATUS(DISPLAY_MODE_MANUAL), DISPLAY_PAGE_MS,
+                    {"Temp: 25.0\x09" "C", "Humi: 60.0%"}},
+    {"Auto",        MODEL_STATUS(DISPLAY_MODE_AUTO), 0,
+                    {"Mode: AUTO", "\x08 42%   \x0A ON"}},
+#endif
+    {"Time",        {.mode = DISPLAY_MODE_TIMER_DISPLAY, .time = bench_time}, 0,
+                    {"Mode: TIMER", "12:34:56"}},
+    {"TimerMenu",   {.mode = DISPLAY_MODE_TIMER_MENU, .menu_selection = 1}, 0,
+                    {"TIMER: INC/DEC", " TIME>SCHEDULE"}},
+    {"SetTime",     {.mode = DISPLAY_MODE_TIMER_SET_TIME, .time = bench_time,
+                     .cursor_pos = 1}, 0,
+                    {"Set Time:", " 12:34:56"}},
+    {"SetSchedule", {.mode = DISPLAY_MODE_TIMER_SET_SCHEDULE, .schedule_hour = 8,
+                     .schedule_minute = 0, .schedule_duration = 10,
+                     .cursor_pos = 2}, 0,
+                    {"Set Schedule:", "08:00 D:10m"}},
+};
+
+/**
+ * @brief Run one frame and print its cost
+ */
+static void bench_frame(const Screen_t *screen, bool repeat)
+{
+    SIM_I2C_Stats_t stats;
+    uint64_t start;
+    uint64_t call_us;
+    
+    if (screen->wait_ms != 0 && !repeat) {
+        SIM_Advance_Us((uint64_t)screen->wait_ms * 1000);
+    }
+    
+    SIM_I2C_ResetStats();
+    start = SIM_Now_Us();
+    MID_Display_Publish(&screen->model);
+    if (screen->wait_ms != 0) {
+        MID_Display_Process();
+    } else {
+        MID_Display_Refresh();
+    }
+    call_us = SIM_Now_Us() - start;
+    BSP_LCD_Sync();
+    SIM_I2C_GetStats(&stats);
+    
+    printf("%-12s %-7s %6u %7u %10llu %10llu\n", screen->name,
+           repeat ? "repeat" : "enter",
+           (unsigned)stats.transactions, (unsigned)stats.bytes,
+           (unsigned long long)stats.bus_time_us, (unsigned long long)call_us);
+}
+
+/**
+ * @brief Compare emulated DDRAM with the expected screen
+ */
+static void check_rows(const Screen_t *screen)
+{
+    char row[SIM_HD44780_DDRAM_SIZE];
+    char expected[LCD_COLS + 1];
+    
+    for (uint8_t r = 0; r < LCD_ROWS; r++) {
+        snprintf(expected, sizeof(expected), "%-*s", LCD_COLS,
+                 screen->rows[r] ? screen->rows[r] : "");
+        SIM_HD44780_GetRow(&lcd, r, row);
+        if (strcmp(row, expected) != 0) {
+            printf("FAIL %s row %u: got \"%s\", expected \"%s\"\n",
+                   screen->name, r, row, expected);
+            failures++;
+        }
+    }
+}
+
+/**
+ * @brief Publish a changing model every millisecond for one second
+ */
+static void bench_rate(void)
+{
+    DisplayModel_t model = {.mode = DISPLAY_MODE_TIMER_DISPLAY, .time = bench_time};
+    const Screen_t last = {"Rate", {0}, 0, {"Mode: TIMER", "12:34:39"}};
+    DisplayStats_t before, after;
+    SIM_I2C_Stats_t bus;
+    uint32_t renders;
+    
+    MID_Display_GetStats(&before);
+    SIM_I2C_ResetStats();
+    
+    for (uint32_t ms = 0; ms < 1000; ms++) {
+        model.time.seconds = ms % 60;
+        MID_Display_Publish(&model);
+        MID_Display_Process();
+        SIM_Advance_Us(1000);
+    }
+    SIM_Advance_Us(DISPLAY_FRAME_MS * 1000);  // The last update lands next frame
+    MID_Display_Process();
+    BSP_LCD_Sync();
+    
+    MID_Display_GetStats(&after);
+    SIM_I2C_GetStats(&bus);
+    renders = after.renders - before.renders;
+    printf("rate: %lu publishes in 1 s -> %lu renders, %u bytes\n",
+           (unsigned long)(after.published - before.published),
+           (unsigned long)renders, (unsigned)bus.bytes);
+    
+    if (renders > DISPLAY_MAX_FPS + 1) {
+        printf("FAIL more than %d renders per second\n", DISPLAY_MAX_FPS);
+        failures++;
+    }
+    check_rows(&last);
+}
+
+/**
+ * @brief Fill level (rows lit from the bottom) of the custom character at a cell
+ */
+static uint8_t bar_level(uint8_t row, uint8_t col)
+{
+    char text[SIM_HD44780_DDRAM_SIZE];
+    uint8_t code;
+    uint8_t level = 0;
+    
+    SIM_HD44780_GetRow(&lcd, row, text);
+    code = (uint8_t)text[col];
+    if (code < 0x08 || code > 0x0F) {
+        return 0;
+    }
+    for (uint8_t y = 0; y < LCD_GLYPH_ROWS; y++) {
+        if (lcd.cgram[(code & 0x07) * LCD_GLYPH_ROWS + y] == 0x1F) {
+            level++;
+        }
+    }
+    return level;
+}
+
+/**
+ * @brief Check the sparkline bars against the history contents
+ */
+static void check_sparkline(const char *name)
+{
+    for (uint8_t slot = 0; slot < HISTORY_LENGTH; slot++) {
+        uint8_t value = MID_History_Get(slot);
+        uint8_t expected = (value == HISTORY_EMPTY) ? 0 : (uint8_t)(1 + (value * 8U) / 101U);
+        uint8_t got = bar_level(1, slot);
+        
+        if (got != expected) {
+            printf("FAIL %s column %u: bar %u, expected %u\n", name, slot, got, expected);
+            failures++;
+        }
+    }
+}
+
+/**
+ * @brief Fill the history, show its page, then add one sample
+ */
+static void bench_history(void)
+{
+    DisplayModel_t model = MODEL_STATUS(DISPLAY_MODE_AUTO);
+    char row[SIM_HD44780_DDRAM_SIZE];
+    SIM_I2C_Stats_t bus;
+    uint32_t data_writes;
+    
+    MID_History_Init();
+    for (uint8_t i = 0; i < HISTORY_LENGTH; i++) {
+        MID_History_Add((uint8_t)((i % 8) * 13));   // Every bar level once per 8
+        SIM_Advance_Us((uint64_t)HISTORY_SAMPLE_MS * 1000);
+    }
+    MID_History_Add(39);                            // Replaces the oldest sample
+    
+    model.history_seq = MID_History_GetSeq();
+    model.show_history = DISPLAY_HAS_OVERVIEW;      // 2-row panels rotate to it
+    MID_Display_Publish(&model);
+    MID_Display_Wake();                             // Idle for 16 minutes
+    for (uint8_t i = 0; i < 4; i++) {
+        SIM_Advance_Us((uint64_t)DISPLAY_PAGE_MS * 1000);
+        MID_Display_Process();
+        BSP_LCD_Sync();
+        SIM_HD44780_GetRow(&lcd, 0, row);
+        if (strncmp(row, "History", 7) == 0) {
+            break;
+        }
+    }
+    check_sparkline("History");
+    
+    SIM_Advance_Us((uint64_t)HISTORY_SAMPLE_MS * 1000);
+    MID_History_Add(100);
+    model.history_seq = MID_History_GetSeq();
+    
+    SIM_I2C_ResetStats();
+    data_writes = lcd.data_writes;
+    MID_Display_Publish(&model);
+    MID_Display_Refresh();
+    BSP_LCD_Sync();
+    SIM_I2C_GetStats(&bus);
+    
+    printf("history sample: %u xfers, %u bytes, %u cells written\n",
+           (unsigned)bus.transactions, (unsigned)bus.bytes,
+           (unsigned)(lcd.data_writes - data_writes));
+    check_sparkline("History sample");
+    if (lcd.data_writes - data_writes != 1) {
+        printf("FAIL new sample wrote %u cells, expected only its column\n",
+               (unsigned)(lcd.data_writes - data_writes));
+        failures++;
+    }
+}
+
+#if DISPLAY_HAS_OVERVIEW
+/**
+ * @brief An unchanged overview must not be redrawn by the page timer
+ */
+static void bench_overview_idle(void)
+{
+    DisplayModel_t model = MODEL_STATUS(DISPLAY_MODE_MANUAL);
+    SIM_I2C_Stats_t bus;
+    
+    MID_Display_Wake();
+    MID_Display_Publish(&model);
+    MID_Display_Refresh();
+    BSP_LCD_Sync();
+    
+    SIM_I2C_ResetStats();
+    for (uint32_t t = 0; t <= DISPLAY_PAGE_MS; t += DISPLAY_FRAME_MS) {
+        MID_Display_Publish(&model);
+        MID_Display_Process();
+        SIM_Advance_Us((uint64_t)DISPLAY_FRAME_MS * 1000);
+    }
+    BSP_LCD_Sync();
+    SIM_I2C_GetStats(&bus);
+    
+    printf("overview idle: %u bytes in %d ms\n", (unsigned)bus.bytes, DISPLAY_PAGE_MS);
+    if (bus.bytes != 0) {
+        printf("FAIL idle overview redrawn\n");
+        failures++;
+    }
+}
+#endif
+
+/**
+ * @brief Let the display go idle, publish while asleep, then wake it
+ */
+static void bench_idle(void)
+{
+    DisplayModel_t model = {.mode = DISPLAY_MODE_TIMER_DISPLAY, .time = bench_time};
+    const Screen_t woken = {"Wake", {0}, 0, {"Mode: TIMER", "12:34:59"}};
+    SIM_I2C_Stats_t bus;
+    
+    MID_Display_Wake();
+    MID_Display_Publish(&model);
+    MID_Display_Refresh();
+    
+    SIM_Advance_Us((uint64_t)DISPLAY_DIM_MS * 1000);
+    MID_Display_Process();
+    BSP_LCD_Sync();
+    if (MID_Display_GetPower() != DISPLAY_POWER_DIMMED || SIM_HD44780_Backlight(&lcd) ||
+        !lcd.display_on) {
+        printf("FAIL backlight still on after %d ms idle\n", DISPLAY_DIM_MS);
+        failures++;
+    }
+    
+    SIM_Advance_Us((uint64_t)(DISPLAY_SLEEP_MS - DISPLAY_DIM_MS) * 1000);
+    MID_Display_Process();
+    BSP_LCD_Sync();
+    if (MID_Display_GetPower() != DISPLAY_POWER_ASLEEP || lcd.display_on) {
+        printf("FAIL panel still on after %d ms idle\n", DISPLAY_SLEEP_MS);
+        failures++;
+    }
+    
+    // One minute of clock updates on a dark panel
+    SIM_I2C_ResetStats();
+    for (uint32_t s = 0; s < 60; s++) {
+        model.time.seconds = (uint8_t)s;
+        MID_Display_Publish(&model);
+        MID_Display_Process();
+        MID_Display_Refresh();
+        SIM_Advance_Us(1000000);
+    }
+    BSP_LCD_Sync();
+    SIM_I2C_GetStats(&bus);
+    printf("asleep: %u bytes in 60 s of updates\n", (unsigned)bus.bytes);
+    if (bus.bytes != 0) {
+        printf("FAIL I2C traffic while the panel is off\n");
+        failures++;
+    }
+    
+    MID_Display_Wake();
+    BSP_LCD_Sync();
+    if (MID_Display_GetPower() != DISPLAY_POWER_ON || !SIM_HD44780_Backlight(&lcd) ||
+        !lcd.display_on) {
+        printf("FAIL panel not lit after wake\n");
+        failures++;
+    }
+    check_rows(&woken);
+}
+
+static void bench_run(bool rw_wired)
+{
+    GlyphStats_t glyphs;
+    uint64_t start;
+    
+    SIM_Reset();
+    SIM_HD44780_Init(&lcd, LCD_ROWS, LCD_COLS, rw_wired);
+    SIM_HD44780_Attach(&lcd, LCD_I2C_ADDR);
+    
+    start = SIM_Now_Us();
+    MID_Display_Init(&hi2c2);
+    BSP_LCD_Sync();
+    printf("\nRW %s: init took %llu us (incl. 1 s splash)\n",
+           rw_wired ? "wired" : "tied low",
+           (unsigned long long)(SIM_Now_Us() - start));
+    
+    printf("%-12s %-7s %6s %7s %10s %10s\n",
+           "screen", "frame", "xfers", "bytes", "bus_us", "call_us");
+    
+    for (size_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++) {
+        bench_frame(&screens[i], false);
+        check_rows(&screens[i]);
+        bench_frame(&screens[i], true);
+        check_rows(&screens[i]);
+    }
+    
+    bench_rate();
+#if DISPLAY_HAS_OVERVIEW
+    bench_overview_idle();
+#endif
+    
+    MID_Glyph_GetStats(&glyphs);
+    printf("glyphs: %lu hits, %lu misses, %lu evictions\n",
+           (unsigned long)glyphs.hits, (unsigned long)glyphs.misses,
+           (unsigned long)glyphs.evictions);
+    if (glyphs.misses != BENCH_GLYPHS_USED || glyphs.evictions != 0) {
+        printf("FAIL expected %d glyph uploads and no evictions\n",
+               BENCH_GLYPHS_USED);
+        failures++;
+    }
+    
+    bench_history();
+    bench_idle();
+    
+    if (lcd.busy_violations != 0) {
+        printf("FAIL %u bytes latched while the controller was busy\n",
+               (unsigned)lcd.busy_violations);
+        failures++;
+    }
+    
+    if (lcd.setup_violations != 0) {
+        printf("FAIL %u EN pulses raised together with an RW change\n",
+               (unsigned)lcd.setup_violations);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    printf("LCD bench: %ux%u, async=%d busy_flag=%d, I2C %u Hz\n",
+           LCD_COLS, LCD_ROWS, LCD_USE_ASYNC, LCD_USE_BUSY_FLAG, SIM_I2C_CLOCK_HZ);
+    
+    bench_run(true);
+#if LCD_USE_BUSY_FLAG
+    bench_run(false);  // Fallback to fixed delays
+#endif
+    
+    printf("\n%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
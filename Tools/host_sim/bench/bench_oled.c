@@ -0,0 +1,247 @@
+/**
+ * @file    bench_oled.c
+ * @brief   Display update cost on the emulated SSD1306 OLED
+ *
+ * Publishes a model for every screen through the real BSP/Middleware
+ * code and reports, per frame, the I2C traffic next to what a full
+ * 1 KB frame flush costs. The emulated GDDRAM must match the firmware
+ * framebuffer, and the text read back from it must match the expected
+ * layout. Unchanged frames must not reach the bus at all, and a page
+ * whose transfer failed must be resent by the next commit.
+ */
+
+#include "sim.h"
+#include "sim_ssd1306.h"
+#include "mid_display.h"
+#include "mid_glyph.h"
+#include "font5x7.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    DisplayModel_t model;
+    const char *rows[DISPLAY_ROWS];
+} Screen_t;
+
+static SIM_SSD1306_t oled;
+static I2C_HandleTypeDef hi2c2;
+static int failures = 0;
+
+/* Droplet, pump and degree */
+#define BENCH_GLYPHS_USED   3
+
+static const RTC_Time_t bench_time = {56, 34, 12, 1, 1, 1, 25};
+
+/* SysTick as wired in stm32f1xx_it.c (the OLED needs no tick) */
+void SysTick_Handler(void)
+{
+}
+
+#define MODEL_STATUS(m) \
+    {.mode = (m), .moisture = 42, .pump_on = true, \
+     .temperature_x10 = 250, .humidity_x10 = 600, .time = bench_time}
+
+/* Expected rows without trailing spaces; missing rows must be blank.
+ * Codes 0x08-0x0F match any custom glyph.
+ */
+static const Screen_t screens[] = {
+    {"Menu",        {.mode = DISPLAY_MODE_MENU},
+                    {"  CHOOSE MODE", "MANL/AUTO/TIMER"}},
+    {"Manual",      MODEL_STATUS(DISPLAY_MODE_MANUAL),
+                    {"MANUAL  12:34:56", "\x08 42%   \x09 ON", "Temp: 25.0\x0A" "C", "Humi: 60.0%"}},
+    {"Auto",        MODEL_STATUS(DISPLAY_MODE_AUTO),
+                    {"AUTO    12:34:56", "\x08 42%   \x09 ON", "Temp: 25.0\x0A" "C", "Humi: 60.0%"}},
+    {"Time",        {.mode = DISPLAY_MODE_TIMER_DISPLAY, .time = bench_time},
+                    {"Mode: TIMER", "12:34:56"}},
+    {"TimerMenu",   {.mode = DISPLAY_MODE_TIMER_MENU, .menu_selection = 1},
+                    {"TIMER: INC/DEC", " TIME>SCHEDULE"}},
+    {"SetTime",     {.mode = DISPLAY_MODE_TIMER_SET_TIME, .time = bench_time,
+                     .cursor_pos = 1},
+                    {"Set Time:", " 12:34:56"}},
+    {"SetSchedule", {.mode = DISPLAY_MODE_TIMER_SET_SCHEDULE, .schedule_hour = 8,
+                     .schedule_minute = 0, .schedule_duration = 10,
+                     .cursor_pos = 2},
+                    {"Set Schedule:", "08:00 D:10m"}},
+};
+
+/**
+ * @brief Read one text cell back from GDDRAM
+ * @return The font character, 0x08 for a non-font pattern, '\0' if none
+ */
+static char read_cell(uint8_t row, uint8_t col)
+{
+    const uint8_t *cell = &oled.gddram[row][col * SSD1306_CELL_WIDTH];
+    
+    if (cell[0] != 0 || cell[SSD1306_CELL_WIDTH - 2] != 0 || cell[SSD1306_CELL_WIDTH - 1] != 0) {
+        return '\0';
+    }
+    for (uint8_t c = FONT5X7_FIRST; c <= FONT5X7_LAST; c++) {
+        if (memcmp(&cell[1], font5x7[c - FONT5X7_FIRST], FONT5X7_WIDTH) == 0) {
+            return (char)c;
+        }
+    }
+    return DISPLAY_GLYPH_CODE(0);
+}
+
+/**
+ * @brief Compare the emulated panel with the framebuffer and the screen
+ */
+static void check_rows(const Screen_t *screen)
+{
+    const uint8_t *frame = BSP_SSD1306_GetFramebuffer();
+    
+    if (memcmp(oled.gddram, frame, sizeof(oled.gddram)) != 0) {
+        printf("FAIL %s: GDDRAM differs from the framebuffer\n", screen->name);
+        failures++;
+    }
+    
+    for (uint8_t r = 0; r < DISPLAY_ROWS; r++) {
+        const char *expected = screen->rows[r] ? screen->rows[r] : "";
+        size_t len = strlen(expected);
+        
+        for (uint8_t c = 0; c < DISPLAY_COLS; c++) {
+            char want = (c < len) ? expected[c] : ' ';
+            char got = read_cell(r, c);
+            bool glyph = (uint8_t)want >= 0x08 && (uint8_t)want <= 0x0F;
+            
+            if (glyph ? (got != DISPLAY_GLYPH_CODE(0)) : (got != want)) {
+                printf("FAIL %s row %u col %u: got 0x%02X, expected 0x%02X\n",
+                       screen->name, r, c, (uint8_t)got, (uint8_t)want);
+                failures++;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Run one frame and print its cost
+ * @return I2C bytes the frame cost
+ */
+static uint32_t bench_frame(const Screen_t *screen, bool repeat)
+{
+    SSD1306_Stats_t before, after;
+    SIM_I2C_Stats_t stats;
+    
+    BSP_SSD1306_GetStats(&before);
+    SIM_I2C_ResetStats();
+    MID_Display_Publish(&screen->model);
+    MID_Display_Refresh();
+    SIM_I2C_GetStats(&stats);
+    BSP_SSD1306_GetStats(&after);
+    
+    printf("%-12s %-7s %6u %7u %10llu %6lu\n", screen->name,
+           repeat ? "repeat" : "enter",
+           (unsigned)stats.transactions, (unsigned)stats.bytes,
+           (unsigned long long)stats.bus_time_us,
+           (unsigned long)(after.page_writes - before.page_writes));
+    return stats.bytes;
+}
+
+/**
+ * @brief Fail one transfer of a single-page update, then commit again
+ * @param after 0 fails the window command, 1 the page data
+ */
+static void bench_failed_page(uint32_t after)
+{
+    DisplayModel_t model = screens[1].model;
+    const uint8_t *frame = BSP_SSD1306_GetFramebuffer();
+    uint32_t seq;
+    uint32_t cycles;
+    
+    model.moisture = (uint8_t)(50 + after);    // One page changes
+    SIM_I2C_Fail(after, 1);
+    MID_Display_Publish(&model);
+    MID_Display_Refresh();
+    seq = BSP_SSD1306_GetCommitSeq();
+    
+    if (memcmp(oled.gddram, frame, sizeof(oled.gddram)) == 0) {
+        printf("FAIL failed transfer %lu: page reached the panel anyway\n",
+               (unsigned long)after);
+        failures++;
+    }
+    if (BSP_SSD1306_GetCommitDone(seq, &cycles)) {
+        printf("FAIL failed transfer %lu: commit reported done\n", (unsigned long)after);
+        failures++;
+    }
+    
+    // Nothing new to draw: the commit only resends what is still dirty
+    BSP_SSD1306_Commit();
+    if (memcmp(oled.gddram, frame, sizeof(oled.gddram)) != 0) {
+        printf("FAIL failed transfer %lu: page not resent\n", (unsigned long)after);
+        failures++;
+    }
+    if (!BSP_SSD1306_GetCommitDone(seq, &cycles)) {
+        printf("FAIL failed transfer %lu: commit not done after the resend\n",
+               (unsigned long)after);
+        failures++;
+    }
+    printf("failed %s: page resent by the next commit\n", after ? "page data" : "window");
+}
+
+int main(void)
+{
+    SIM_I2C_Stats_t full;
+    GlyphStats_t glyphs;
+    uint32_t partial_bytes = 0;
+    uint32_t frames = 0;
+    
+    printf("OLED bench: 128x64 as %ux%u text, I2C %u Hz\n",
+           DISPLAY_COLS, DISPLAY_ROWS, SIM_I2C_CLOCK_HZ);
+    
+    SIM_Reset();
+    SIM_SSD1306_Init(&oled);
+    SIM_SSD1306_Attach(&oled, SSD1306_I2C_ADDR);
+    
+    MID_Display_Init(&hi2c2);
+    if (!oled.display_on || !oled.charge_pump || oled.addressing_mode != 0) {
+        printf("FAIL init sequence left the panel off or in page mode\n");
+        failures++;
+    }
+    
+    // Reference cost: the whole frame in one transfer
+    SIM_I2C_ResetStats();
+    BSP_SSD1306_Refresh();
+    SIM_I2C_GetStats(&full);
+    printf("full frame: %u xfers, %u bytes, %llu us\n\n",
+           (unsigned)full.transactions, (unsigned)full.bytes,
+           (unsigned long long)full.bus_time_us);
+    
+    printf("%-12s %-7s %6s %7s %10s %6s\n",
+           "screen", "frame", "xfers", "bytes", "bus_us", "pages");
+    
+    for (size_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++) {
+        partial_bytes += bench_frame(&screens[i], false);
+        frames++;
+        check_rows(&screens[i]);
+        if (bench_frame(&screens[i], true) != 0) {
+            printf("FAIL %s: unchanged frame reached the bus\n", screens[i].name);
+            failures++;
+        }
+        check_rows(&screens[i]);
+    }
+    
+    printf("\nper screen change: %lu bytes avg vs %u bytes full frame\n",
+           (unsigned long)(partial_bytes / frames), (unsigned)full.bytes);
+    if (partial_bytes / frames >= full.bytes) {
+        printf("FAIL partial updates cost as much as a full frame\n");
+        failures++;
+    }
+    
+    bench_failed_page(0);
+    bench_failed_page(1);
+    
+    MID_Glyph_GetStats(&glyphs);
+    printf("glyphs: %lu hits, %lu misses, %lu evictions\n",
+           (unsigned long)glyphs.hits, (unsigned long)glyphs.misses,
+           (unsigned long)glyphs.evictions);
+    if (glyphs.misses != BENCH_GLYPHS_USED || glyphs.evictions != 0) {
+        printf("FAIL expected %d glyph uploads and no evictions\n",
+               BENCH_GLYPHS_USED);
+        failures++;
+    }
+    
+    printf("\n%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file    sim.h
+ * @brief   Simulated clock, interrupts, I2C bus, UART, TIM2 and GPIO for host builds
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "stm32f1xx_hal.h"
+
+/* I2C bus timing (100 kHz, 9 clocks per byte incl. ACK) */
+#define SIM_I2C_CLOCK_HZ        100000U
+#define SIM_I2C_BYTE_US         (9U * 1000000U / SIM_I2C_CLOCK_HZ)
+#define SIM_I2C_START_STOP_US   10U
+
+#define SIM_I2C_MAX_DEVICES     4
+
+/* UART timing (115200 baud unless HAL_UART_Init() sets another, 8N1) */
+#define SIM_UART_BAUD           115200U
+#define SIM_UART_BYTE_US(n)     ((uint64_t)(n) * 10U * 1000000U / SIM_UART_BAUD)
+
+/* Core clock seen by the firmware (SystemCoreClock), TIM2 runs from it */
+#define SIM_CORE_CLOCK_HZ       72000000U
+
+/* Emulated I2C device
+ * start: optional, called at the START of each write transfer
+ * write: called once per data byte with the time it is latched
+ * read:  fills one byte for a master receive, returns false to NACK
+ */
+typedef struct {
+    uint16_t addr;  // 8-bit HAL address
+    void (*start)(void *ctx);
+    void (*write)(void *ctx, uint8_t data, uint64_t t_us);
+    bool (*read)(void *ctx, uint8_t *data, uint64_t t_us);
+    void *ctx;
+} SIM_I2C_Device_t;
+
+/* Bus traffic counters */
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint64_t bus_time_us;
+} SIM_I2C_Stats_t;
+
+void SIM_Reset(void);
+uint64_t SIM_Now_Us(void);
+void SIM_Advance_Us(uint64_t us);
+
+bool SIM_I2C_Attach(const SIM_I2C_Device_t *dev);
+void SIM_I2C_GetStats(SIM_I2C_Stats_t *stats);
+void SIM_I2C_ResetStats(void);
+
+/* Let the next `after` write transfers through, then NACK the address of
+ * `count` more, as a device that briefly dropped off the bus: nothing is
+ * delivered and the HAL returns HAL_ERROR (blocking) or calls
+ * HAL_I2C_ErrorCallback() (interrupt).
+ */
+void SIM_I2C_Fail(uint32_t after, uint32_t count);
+
+/* Receives each UART DMA transfer when it completes */
+typedef void (*SIM_UART_Sink_t)(void *ctx, const uint8_t *data, uint16_t len);
+void SIM_UART_SetSink(SIM_UART_Sink_t sink, void *ctx);
+
+/* Bytes sent to the UART from outside, arriving back to back at the baud
+ * rate. A byte that arrives with no receive armed is an overrun: it is
+ * lost and HAL_UART_ErrorCallback() runs, as on the chip.
+ */
+#define SIM_UART_RX_MAX         8192
+bool SIM_UART_Inject(const uint8_t *data, uint16_t len);
+uint16_t SIM_UART_RxPending(void);
+
+/* Drive input pins of a port. Edges on GPIOA pins set the EXTI pending
+ * bits selected by RTSR/FTSR; the handler runs at once if the line is
+ * unmasked in IMR and PRIMASK allows it.
+ */
+void SIM_GPIO_SetInput(GPIO_TypeDef *port, uint16_t pins, bool high);
+
+/* Provided by the harness, called every simulated millisecond */
+void SysTick_Handler(void);
+
+/* Optional (weak default), called on enabled TIM2 update/CC1 events */
+void TIM2_IRQHandler(void);
+
+/* Optional (weak defaults), called for pending unmasked EXTI lines */
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void EXTI4_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+
+#endif /* SIM_H */
@@ -0,0 +1,54 @@
+/**
+ * @file    sim_hd44780.h
+ * @brief   PCF8574 expander + HD44780 controller emulator
+ *
+ * Models the 4-bit interface as wired on the common I2C backpacks
+ * (P0=RS, P1=RW, P2=EN, P3=BL, P4-P7=D4-D7): nibbles latch on the EN
+ * falling edge, reads drive BF/AC on EN high, and every instruction keeps
+ * the controller busy for its datasheet execution time.
+ */
+
+#ifndef SIM_HD44780_H
+#define SIM_HD44780_H
+
+#include "sim.h"
+
+#define SIM_HD44780_DDRAM_SIZE  0x80
+#define SIM_HD44780_CGRAM_SIZE  64
+
+typedef struct {
+    /* Configuration */
+    uint8_t rows;
+    uint8_t cols;
+    bool rw_wired;              // false: RW tied low, BF never readable
+    
+    /* PCF8574 state */
+    uint8_t port;               // Last byte written to the expander
+    
+    /* HD44780 state */
+    bool four_bit;
+    bool low_nibble;            // Next latch completes a 4-bit transfer
+    uint8_t high_nibble;
+    bool read_low_nibble;
+    uint8_t ddram[SIM_HD44780_DDRAM_SIZE];
+    uint8_t cgram[SIM_HD44780_CGRAM_SIZE];
+    uint8_t ac;                 // Address counter
+    bool ac_cgram;              // AC points into CGRAM
+    bool increment;
+    bool display_on;
+    bool two_line;
+    uint64_t busy_until_us;
+    
+    /* Statistics */
+    uint32_t instructions;
+    uint32_t data_writes;
+    uint32_t busy_violations;   // Writes latched while BF was set
+    uint32_t setup_violations;  // EN raised in the same write that changed RW (tAS)
+} SIM_HD44780_t;
+
+void SIM_HD44780_Init(SIM_HD44780_t *lcd, uint8_t rows, uint8_t cols, bool rw_wired);
+bool SIM_HD44780_Attach(SIM_HD44780_t *lcd, uint16_t addr);
+void SIM_HD44780_GetRow(const SIM_HD44780_t *lcd, uint8_t row, char *out);
+bool SIM_HD44780_Backlight(const SIM_HD44780_t *lcd);
+
+#endif /* SIM_HD44780_H */
@@ -0,0 +1,43 @@
+/**
+ * @file    sim_ssd1306.h
+ * @brief   SSD1306 128x64 OLED controller emulator (I2C)
+ *
+ * Each write transfer starts with a control byte: 0x00 for a command
+ * stream, 0x40 for a data stream, Co (0x80) for a single byte followed by
+ * another control byte. Data goes to GDDRAM through the column/page
+ * window in horizontal or page addressing mode.
+ */
+
+#ifndef SIM_SSD1306_H
+#define SIM_SSD1306_H
+
+#include "sim.h"
+
+#define SIM_SSD1306_WIDTH       128
+#define SIM_SSD1306_PAGES       8
+
+typedef struct {
+    /* Controller state */
+    uint8_t gddram[SIM_SSD1306_PAGES][SIM_SSD1306_WIDTH];
+    bool display_on;
+    bool charge_pump;
+    uint8_t addressing_mode;    // 0 horizontal, 1 vertical, 2 page
+    uint8_t col_start, col_end, col;
+    uint8_t page_start, page_end, page;
+    
+    /* Transfer parser */
+    bool expect_control;        // Next byte is a control byte
+    bool data_stream;
+    bool single_byte;           // Co set: one byte, then a control byte
+    uint8_t cmd[4];             // Command being assembled
+    uint8_t cmd_len;
+    
+    /* Statistics */
+    uint32_t commands;
+    uint32_t data_writes;
+} SIM_SSD1306_t;
+
+void SIM_SSD1306_Init(SIM_SSD1306_t *oled);
+bool SIM_SSD1306_Attach(SIM_SSD1306_t *oled, uint16_t addr);
+
+#endif /* SIM_SSD1306_H */
@@ -0,0 +1,207 @@
+/**
+ * @file    stm32f1xx_hal.h
+ * @brief   Host stand-in for the STM32F1 HAL used by the simulator
+ *
+ * Only the types and calls the BSP/Middleware layers touch are provided.
+ * I2C transfers are routed to emulated devices and UART DMA output to a
+ * sink (see sim.h), TIM2 and the DWT cycle counter count in simulated
+ * time, GPIOA input pins are set by the harness and raise EXTI; time is a
+ * simulated microsecond clock, so HAL_Delay() costs nothing on the host.
+ */
+
+#ifndef STM32F1XX_HAL_H
+#define STM32F1XX_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+
+typedef struct {
+    uint32_t id;
+} I2C_HandleTypeDef;
+
+typedef enum {
+    HAL_UART_STATE_READY   = 0x20U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+#define HAL_UART_ERROR_NONE     0x00000000U
+#define HAL_UART_ERROR_PE       0x00000001U
+#define HAL_UART_ERROR_NE       0x00000002U
+#define HAL_UART_ERROR_FE       0x00000004U
+#define HAL_UART_ERROR_ORE      0x00000008U
+#define HAL_UART_ERROR_DMA      0x00000010U
+
+typedef struct {
+    uint32_t BaudRate;          // 0 means SIM_UART_BAUD
+} UART_InitTypeDef;
+
+typedef struct {
+    uint32_t id;
+    UART_InitTypeDef Init;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+/* GPIO port: the harness drives the input pins through IDR */
+typedef struct {
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef SIM_GPIOA;
+#define GPIOA                   (&SIM_GPIOA)
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0              ((uint16_t)0x0001)
+#define GPIO_PIN_1              ((uint16_t)0x0002)
+#define GPIO_PIN_2              ((uint16_t)0x0004)
+#define GPIO_PIN_3              ((uint16_t)0x0008)
+#define GPIO_PIN_4              ((uint16_t)0x0010)
+#define GPIO_PIN_5              ((uint16_t)0x0020)
+#define GPIO_PIN_6              ((uint16_t)0x0040)
+#define GPIO_PIN_7              ((uint16_t)0x0080)
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+#define GPIO_MODE_INPUT                 0x00000000U
+#define GPIO_MODE_IT_RISING             0x10110000U
+#define GPIO_MODE_IT_FALLING            0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING     0x10310000U
+#define GPIO_NOPULL                     0x00000000U
+#define GPIO_PULLUP                     0x00000001U
+
+/* External interrupts: line n follows pin n of port A (AFIO reset mapping) */
+typedef struct {
+    volatile uint32_t IMR;
+    volatile uint32_t EMR;
+    volatile uint32_t RTSR;
+    volatile uint32_t FTSR;
+    volatile uint32_t SWIER;
+    volatile uint32_t PR;       // Write 1 to clear
+} EXTI_TypeDef;
+
+extern EXTI_TypeDef SIM_EXTI;
+#define EXTI                    (&SIM_EXTI)
+
+/* PR is write-1-to-clear, so firmware clears through the HAL macro */
+void SIM_EXTI_ClearPending(uint32_t lines);
+#define __HAL_GPIO_EXTI_GET_IT(__EXTI_LINE__)   (EXTI->PR & (__EXTI_LINE__))
+#define __HAL_GPIO_EXTI_CLEAR_IT(__EXTI_LINE__) SIM_EXTI_ClearPending(__EXTI_LINE__)
+
+/* DWT cycle counter, runs at SystemCoreClock once enabled */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type SIM_DWT;
+extern CoreDebug_Type SIM_CoreDebug;
+#define DWT                     (&SIM_DWT)
+#define CoreDebug               (&SIM_CoreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk          0x00000001U
+#define CoreDebug_DEMCR_TRCENA_Msk      0x01000000U
+
+/* General-purpose timer: the registers the firmware programs directly.
+ * The sim counts in simulated time and raises TIM2_IRQHandler().
+ */
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t DIER;
+    volatile uint32_t SR;
+    volatile uint32_t EGR;
+    volatile uint32_t PSC;
+    volatile uint32_t ARR;
+    volatile uint32_t CCR1;
+} TIM_TypeDef;
+
+extern TIM_TypeDef SIM_TIM2;
+#define TIM2                    (&SIM_TIM2)
+
+#define TIM_CR1_CEN             0x0001U
+#define TIM_CR1_URS             0x0004U
+#define TIM_CR1_OPM             0x0008U
+#define TIM_DIER_UIE            0x0001U
+#define TIM_DIER_CC1IE          0x0002U
+#define TIM_SR_UIF              0x0001U
+#define TIM_SR_CC1IF            0x0002U
+#define TIM_EGR_UG              0x0001U
+
+typedef enum {
+    EXTI0_IRQn = 6,
+    EXTI1_IRQn = 7,
+    EXTI2_IRQn = 8,
+    EXTI3_IRQn = 9,
+    EXTI4_IRQn = 10,
+    EXTI9_5_IRQn = 23,
+    TIM2_IRQn = 28,
+    EXTI15_10_IRQn = 40
+} IRQn_Type;
+
+extern uint32_t SystemCoreClock;
+
+#define __HAL_RCC_TIM2_CLK_ENABLE()     do { } while (0)
+
+/* Core */
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+
+/* Interrupt masking (CMSIS) */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_IPSR(void);
+
+/* NVIC (every interrupt is always enabled in the sim) */
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+/* GPIO */
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* I2C */
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                        uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                          uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                         uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                             uint8_t *pData, uint16_t Size);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+/* UART */
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif /* STM32F1XX_HAL_H */
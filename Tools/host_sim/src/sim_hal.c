@@ -0,0 +1,670 @@
+/**
+ * @file    sim_hal.c
+ * @brief   Host implementation of the HAL subset: clock, IRQs, I2C, UART, TIM2, GPIO
+ *
+ * Time only moves when the firmware waits: HAL_Delay(), blocking I2C
+ * transfers and every PRIMASK/HAL_GetTick() call (one CPU step each, so
+ * polling loops make progress). Pending "interrupts" (I2C and UART DMA
+ * completion, UART receive, TIM2, SysTick) are delivered whenever time
+ * moves while PRIMASK is clear.
+ *
+ * TIM2 is a plain register struct. The sim picks up a UG written to EGR
+ * when it next gets control (after each handler, or when time moves) and
+ * restarts the count there; SR flags are rc_w0 as on the chip.
+ *
+ * The DWT cycle counter is refreshed from the simulated clock whenever
+ * time moves. EXTI pending bits are set on input edges whether the line
+ * is masked or not; a handler runs only for unmasked ones.
+ */
+
+#include "sim.h"
+#include <string.h>
+
+#define SIM_CPU_STEP_US     1U
+
+static uint64_t sim_now_us = 0;
+static uint32_t sim_primask = 0;
+static bool sim_in_irq = false;
+static uint64_t sim_next_tick_us = 1000;
+
+static SIM_I2C_Device_t sim_devices[SIM_I2C_MAX_DEVICES];
+static uint8_t sim_device_count = 0;
+static SIM_I2C_Stats_t sim_stats;
+static uint32_t sim_i2c_pass = 0;   // Write transfers to let through first
+static uint32_t sim_i2c_fail = 0;   // Write transfers to NACK after those
+
+/* Interrupt-driven transfer in flight */
+static struct {
+    bool active;
+    I2C_HandleTypeDef *hi2c;
+    const SIM_I2C_Device_t *dev;
+    uint8_t data[256];
+    uint16_t len;
+    uint64_t start_us;
+    uint64_t done_us;
+    bool nack;
+} sim_it;
+
+/* UART DMA transfer in flight */
+static struct {
+    bool active;
+    UART_HandleTypeDef *huart;
+    uint8_t data[256];
+    uint16_t len;
+    uint64_t done_us;
+} sim_uart;
+
+static SIM_UART_Sink_t sim_uart_sink = NULL;
+static void *sim_uart_ctx = NULL;
+static uint32_t sim_uart_baud = SIM_UART_BAUD;
+
+/* UART receive: line input queue and the armed 1-byte receive */
+static struct {
+    uint8_t line[SIM_UART_RX_MAX];
+    uint16_t head;
+    uint16_t count;
+    uint64_t next_us;           // Arrival of line[head]
+    UART_HandleTypeDef *huart;
+    uint8_t *dest;              // NULL when no receive is armed
+} sim_rx;
+
+/* TIM2 counter state behind the register struct */
+static struct {
+    uint64_t start_us;          // Counter at 0
+    bool cc1_done;              // CC1 match already raised this period
+} sim_tim;
+
+TIM_TypeDef SIM_TIM2;
+GPIO_TypeDef SIM_GPIOA;
+EXTI_TypeDef SIM_EXTI;
+DWT_Type SIM_DWT;
+CoreDebug_Type SIM_CoreDebug;
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+
+static void sim_service_irqs(void);
+
+/**
+ * @brief Line time of n bytes at the configured baud rate
+ */
+static uint64_t sim_uart_byte_us(uint32_t n)
+{
+    return (uint64_t)n * 10U * 1000000U / sim_uart_baud;
+}
+
+/**
+ * @brief Time of a TIM2 counter value in the current period
+ */
+static uint64_t sim_tim_at(uint32_t count)
+{
+    return sim_tim.start_us +
+           (uint64_t)count * (TIM2->PSC + 1U) * 1000000U / SystemCoreClock;
+}
+
+/**
+ * @brief Apply a UG the firmware wrote since the sim last looked
+ */
+static void sim_tim_sync(void)
+{
+    if (TIM2->EGR & TIM_EGR_UG) {
+        TIM2->EGR = 0;
+        sim_tim.start_us = sim_now_us;
+        sim_tim.cc1_done = false;
+    }
+}
+
+/**
+ * @brief Next TIM2 event still ahead, 0 if the counter is stopped
+ */
+static uint64_t sim_tim_next(void)
+{
+    if (!(TIM2->CR1 & TIM_CR1_CEN)) {
+        return 0;
+    }
+    if (!sim_tim.cc1_done && TIM2->CCR1 <= TIM2->ARR) {
+        return sim_tim_at(TIM2->CCR1);
+    }
+    return sim_tim_at(TIM2->ARR + 1U);
+}
+
+/**
+ * @brief Raise TIM2 flags that are due and run the handler for enabled ones
+ */
+static void sim_tim_service(void)
+{
+    sim_tim_sync();
+    
+    while ((TIM2->CR1 & TIM_CR1_CEN) && sim_now_us >= sim_tim_next()) {
+        if (!sim_tim.cc1_done && TIM2->CCR1 <= TIM2->ARR) {
+            sim_tim.cc1_done = true;
+            TIM2->SR |= TIM_SR_CC1IF;
+        } else {
+            TIM2->SR |= TIM_SR_UIF;
+            sim_tim.start_us = sim_tim_at(TIM2->ARR + 1U);
+            sim_tim.cc1_done = false;
+            if (TIM2->CR1 & TIM_CR1_OPM) {
+                TIM2->CR1 &= ~TIM_CR1_CEN;
+            }
+        }
+        
+        if (TIM2->SR & TIM2->DIER) {
+            uint32_t sr = TIM2->SR;
+            
+            TIM2_IRQHandler();
+            TIM2->SR &= sr;     // Writing 1 leaves a flag alone
+            sim_tim_sync();
+        }
+    }
+}
+
+/**
+ * @brief Find the emulated device answering at an address
+ */
+static const SIM_I2C_Device_t *sim_find(uint16_t addr)
+{
+    for (uint8_t i = 0; i < sim_device_count; i++) {
+        if (sim_devices[i].addr == addr) {
+            return &sim_devices[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Bus time of one transaction carrying len data bytes
+ */
+static uint64_t sim_i2c_duration(uint16_t len)
+{
+    return SIM_I2C_START_STOP_US + (uint64_t)(len + 1U) * SIM_I2C_BYTE_US;
+}
+
+static void sim_i2c_count(uint16_t len)
+{
+    sim_stats.transactions++;
+    sim_stats.bytes += len;
+    sim_stats.bus_time_us += sim_i2c_duration(len);
+}
+
+/**
+ * @brief Hand bytes to a device, each stamped with its ACK time
+ */
+static void sim_i2c_deliver(const SIM_I2C_Device_t *dev, const uint8_t *data,
+                            uint16_t len, uint64_t start_us)
+{
+    if (dev->start != NULL) {
+        dev->start(dev->ctx);
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        uint64_t t = start_us + SIM_I2C_START_STOP_US + (uint64_t)(i + 2U) * SIM_I2C_BYTE_US;
+        dev->write(dev->ctx, data[i], t);
+    }
+}
+
+/**
+ * @brief Move time forward, delivering interrupts that fall inside
+ */
+void SIM_Advance_Us(uint64_t us)
+{
+    uint64_t target = sim_now_us + us;
+    
+    while (sim_now_us < target) {
+        uint64_t next = target;
+        
+        // Stop at each interrupt still ahead of us (masked ones stay pending)
+        if (sim_next_tick_us > sim_now_us && sim_next_tick_us < next) {
+            next = sim_next_tick_us;
+        }
+        if (sim_it.active && sim_it.done_us > sim_now_us && sim_it.done_us < next) {
+            next = sim_it.done_us;
+        }
+        if (sim_uart.active && sim_uart.done_us > sim_now_us && sim_uart.done_us < next) {
+            next = sim_uart.done_us;
+        }
+        if (sim_rx.count > 0 && sim_rx.next_us > sim_now_us && sim_rx.next_us < next) {
+            next = sim_rx.next_us;
+        }
+        sim_tim_sync();
+        if (sim_tim_next() > sim_now_us && sim_tim_next() < next) {
+            next = sim_tim_next();
+        }
+        sim_now_us = next;
+        if (SIM_DWT.CTRL & DWT_CTRL_CYCCNTENA_Msk) {
+            SIM_DWT.CYCCNT = (uint32_t)(sim_now_us * (SystemCoreClock / 1000000U));
+        }
+        sim_service_irqs();
+    }
+}
+
+/**
+ * @brief Run the handler of each EXTI vector with a pending unmasked line
+ */
+static void sim_exti_service(void)
+{
+    uint32_t pending = SIM_EXTI.PR & SIM_EXTI.IMR;
+    
+    if (pending & 0x0001U) EXTI0_IRQHandler();
+    if (pending & 0x0002U) EXTI1_IRQHandler();
+    if (pending & 0x0004U) EXTI2_IRQHandler();
+    if (pending & 0x0008U) EXTI3_IRQHandler();
+    if (pending & 0x0010U) EXTI4_IRQHandler();
+    if (pending & 0x03E0U) EXTI9_5_IRQHandler();
+    if (pending & 0xFC00U) EXTI15_10_IRQHandler();
+}
+
+/**
+ * @brief Run pending interrupt handlers if PRIMASK allows it
+ */
+static void sim_service_irqs(void)
+{
+    if (sim_primask || sim_in_irq) {
+        return;
+    }
+    
+    sim_in_irq = true;
+    
+    if (sim_it.active && sim_now_us >= sim_it.done_us) {
+        sim_it.active = false;
+        if (sim_it.nack) {
+            HAL_I2C_ErrorCallback(sim_it.hi2c);
+        } else {
+            sim_i2c_deliver(sim_it.dev, sim_it.data, sim_it.len, sim_it.start_us);
+            HAL_I2C_MasterTxCpltCallback(sim_it.hi2c);
+        }
+    }
+    
+    if (sim_uart.active && sim_now_us >= sim_uart.done_us) {
+        sim_uart.active = false;
+        if (sim_uart_sink != NULL) {
+            sim_uart_sink(sim_uart_ctx, sim_uart.data, sim_uart.len);
+        }
+        HAL_UART_TxCpltCallback(sim_uart.huart);
+    }
+    
+    while (sim_rx.count > 0 && sim_now_us >= sim_rx.next_us) {
+        uint8_t byte = sim_rx.line[sim_rx.head];
+        
+        sim_rx.head = (uint16_t)((sim_rx.head + 1) % SIM_UART_RX_MAX);
+        sim_rx.count--;
+        sim_rx.next_us += sim_uart_byte_us(1);
+        
+        if (sim_rx.dest != NULL) {
+            *sim_rx.dest = byte;
+            sim_rx.dest = NULL;
+            sim_rx.huart->RxState = HAL_UART_STATE_READY;
+            HAL_UART_RxCpltCallback(sim_rx.huart);
+            sim_tim_sync();
+        } else if (sim_rx.huart != NULL) {
+            // Overrun ends the receive, like UART_EndRxTransfer()
+            sim_rx.huart->ErrorCode = HAL_UART_ERROR_ORE;
+            sim_rx.huart->RxState = HAL_UART_STATE_READY;
+            HAL_UART_ErrorCallback(sim_rx.huart);
+            sim_rx.huart->ErrorCode = HAL_UART_ERROR_NONE;
+        }
+    }
+    
+    sim_tim_service();
+    
+    if (SIM_EXTI.PR & SIM_EXTI.IMR) {
+        sim_exti_service();
+    }
+    
+    while (sim_now_us >= sim_next_tick_us) {
+        sim_next_tick_us += 1000;
+        SysTick_Handler();
+    }
+    
+    sim_in_irq = false;
+}
+
+void SIM_Reset(void)
+{
+    sim_now_us = 0;
+    sim_next_tick_us = 1000;
+    sim_primask = 0;
+    sim_in_irq = false;
+    sim_device_count = 0;
+    memset(&sim_it, 0, sizeof(sim_it));
+    memset(&sim_uart, 0, sizeof(sim_uart));
+    memset(&sim_rx, 0, sizeof(sim_rx));
+    sim_uart_sink = NULL;
+    sim_uart_ctx = NULL;
+    sim_uart_baud = SIM_UART_BAUD;
+    memset(&sim_tim, 0, sizeof(sim_tim));
+    memset(&SIM_TIM2, 0, sizeof(SIM_TIM2));
+    SIM_GPIOA.IDR = 0xFFFF;     // Pull-ups: nothing pressed
+    SIM_GPIOA.ODR = 0;
+    memset(&SIM_EXTI, 0, sizeof(SIM_EXTI));
+    memset(&SIM_DWT, 0, sizeof(SIM_DWT));
+    memset(&SIM_CoreDebug, 0, sizeof(SIM_CoreDebug));
+    SystemCoreClock = SIM_CORE_CLOCK_HZ;
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    sim_i2c_pass = 0;
+    sim_i2c_fail = 0;
+}
+
+uint64_t SIM_Now_Us(void)
+{
+    return sim_now_us;
+}
+
+bool SIM_I2C_Attach(const SIM_I2C_Device_t *dev)
+{
+    if (sim_device_count >= SIM_I2C_MAX_DEVICES) {
+        return false;
+    }
+    sim_devices[sim_device_count++] = *dev;
+    return true;
+}
+
+void SIM_I2C_GetStats(SIM_I2C_Stats_t *stats)
+{
+    *stats = sim_stats;
+}
+
+void SIM_I2C_ResetStats(void)
+{
+    memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+void SIM_I2C_Fail(uint32_t after, uint32_t count)
+{
+    sim_i2c_pass = after;
+    sim_i2c_fail = count;
+}
+
+/**
+ * @brief Check if this write transfer is one to fail (see SIM_I2C_Fail)
+ */
+static bool sim_i2c_fault(void)
+{
+    if (sim_i2c_fail == 0) {
+        return false;
+    }
+    if (sim_i2c_pass != 0) {
+        sim_i2c_pass--;
+        return false;
+    }
+    sim_i2c_fail--;
+    return true;
+}
+
+void SIM_UART_SetSink(SIM_UART_Sink_t sink, void *ctx)
+{
+    sim_uart_sink = sink;
+    sim_uart_ctx = ctx;
+}
+
+bool SIM_UART_Inject(const uint8_t *data, uint16_t len)
+{
+    if (len > SIM_UART_RX_MAX - sim_rx.count) {
+        return false;
+    }
+    if (sim_rx.count == 0) {
+        sim_rx.next_us = sim_now_us + sim_uart_byte_us(1);
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        sim_rx.line[(sim_rx.head + sim_rx.count) % SIM_UART_RX_MAX] = data[i];
+        sim_rx.count++;
+    }
+    return true;
+}
+
+uint16_t SIM_UART_RxPending(void)
+{
+    return sim_rx.count;
+}
+
+/* ---------------------------------------------------------------------------
+ * HAL
+ * ------------------------------------------------------------------------- */
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t wait = Delay;
+    
+    // Same rounding as the real HAL: at least one extra tick
+    if (wait < HAL_MAX_DELAY) {
+        wait++;
+    }
+    
+    while ((HAL_GetTick() - start) < wait) {
+        SIM_Advance_Us(1000U - (sim_now_us % 1000U));
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    SIM_Advance_Us(SIM_CPU_STEP_US);
+    return (uint32_t)(sim_now_us / 1000U);
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return sim_primask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    sim_primask = priMask;
+    SIM_Advance_Us(SIM_CPU_STEP_US);
+}
+
+void __disable_irq(void)
+{
+    sim_primask = 1;
+}
+
+void __enable_irq(void)
+{
+    __set_PRIMASK(0);
+}
+
+uint32_t __get_IPSR(void)
+{
+    return sim_in_irq ? 1U : 0U;
+}
+
+void SIM_GPIO_SetInput(GPIO_TypeDef *port, uint16_t pins, bool high)
+{
+    uint32_t old = port->IDR;
+    
+    port->IDR = high ? (old | pins) : (old & ~(uint32_t)pins);
+    if (port == GPIOA) {
+        uint32_t rising = ~old & port->IDR & 0xFFFFU;
+        uint32_t falling = old & ~port->IDR & 0xFFFFU;
+        
+        SIM_EXTI.PR |= (rising & SIM_EXTI.RTSR) | (falling & SIM_EXTI.FTSR);
+        sim_service_irqs();
+    }
+}
+
+void SIM_EXTI_ClearPending(uint32_t lines)
+{
+    SIM_EXTI.PR &= ~lines;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    uint32_t pins = GPIO_Init->Pin & 0xFFFFU;
+    
+    if (GPIOx != GPIOA || !(GPIO_Init->Mode & 0x00010000U)) {
+        return;     // Only EXTI routing is modelled
+    }
+    SIM_EXTI.IMR |= pins;
+    SIM_EXTI.RTSR = (GPIO_Init->Mode & 0x00100000U) ? (SIM_EXTI.RTSR | pins) : (SIM_EXTI.RTSR & ~pins);
+    SIM_EXTI.FTSR = (GPIO_Init->Mode & 0x00200000U) ? (SIM_EXTI.FTSR | pins) : (SIM_EXTI.FTSR & ~pins);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+__attribute__((weak)) void TIM2_IRQHandler(void)
+{
+}
+
+__attribute__((weak)) void EXTI0_IRQHandler(void) { SIM_EXTI_ClearPending(0x0001U); }
+__attribute__((weak)) void EXTI1_IRQHandler(void) { SIM_EXTI_ClearPending(0x0002U); }
+__attribute__((weak)) void EXTI2_IRQHandler(void) { SIM_EXTI_ClearPending(0x0004U); }
+__attribute__((weak)) void EXTI3_IRQHandler(void) { SIM_EXTI_ClearPending(0x0008U); }
+__attribute__((weak)) void EXTI4_IRQHandler(void) { SIM_EXTI_ClearPending(0x0010U); }
+__attribute__((weak)) void EXTI9_5_IRQHandler(void) { SIM_EXTI_ClearPending(0x03E0U); }
+__attribute__((weak)) void EXTI15_10_IRQHandler(void) { SIM_EXTI_ClearPending(0xFC00U); }
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                        uint32_t Trials, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)Trials;
+    (void)Timeout;
+    
+    if (sim_it.active) {
+        return HAL_BUSY;
+    }
+    sim_i2c_count(0);
+    SIM_Advance_Us(sim_i2c_duration(0));
+    return sim_find(DevAddress) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                          uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    const SIM_I2C_Device_t *dev = sim_find(DevAddress);
+    uint64_t start = sim_now_us;
+    
+    (void)hi2c;
+    (void)Timeout;
+    
+    if (sim_it.active) {
+        return HAL_BUSY;
+    }
+    
+    sim_i2c_count(Size);
+    if (dev == NULL || sim_i2c_fault()) {
+        SIM_Advance_Us(sim_i2c_duration(0));
+        return HAL_ERROR;
+    }
+    
+    sim_i2c_deliver(dev, pData, Size, start);
+    SIM_Advance_Us(sim_i2c_duration(Size));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                         uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    const SIM_I2C_Device_t *dev = sim_find(DevAddress);
+    
+    (void)hi2c;
+    (void)Timeout;
+    
+    if (sim_it.active) {
+        return HAL_BUSY;
+    }
+    
+    sim_i2c_count(Size);
+    SIM_Advance_Us(sim_i2c_duration(Size));
+    
+    if (dev == NULL || dev->read == NULL) {
+        return HAL_ERROR;
+    }
+    for (uint16_t i = 0; i < Size; i++) {
+        if (!dev->read(dev->ctx, &pData[i], sim_now_us)) {
+            return HAL_ERROR;
+        }
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                             uint8_t *pData, uint16_t Size)
+{
+    if (sim_it.active || Size > sizeof(sim_it.data)) {
+        return HAL_BUSY;
+    }
+    
+    sim_it.active = true;
+    sim_it.hi2c = hi2c;
+    sim_it.dev = sim_find(DevAddress);
+    sim_it.nack = (sim_it.dev == NULL || sim_i2c_fault());
+    memcpy(sim_it.data, pData, Size);
+    sim_it.len = Size;
+    sim_it.start_us = sim_now_us;
+    sim_it.done_us = sim_now_us + sim_i2c_duration(sim_it.nack ? 0 : Size);
+    sim_i2c_count(Size);
+    
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+}
+
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+    sim_uart_baud = (huart->Init.BaudRate != 0) ? huart->Init.BaudRate : SIM_UART_BAUD;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if (sim_uart.active || Size == 0 || Size > sizeof(sim_uart.data)) {
+        return HAL_BUSY;
+    }
+    
+    sim_uart.active = true;
+    sim_uart.huart = huart;
+    memcpy(sim_uart.data, pData, Size);
+    sim_uart.len = Size;
+    sim_uart.done_us = sim_now_us + sim_uart_byte_us(Size);
+    
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if (sim_rx.dest != NULL || Size != 1) {
+        return HAL_BUSY;    // The sim only models 1-byte receives
+    }
+    
+    sim_rx.huart = huart;
+    sim_rx.dest = pData;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file    sim_hd44780.c
+ * @brief   PCF8574 expander + HD44780 controller emulator
+ */
+
+#include "sim_hd44780.h"
+#include <string.h>
+
+#define PIN_RS      0x01
+#define PIN_RW      0x02
+#define PIN_EN      0x04
+#define PIN_BL      0x08
+
+/* Execution times (datasheet, fosc = 270 kHz) */
+#define EXEC_US         37U
+#define EXEC_CLEAR_US   1520U
+
+/* Rows 3-4 continue DDRAM lines 1-2 right after the visible cells */
+static uint8_t lcd_row_offset(const SIM_HD44780_t *lcd, uint8_t row)
+{
+    return (uint8_t)((row & 1 ? 0x40 : 0x00) + (row >= 2 ? lcd->cols : 0));
+}
+
+/**
+ * @brief Advance the address counter after a data access
+ */
+static void lcd_step_ac(SIM_HD44780_t *lcd)
+{
+    if (lcd->ac_cgram) {
+        lcd->ac = (uint8_t)((lcd->ac + (lcd->increment ? 1 : -1)) & 0x3F);
+        return;
+    }
+    
+    if (lcd->increment) {
+        lcd->ac++;
+        if (lcd->two_line) {
+            if (lcd->ac == 0x28) lcd->ac = 0x40;
+            else if (lcd->ac == 0x68) lcd->ac = 0x00;
+        }
+    } else {
+        lcd->ac--;
+        if (lcd->two_line) {
+            if (lcd->ac == 0x3F) lcd->ac = 0x27;
+            else if (lcd->ac == 0xFF) lcd->ac = 0x67;
+        }
+    }
+    lcd->ac &= 0x7F;
+}
+
+/**
+ * @brief Execute one complete instruction or data byte
+ */
+static void lcd_execute(SIM_HD44780_t *lcd, uint8_t value, bool rs, uint64_t t_us)
+{
+    uint32_t exec = EXEC_US;
+    
+    if (t_us < lcd->busy_until_us) {
+        lcd->busy_violations++;
+    }
+    
+    if (rs) {
+        lcd->data_writes++;
+        if (lcd->ac_cgram) {
+            lcd->cgram[lcd->ac & 0x3F] = value & 0x1F;
+        } else {
+            lcd->ddram[lcd->ac & 0x7F] = value;
+        }
+        lcd_step_ac(lcd);
+    } else {
+        lcd->instructions++;
+        if (value & 0x80) {
+            lcd->ac = value & 0x7F;
+            lcd->ac_cgram = false;
+        } else if (value & 0x40) {
+            lcd->ac = value & 0x3F;
+            lcd->ac_cgram = true;
+        } else if (value & 0x20) {
+            lcd->four_bit = !(value & 0x10);
+            lcd->two_line = (value & 0x08) != 0;
+        } else if (value & 0x10) {
+            // Cursor/display shift: not used by the driver
+        } else if (value & 0x08) {
+            lcd->display_on = (value & 0x04) != 0;
+        } else if (value & 0x04) {
+            lcd->increment = (value & 0x02) != 0;
+        } else if (value & 0x02) {
+            lcd->ac = 0;
+            lcd->ac_cgram = false;
+            exec = EXEC_CLEAR_US;
+        } else if (value & 0x01) {
+            memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+            lcd->ac = 0;
+            lcd->ac_cgram = false;
+            lcd->increment = true;
+            exec = EXEC_CLEAR_US;
+        }
+    }
+    
+    lcd->busy_until_us = t_us + exec;
+}
+
+/**
+ * @brief EN falling edge with RW low: latch D7-D4
+ */
+static void lcd_latch(SIM_HD44780_t *lcd, uint8_t port, uint64_t t_us)
+{
+    uint8_t nibble = port & 0xF0;
+    bool rs = (port & PIN_RS) != 0;
+    
+    if (!lcd->four_bit) {
+        // 8-bit interface with D3-D0 pulled low by the backpack
+        lcd_execute(lcd, nibble, rs, t_us);
+        lcd->low_nibble = false;
+        return;
+    }
+    
+    if (!lcd->low_nibble) {
+        lcd->high_nibble = nibble;
+        lcd->low_nibble = true;
+    } else {
+        lcd->low_nibble = false;
+        lcd_execute(lcd, lcd->high_nibble | (nibble >> 4), rs, t_us);
+    }
+}
+
+static void lcd_i2c_write(void *ctx, uint8_t data, uint64_t t_us)
+{
+    SIM_HD44780_t *lcd = (SIM_HD44780_t *)ctx;
+    uint8_t prev = lcd->port;
+    
+    lcd->port = data;
+    
+    if (!lcd->rw_wired) {
+        lcd->port &= (uint8_t)~PIN_RW;
+        data &= (uint8_t)~PIN_RW;
+    }
+    
+    // RW must settle before EN rises; one expander write changes both at once
+    if (!(prev & PIN_EN) && (data & PIN_EN) && ((prev ^ data) & PIN_RW)) {
+        lcd->setup_violations++;
+    }
+    
+    if ((prev & PIN_EN) && !(data & PIN_EN)) {
+        if (data & PIN_RW) {
+            // End of a read cycle: the next EN pulse reads the other nibble
+            lcd->read_low_nibble = !lcd->read_low_nibble;
+        } else {
+            lcd->read_low_nibble = false;
+            lcd_latch(lcd, prev, t_us);
+        }
+    }
+}
+
+static bool lcd_i2c_read(void *ctx, uint8_t *data, uint64_t t_us)
+{
+    SIM_HD44780_t *lcd = (SIM_HD44780_t *)ctx;
+    uint8_t value = lcd->port;  // Quasi-bidirectional: reads back what was written
+    
+    // Controller drives D7-D4 while RW and EN are high (instruction read)
+    if ((lcd->port & (PIN_RW | PIN_EN)) == (PIN_RW | PIN_EN) && !(lcd->port & PIN_RS)) {
+        uint8_t status = lcd->ac & 0x7F;
+        if (t_us < lcd->busy_until_us) {
+            status |= 0x80;
+        }
+        uint8_t nibble = lcd->read_low_nibble ? (uint8_t)(status << 4) : (status & 0xF0);
+        value = (uint8_t)((value & 0x0F) | (nibble & (value & 0xF0)));
+    }
+    
+    *data = value;
+    return true;
+}
+
+void SIM_HD44780_Init(SIM_HD44780_t *lcd, uint8_t rows, uint8_t cols, bool rw_wired)
+{
+    memset(lcd, 0, sizeof(*lcd));
+    lcd->rows = rows;
+    lcd->cols = cols;
+    lcd->rw_wired = rw_wired;
+    lcd->increment = true;
+    lcd->two_line = true;
+    
+    // Power-on contents are undefined; fill with a visible marker
+    memset(lcd->ddram, '?', sizeof(lcd->ddram));
+}
+
+bool SIM_HD44780_Attach(SIM_HD44780_t *lcd, uint16_t addr)
+{
+    SIM_I2C_Device_t dev = {
+        .addr = addr,
+        .write = lcd_i2c_write,
+        .read = lcd_i2c_read,
+        .ctx = lcd,
+    };
+    return SIM_I2C_Attach(&dev);
+}
+
+/**
+ * @brief Copy the characters visible on one row (NUL terminated)
+ */
+void SIM_HD44780_GetRow(const SIM_HD44780_t *lcd, uint8_t row, char *out)
+{
+    for (uint8_t col = 0; col < lcd->cols; col++) {
+        out[col] = (char)lcd->ddram[(lcd_row_offset(lcd, row) + col) & 0x7F];
+    }
+    out[lcd->cols] = '\0';
+}
+
+bool SIM_HD44780_Backlight(const SIM_HD44780_t *lcd)
+{
+    return (lcd->port & PIN_BL) != 0;
+}
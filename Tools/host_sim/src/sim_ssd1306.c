@@ -0,0 +1,146 @@
+/**
+ * @file    sim_ssd1306.c
+ * @brief   SSD1306 OLED controller emulator
+ */
+
+#include "sim_ssd1306.h"
+#include <string.h>
+
+/**
+ * @brief Number of bytes (opcode included) of a command
+ */
+static uint8_t oled_cmd_length(uint8_t opcode)
+{
+    switch (opcode) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 2;
+        case 0x21: case 0x22:
+            return 3;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief Execute one complete command
+ */
+static void oled_execute(SIM_SSD1306_t *oled)
+{
+    uint8_t op = oled->cmd[0];
+    
+    oled->commands++;
+    
+    if (op == 0xAE || op == 0xAF) {
+        oled->display_on = (op == 0xAF);
+    } else if (op == 0x8D) {
+        oled->charge_pump = (oled->cmd[1] & 0x04) != 0;
+    } else if (op == 0x20) {
+        oled->addressing_mode = oled->cmd[1] & 0x03;
+    } else if (op == 0x21) {
+        oled->col_start = oled->cmd[1] & 0x7F;
+        oled->col_end = oled->cmd[2] & 0x7F;
+        oled->col = oled->col_start;
+    } else if (op == 0x22) {
+        oled->page_start = oled->cmd[1] & 0x07;
+        oled->page_end = oled->cmd[2] & 0x07;
+        oled->page = oled->page_start;
+    } else if (op >= 0xB0 && op <= 0xB7) {
+        oled->page = op & 0x07;                                 // Page mode
+    } else if (op <= 0x0F) {
+        oled->col = (uint8_t)((oled->col & 0xF0) | op);         // Page mode, low nibble
+    } else if (op >= 0x10 && op <= 0x1F) {
+        oled->col = (uint8_t)((oled->col & 0x0F) | ((op & 0x07) << 4));
+    }
+}
+
+/**
+ * @brief Store one data byte and advance the GDDRAM pointer
+ */
+static void oled_write_data(SIM_SSD1306_t *oled, uint8_t data)
+{
+    oled->gddram[oled->page][oled->col] = data;
+    oled->data_writes++;
+    
+    if (oled->addressing_mode == 2) {
+        if (oled->col < SIM_SSD1306_WIDTH - 1) {
+            oled->col++;
+        }
+        return;
+    }
+    
+    if (oled->addressing_mode == 0) {
+        if (oled->col < oled->col_end) {
+            oled->col++;
+        } else {
+            oled->col = oled->col_start;
+            oled->page = (oled->page < oled->page_end) ? oled->page + 1 : oled->page_start;
+        }
+    } else {
+        if (oled->page < oled->page_end) {
+            oled->page++;
+        } else {
+            oled->page = oled->page_start;
+            oled->col = (oled->col < oled->col_end) ? oled->col + 1 : oled->col_start;
+        }
+    }
+}
+
+static void oled_i2c_start(void *ctx)
+{
+    SIM_SSD1306_t *oled = (SIM_SSD1306_t *)ctx;
+    
+    oled->expect_control = true;
+    oled->cmd_len = 0;
+}
+
+static void oled_i2c_write(void *ctx, uint8_t data, uint64_t t_us)
+{
+    SIM_SSD1306_t *oled = (SIM_SSD1306_t *)ctx;
+    
+    (void)t_us;
+    
+    if (oled->expect_control) {
+        oled->data_stream = (data & 0x40) != 0;
+        oled->single_byte = (data & 0x80) != 0;
+        oled->expect_control = false;
+        return;
+    }
+    
+    if (oled->data_stream) {
+        oled_write_data(oled, data);
+    } else {
+        oled->cmd[oled->cmd_len++] = data;
+        if (oled->cmd_len >= oled_cmd_length(oled->cmd[0])) {
+            oled_execute(oled);
+            oled->cmd_len = 0;
+        }
+    }
+    
+    if (oled->single_byte) {
+        oled->expect_control = true;
+    }
+}
+
+void SIM_SSD1306_Init(SIM_SSD1306_t *oled)
+{
+    memset(oled, 0, sizeof(*oled));
+    oled->addressing_mode = 2;              // Reset default: page addressing
+    oled->col_end = SIM_SSD1306_WIDTH - 1;
+    oled->page_end = SIM_SSD1306_PAGES - 1;
+    
+    // Power-on GDDRAM content is random; fill with a visible pattern
+    memset(oled->gddram, 0xA5, sizeof(oled->gddram));
+}
+
+bool SIM_SSD1306_Attach(SIM_SSD1306_t *oled, uint16_t addr)
+{
+    SIM_I2C_Device_t dev = {
+        .addr = addr,
+        .start = oled_i2c_start,
+        .write = oled_i2c_write,
+        .read = NULL,
+        .ctx = oled,
+    };
+    return SIM_I2C_Attach(&dev);
+}
@@ -0,0 +1,542 @@
+/**
+ * @file    test_button.c
+ * @brief   Button debounce and event queue on the emulated GPIOA
+ *
+ * SysTick runs BSP_Button_Tick() and the EXTI vectors run
+ * BSP_Button_EXTI_IRQHandler() as on the target while the test drives
+ * the PA1-PA6 input levels (active low) and reads what
+ * MID_Button_GetEvent() gives. Covers debounce delay, contact bounce,
+ * glitches, edges collected while the main loop is blocked, all buttons
+ * changing in the same sample, event order across buttons, double click,
+ * hold, accelerated auto-repeat, a button held at init and, with BUTTON_USE_EXTI, one interrupt
+ * per bouncing edge, no stamps for muted lines sharing a vector and
+ * events timed from the edge rather than from the loop pass.
+ */
+
+#include "sim.h"
+#include "bsp_button.h"
+#include "mid_button.h"
+#include "bsp_time.h"
+#include <stdio.h>
+
+#define PIN(button)     (1U << (BUTTON_FIRST_PIN + (button)))
+
+static int failures = 0;
+static uint32_t exti_count = 0;
+static ButtonEventRecord_t last;    // Event taken by the last expect()
+
+void SysTick_Handler(void)
+{
+    BSP_Button_Tick();
+}
+
+#if BUTTON_USE_EXTI
+static void exti(void)
+{
+    exti_count++;
+    BSP_Button_EXTI_IRQHandler();
+}
+
+void EXTI1_IRQHandler(void) { exti(); }
+void EXTI2_IRQHandler(void) { exti(); }
+void EXTI3_IRQHandler(void) { exti(); }
+void EXTI4_IRQHandler(void) { exti(); }
+void EXTI9_5_IRQHandler(void) { exti(); }
+#endif
+
+static void press(Button_t button)
+{
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)PIN(button), false);
+}
+
+static void release(Button_t button)
+{
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)PIN(button), true);
+}
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Take the next queued event, it must be button/event
+ */
+static void expect(Button_t button, ButtonEvent_t event, const char *what)
+{
+    if (!MID_Button_GetEvent(&last)) {
+        last.button = BUTTON_COUNT;
+        last.event = BUTTON_EVENT_NONE;
+    }
+    if (last.button != button || last.event != event) {
+        printf("  got button %u event %u, want button %u event %u\n",
+               last.button, last.event, button, event);
+        check(false, what);
+    }
+}
+
+static void expect_none(const char *what)
+{
+    ButtonEventRecord_t event;
+    
+    check(!MID_Button_GetEvent(&event), what);
+}
+
+/**
+ * @brief Run the loop for ms, a pass every 10 ms; polled events are dated
+ *        by the pass that sees them
+ */
+static void run(uint32_t ms)
+{
+    for (uint32_t t = 0; t < ms; t += 10) {
+        HAL_Delay(10);
+        MID_Button_Update();
+    }
+}
+
+/**
+ * @brief Settle: release everything, empty the queue
+ */
+static void idle(void)
+{
+    ButtonEventRecord_t event;
+    
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)(BUTTON_MASK << BUTTON_FIRST_PIN), true);
+    HAL_Delay(DOUBLE_CLICK_MS + 100);
+    MID_Button_Update();
+    while (MID_Button_GetEvent(&event)) {
+    }
+    MID_Button_HadActivity();
+}
+
+/**
+ * @brief Clean press: accepted after 4 agreeing samples, not before
+ */
+static void test_delay(void)
+{
+    uint32_t start;
+    uint32_t seen = 0;
+    ButtonEventRecord_t event = {0};
+    
+    press(BUTTON_INC);
+    start = HAL_GetTick();
+    while (HAL_GetTick() - start < 50) {
+        HAL_Delay(1);
+        MID_Button_Update();
+        if (seen == 0 && MID_Button_GetEvent(&event)) {
+            seen = HAL_GetTick() - start;
+        }
+    }
+    printf("clean press accepted after %lu ms, dated +%ld ms\n",
+           (unsigned long)seen, (long)(event.time - start));
+    check(seen >= 3 * BUTTON_SAMPLE_MS && seen <= 4 * BUTTON_SAMPLE_MS + 1,
+          "press not accepted after 4 samples");
+    check(event.button == BUTTON_INC && event.event == BUTTON_EVENT_PRESSED, "press event");
+#if BUTTON_USE_EXTI
+    check(event.time - start <= 1, "press not dated from the edge");
+#else
+    check(event.time - start == seen, "press not dated from the pass");
+#endif
+    
+    release(BUTTON_INC);
+    HAL_Delay(50);
+    MID_Button_Update();
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "release not seen");
+    expect_none("extra event");
+}
+
+/**
+ * @brief Bouncing contact on press and release gives one edge each;
+ *        short glitches give none
+ */
+static void test_bounce(void)
+{
+    uint32_t exti_before = exti_count;
+    uint32_t start = HAL_GetTick();
+    uint32_t bounce_ms;
+    
+    for (int i = 0; i < 12; i++) {
+        if (i & 1) {
+            release(BUTTON_TIMER);
+        } else {
+            press(BUTTON_TIMER);
+        }
+        HAL_Delay(1 + (i % 3));
+        MID_Button_Update();
+    }
+    press(BUTTON_TIMER);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_TIMER, BUTTON_EVENT_PRESSED, "bouncy press not seen");
+    expect_none("bouncy press seen twice");
+    
+    for (int i = 0; i < 10; i++) {
+        if (i & 1) {
+            press(BUTTON_TIMER);
+        } else {
+            release(BUTTON_TIMER);
+        }
+        HAL_Delay(2);
+        MID_Button_Update();
+    }
+    release(BUTTON_TIMER);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_TIMER, BUTTON_EVENT_RELEASED, "bouncy release not seen");
+    expect_none("press during release bounce");
+    bounce_ms = HAL_GetTick() - start - 80;     // Less the two 40 ms settles
+#if BUTTON_USE_EXTI
+    printf("bouncy press and release: %lu interrupts for 24 edges in %lu ms\n",
+           (unsigned long)(exti_count - exti_before), (unsigned long)bounce_ms);
+    check(exti_count - exti_before <= bounce_ms / BUTTON_SAMPLE_MS + 2, "bounce not muted");
+#else
+    (void)exti_before;
+    (void)bounce_ms;
+#endif
+    
+    // 12 ms low: less than 4 samples
+    press(BUTTON_RESET);
+    HAL_Delay(12);
+    release(BUTTON_RESET);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect_none("glitch taken as an edge");
+    idle();
+}
+
+/**
+ * @brief Press and release while the main loop is stuck for 200 ms
+ */
+static void test_blocked(void)
+{
+    uint32_t down;
+    
+    press(BUTTON_AUTO);
+    HAL_Delay(60);
+    release(BUTTON_AUTO);
+    HAL_Delay(140);
+    MID_Button_Update();
+    check(MID_Button_HadActivity(), "no activity reported");
+    expect(BUTTON_AUTO, BUTTON_EVENT_PRESSED, "press lost while blocked");
+    down = last.time;
+    expect(BUTTON_AUTO, BUTTON_EVENT_RELEASED, "release lost while blocked");
+#if BUTTON_USE_EXTI
+    check(last.time - down >= 59 && last.time - down <= 61, "blocked press not timed from the edges");
+#else
+    check(last.time == down, "blocked press and release not in one pass");
+#endif
+    idle();
+}
+
+/**
+ * @brief All buttons pressed at once change in the same sample
+ */
+static void test_all(void)
+{
+    ButtonScan_t scan;
+    uint16_t pressed = 0;
+    uint32_t passes = 0;
+    
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)(BUTTON_MASK << BUTTON_FIRST_PIN), false);
+    while (pressed != BUTTON_MASK && passes++ < 50) {
+        HAL_Delay(1);
+        BSP_Button_Update(&scan);
+        check(scan.pressed == 0 || scan.pressed == BUTTON_MASK, "buttons split across samples");
+        check(scan.changed == (scan.pressed | scan.released), "changed mask");
+        pressed |= scan.pressed;
+    }
+    check(pressed == BUTTON_MASK && scan.state == BUTTON_MASK, "not all buttons pressed");
+    
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)(BUTTON_MASK << BUTTON_FIRST_PIN), true);
+    HAL_Delay(40);
+    BSP_Button_Update(&scan);
+    check(scan.released == BUTTON_MASK && scan.state == 0, "not all buttons released");
+    idle();
+}
+
+/**
+ * @brief Two buttons pressed 2 ms apart and seen in one pass: with EXTI
+ *        queued in the order pressed, without it in Button_t order
+ */
+static void test_order(void)
+{
+    uint32_t first;
+    
+    press(BUTTON_DEC);
+    HAL_Delay(2);
+    press(BUTTON_MANUAL);
+    HAL_Delay(40);
+    release(BUTTON_DEC);
+    HAL_Delay(40);
+    MID_Button_Update();
+#if BUTTON_USE_EXTI
+    expect(BUTTON_DEC, BUTTON_EVENT_PRESSED, "first press not first");
+    first = last.time;
+    expect(BUTTON_MANUAL, BUTTON_EVENT_PRESSED, "second press not second");
+    check(last.time - first >= 1 && last.time - first <= 3, "presses not 2 ms apart");
+#else
+    expect(BUTTON_MANUAL, BUTTON_EVENT_PRESSED, "same-pass presses not in button order");
+    first = last.time;
+    expect(BUTTON_DEC, BUTTON_EVENT_PRESSED, "same-pass presses not in button order");
+    check(last.time == first, "same-pass presses dated apart");
+#endif
+    expect(BUTTON_DEC, BUTTON_EVENT_RELEASED, "release not after the presses");
+    expect_none("extra event after order");
+    idle();
+}
+
+/**
+ * @brief One click within DOUBLE_CLICK_MS of another makes a double
+ *        click; a third click, a late click or one after a hold does not
+ */
+static void test_double(void)
+{
+    for (int n = 0; n < 3; n++) {
+        press(BUTTON_INC);
+        HAL_Delay(40);
+        release(BUTTON_INC);
+        HAL_Delay(100);
+        MID_Button_Update();
+    }
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "1st click press");
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "1st click release");
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "2nd click press");
+    expect(BUTTON_INC, BUTTON_EVENT_DOUBLE_CLICK, "double click not seen");
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "2nd click release");
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "3rd click press");
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "triple click taken as a double");
+    expect_none("extra event after clicks");
+    idle();
+    
+    // Too slow
+    press(BUTTON_INC);
+    HAL_Delay(40);
+    release(BUTTON_INC);
+    run(DOUBLE_CLICK_MS + 50);
+    press(BUTTON_INC);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "slow click press");
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "slow click release");
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "slow 2nd press");
+    expect_none("slow clicks taken as a double");
+    idle();
+}
+
+/**
+ * @brief Hold: reported once, HOLD_TIME_MS after the press; a quick press
+ *        after it is not a double click
+ */
+static void test_hold(void)
+{
+    uint32_t down;
+    
+    press(BUTTON_TIMER);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_TIMER, BUTTON_EVENT_PRESSED, "press before hold not seen");
+    down = last.time;
+    HAL_Delay(900);
+    MID_Button_Update();
+    expect_none("hold too early");
+    check(!MID_Button_IsHeld(BUTTON_TIMER), "held too early");
+    HAL_Delay(120);
+    MID_Button_Update();
+    expect(BUTTON_TIMER, BUTTON_EVENT_HOLD, "hold not seen");
+    check(last.time - down == HOLD_TIME_MS, "hold not dated from the press");
+    check(MID_Button_IsHeld(BUTTON_TIMER), "not held");
+    check(!MID_Button_IsHeld(BUTTON_INC), "hold on an idle button");
+    HAL_Delay(1500);
+    MID_Button_Update();
+    expect_none("hold reported twice");
+    
+    release(BUTTON_TIMER);
+    HAL_Delay(40);
+    press(BUTTON_TIMER);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_TIMER, BUTTON_EVENT_RELEASED, "release after hold");
+    expect(BUTTON_TIMER, BUTTON_EVENT_PRESSED, "press after hold");
+    expect_none("hold taken as a click");
+    check(!MID_Button_IsHeld(BUTTON_TIMER), "hold kept over a new press");
+    idle();
+}
+
+/**
+ * @brief INC held 5 s: repeats from the hold on, slow, fast, then by 10;
+ *        with 100 ms passes in the fast stretch two repeats come as one
+ *        event
+ */
+static void test_repeat(void)
+{
+    ButtonEventRecord_t event;
+    uint32_t start;
+    uint32_t first = 0;
+    uint32_t steps[3] = {0};    // Slow, fast, tens
+    uint32_t events = 0;
+    uint32_t fast_events = 0;
+    
+    press(BUTTON_INC);
+    start = HAL_GetTick();
+    while (HAL_GetTick() - start < HOLD_TIME_MS + 4000) {
+        uint32_t held = HAL_GetTick() - start;
+        
+        HAL_Delay(held >= HOLD_TIME_MS + REPEAT_FAST_AFTER_MS &&
+                  held < HOLD_TIME_MS + REPEAT_TENS_AFTER_MS ? 100 : 10);
+        MID_Button_Update();
+        while (MID_Button_GetEvent(&event)) {
+            uint32_t at = event.time - start;
+            
+            if (event.event != BUTTON_EVENT_REPEAT) {
+                continue;
+            }
+            check(event.button == BUTTON_INC, "repeat on the wrong button");
+            if (events++ == 0) {
+                first = at;
+            }
+            if (at < HOLD_TIME_MS + REPEAT_FAST_AFTER_MS) {
+                steps[0] += event.step;
+            } else if (at < HOLD_TIME_MS + REPEAT_TENS_AFTER_MS) {
+                steps[1] += event.step;
+                fast_events++;
+            } else {
+                steps[2] += event.step;
+                if (at >= HOLD_TIME_MS + REPEAT_TENS_AFTER_MS + REPEAT_SLOW_MS) {
+                    check(event.step == 10, "late repeat not by 10");
+                }
+            }
+        }
+    }
+    printf("repeat from %lu ms: %lu slow, %lu fast, %lu by tens in %lu events\n",
+           (unsigned long)first, (unsigned long)steps[0], (unsigned long)steps[1],
+           (unsigned long)steps[2], (unsigned long)events);
+    check(first >= HOLD_TIME_MS && first <= HOLD_TIME_MS + 25, "repeat not from the hold");
+    check(steps[0] == REPEAT_FAST_AFTER_MS / REPEAT_SLOW_MS, "slow repeats");
+    check(steps[0] + steps[1] + steps[2] >= 95 && steps[0] + steps[1] + steps[2] <= 105,
+          "5 slow, 40 fast and 5-6 by 10");
+    check(fast_events <= steps[1] / 2 + 1, "fast repeats not folded per pass");
+    
+    release(BUTTON_INC);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "release after repeat");
+    HAL_Delay(500);
+    MID_Button_Update();
+    expect_none("repeat after release");
+    
+    // Not a repeating button
+    press(BUTTON_RESET);
+    run(HOLD_TIME_MS + 1000);
+    expect(BUTTON_RESET, BUTTON_EVENT_PRESSED, "RESET press");
+    expect(BUTTON_RESET, BUTTON_EVENT_HOLD, "RESET hold");
+    expect_none("RESET repeats");
+    idle();
+}
+
+/**
+ * @brief Press during a 300 ms loop stall: with EXTI the hold is timed
+ *        from the edge, without it from the pass that saw the press
+ */
+static void test_stall(void)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t held_at = 0;
+    
+    MID_Button_Update();
+    press(BUTTON_INC);
+    HAL_Delay(300);
+    while (HAL_GetTick() - start < 2000 && held_at == 0) {
+        MID_Button_Update();
+        if (MID_Button_IsHeld(BUTTON_INC)) {
+            held_at = HAL_GetTick() - start;
+        }
+        HAL_Delay(10);
+    }
+    printf("hold after a 300 ms stall flagged at %lu ms\n", (unsigned long)held_at);
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "press after stall");
+    expect(BUTTON_INC, BUTTON_EVENT_HOLD, "hold after stall");
+#if BUTTON_USE_EXTI
+    check(held_at >= 1000 && held_at <= 1015, "hold not timed from the edge");
+    check(last.time - start <= HOLD_TIME_MS + 1, "hold event not dated from the edge");
+#else
+    check(held_at >= 1300 && held_at <= 1315, "hold not timed from the pass");
+#endif
+    idle();
+}
+
+/**
+ * @brief A muted line bouncing is not stamped by an interrupt of a line
+ *        sharing its vector (INC and DEC both raise EXTI9_5)
+ */
+static void test_shared(void)
+{
+#if BUTTON_USE_EXTI
+    uint32_t start = HAL_GetTick();
+    
+    // Bounce within one SysTick, so the line is still muted
+    press(BUTTON_INC);
+    SIM_Advance_Us(200);
+    release(BUTTON_INC);
+    SIM_Advance_Us(100);
+    press(BUTTON_INC);
+    HAL_Delay(3);
+    press(BUTTON_DEC);
+    HAL_Delay(40);
+    MID_Button_Update();
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "shared vector: INC press");
+    check(last.time - start <= 1, "muted INC bounce stamped by the DEC interrupt");
+    expect(BUTTON_DEC, BUTTON_EVENT_PRESSED, "shared vector: DEC press");
+    idle();
+#endif
+}
+
+/**
+ * @brief A button down at init gives no press, so no hold, repeat or
+ *        double click either
+ */
+static void test_boot_held(void)
+{
+    press(BUTTON_INC);
+    HAL_Delay(40);
+    MID_Button_Init();
+    run(HOLD_TIME_MS + REPEAT_FAST_AFTER_MS + 500);
+    expect_none("hold or repeat for a button held at init");
+    check(!MID_Button_IsHeld(BUTTON_INC), "button held at init reported held");
+    
+    release(BUTTON_INC);
+    run(40);
+    expect(BUTTON_INC, BUTTON_EVENT_RELEASED, "release of a button held at init");
+    press(BUTTON_INC);
+    run(40);
+    expect(BUTTON_INC, BUTTON_EVENT_PRESSED, "press after a button held at init");
+    expect_none("release of a button held at init taken as a click");
+    idle();
+}
+
+int main(void)
+{
+    SIM_Reset();
+    BSP_Time_Init();
+    MID_Button_Init();
+    
+    printf("Button test: %s, %d ms samples\n",
+           BUTTON_USE_EXTI ? "EXTI edges" : "polled", BUTTON_SAMPLE_MS);
+    
+    test_delay();
+    test_bounce();
+    test_shared();
+    test_blocked();
+    test_all();
+    test_order();
+    test_double();
+    test_hold();
+    test_repeat();
+    test_stall();
+    test_boot_held();
+    
+    printf("\n%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
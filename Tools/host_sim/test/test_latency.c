@@ -0,0 +1,225 @@
+/**
+ * @file    test_latency.c
+ * @brief   Press-to-display latency on the emulated buttons and LCD
+ *
+ * A 10 ms main loop wired like APP_Irrigation_Run() turns INC presses into
+ * a new SET TIME screen on the emulated PCF8574 + HD44780, while the test
+ * drives PA5/PA4. Each sample must cover the debounce, the wait for the
+ * next display frame and the I2C transfer, and no more; a press that does
+ * not change the screen gives no sample, and a sample closed late is
+ * still timed by its own commit. The statistics are read with the shell
+ * "latency" command over the emulated USART1.
+ */
+
+#include "sim.h"
+#include "sim_hd44780.h"
+#include "bsp_button.h"
+#include "bsp_time.h"
+#include "bsp_uart.h"
+#include "mid_button.h"
+#include "mid_display.h"
+#include "mid_latency.h"
+#include "mid_shell.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PIN(button)     (1U << (BUTTON_FIRST_PIN + (button)))
+#define PRESSES         8
+
+static SIM_HD44780_t lcd;
+static I2C_HandleTypeDef hi2c2;
+static UART_HandleTypeDef huart1;
+static int failures = 0;
+
+static char tx_text[1024];
+static size_t tx_len = 0;
+
+static DisplayModel_t model = {.mode = DISPLAY_MODE_TIMER_SET_TIME};
+
+/* SysTick as wired in stm32f1xx_it.c */
+void SysTick_Handler(void)
+{
+    BSP_LCD_Tick();
+    BSP_Button_Tick();
+}
+
+#if BUTTON_USE_EXTI
+void EXTI1_IRQHandler(void) { BSP_Button_EXTI_IRQHandler(); }
+void EXTI2_IRQHandler(void) { BSP_Button_EXTI_IRQHandler(); }
+void EXTI3_IRQHandler(void) { BSP_Button_EXTI_IRQHandler(); }
+void EXTI4_IRQHandler(void) { BSP_Button_EXTI_IRQHandler(); }
+void EXTI9_5_IRQHandler(void) { BSP_Button_EXTI_IRQHandler(); }
+#endif
+
+static void tx_sink(void *ctx, const uint8_t *data, uint16_t len)
+{
+    (void)ctx;
+    if (tx_len + len < sizeof(tx_text)) {
+        memcpy(&tx_text[tx_len], data, len);
+        tx_len += len;
+        tx_text[tx_len] = '\0';
+    }
+}
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Main loop passes for ms: one button event, publish, render
+ */
+static void run_loop(uint32_t ms)
+{
+    uint32_t start = HAL_GetTick();
+    
+    while (HAL_GetTick() - start < ms) {
+        ButtonEventRecord_t event = {0};
+        
+        MID_Button_Update();
+        MID_Shell_Process();
+        if (MID_Button_GetEvent(&event) && event.event == BUTTON_EVENT_PRESSED &&
+            event.button == BUTTON_INC) {
+            model.time.minutes = (uint8_t)((model.time.minutes + 1) % 60);
+        }
+        if (MID_Display_Publish(&model) && event.event == BUTTON_EVENT_PRESSED) {
+            MID_Latency_Start((Button_t)event.button, event.cycles);
+        }
+        MID_Display_Process();
+        MID_Latency_Process();
+        HAL_Delay(10);
+    }
+}
+
+static void click(Button_t button)
+{
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)PIN(button), false);
+    run_loop(60);
+    SIM_GPIO_SetInput(GPIOA, (uint16_t)PIN(button), true);
+    run_loop(340);
+}
+
+/**
+ * @brief Run a shell command and return everything it printed
+ */
+static const char *shell(const char *input)
+{
+    tx_len = 0;
+    tx_text[0] = '\0';
+    SIM_UART_Inject((const uint8_t *)input, (uint16_t)strlen(input));
+    run_loop(200);
+    BSP_UART_Flush();
+    SIM_Advance_Us(SIM_UART_BYTE_US(UART_TX_CHUNK));
+    return tx_text;
+}
+
+/**
+ * @brief INC presses change the screen: one sample each, bounded by
+ *        debounce + one frame + loop pass + transfer
+ */
+static void test_presses(void)
+{
+    LatencyStats_t stats;
+    uint32_t binned = 0;
+    uint32_t max_us = (4 * BUTTON_SAMPLE_MS + DISPLAY_FRAME_MS + 2 * 10 + 20) * 1000U;
+    char row[LCD_COLS + 1];
+    
+    for (int i = 0; i < PRESSES; i++) {
+        click(BUTTON_INC);
+    }
+    MID_Latency_Get(BUTTON_INC, &stats);
+    for (int k = 0; k < LATENCY_BUCKETS; k++) {
+        binned += stats.histogram[k];
+    }
+    printf("inc: %lu samples, min %lu us, avg %lu us, max %lu us\n",
+           (unsigned long)stats.count, (unsigned long)stats.min_us,
+           (unsigned long)stats.avg_us, (unsigned long)stats.max_us);
+    
+    check(stats.count == PRESSES, "one sample per press");
+    check(binned == PRESSES, "histogram total");
+    check(stats.min_us >= 3 * BUTTON_SAMPLE_MS * 1000U || !BUTTON_USE_EXTI,
+          "sample shorter than the debounce");
+    check(stats.max_us <= max_us, "sample longer than debounce, frame and transfer");
+    check(stats.min_us <= stats.avg_us && stats.avg_us <= stats.max_us, "min/avg/max");
+    
+    SIM_HD44780_GetRow(&lcd, 1, row);
+    check(strstr(row, "00:08:00") != NULL, "screen shows the presses");
+    
+    // No screen change, no sample
+    click(BUTTON_RESET);
+    MID_Latency_Get(BUTTON_RESET, &stats);
+    check(stats.count == 0, "sample for a press that changed nothing");
+}
+
+/**
+ * @brief Read the statistics over the shell, then clear them
+ */
+static void test_shell(void)
+{
+    const char *text = shell("latency\n");
+    
+    printf("%s", text);
+    check(strstr(text, "inc n=8 min=") != NULL, "inc statistics line");
+    check(strstr(text, "inc hist ") != NULL, "inc histogram line");
+    check(strstr(text, "reset") == NULL, "button without samples reported");
+    check(strstr(text, "latency=8\r\n") != NULL, "latency total");
+    
+    check(strcmp(shell("latency clear\n"), "latency=0\r\n") == 0, "latency clear");
+    check(strcmp(shell("latency\n"), "latency=0\r\n") == 0, "statistics not cleared");
+}
+
+/**
+ * @brief A sample closed late, after more commits went out, is charged
+ *        the commit that showed the press, not the latest one
+ */
+static void test_late(void)
+{
+    LatencyStats_t stats;
+    uint32_t max_us = 20 * 1000U;   // Frame due: the transfer only
+    
+    HAL_Delay(DISPLAY_FRAME_MS);
+    model.time.minutes = (uint8_t)((model.time.minutes + 1) % 60);
+    MID_Display_Publish(&model);
+    MID_Latency_Start(BUTTON_DEC, BSP_Time_Cycles());
+    
+    // Keep changing the screen for 3 more frames without closing the sample
+    for (int i = 0; i < 3 * DISPLAY_FRAME_MS / 10; i++) {
+        MID_Display_Process();
+        HAL_Delay(10);
+        model.time.minutes = (uint8_t)((model.time.minutes + 1) % 60);
+        MID_Display_Publish(&model);
+    }
+    MID_Latency_Process();
+    
+    MID_Latency_Get(BUTTON_DEC, &stats);
+    printf("dec, closed 3 frames late: %lu us\n", (unsigned long)stats.max_us);
+    check(stats.count == 1, "late sample not closed");
+    check(stats.max_us <= max_us, "late sample charged a later commit");
+}
+
+int main(void)
+{
+    SIM_Reset();
+    SIM_HD44780_Init(&lcd, LCD_ROWS, LCD_COLS, false);
+    SIM_HD44780_Attach(&lcd, LCD_I2C_ADDR);
+    SIM_UART_SetSink(tx_sink, NULL);
+    BSP_Time_Init();
+    BSP_UART_Init(&huart1);
+    MID_Shell_Init();
+    MID_Button_Init();
+    MID_Display_Init(&hi2c2);
+    MID_Latency_Init();
+    
+    printf("Latency test: %s buttons, %d ms frames\n",
+           BUTTON_USE_EXTI ? "EXTI" : "polled", DISPLAY_FRAME_MS);
+    
+    test_presses();
+    test_shell();
+    test_late();
+    
+    printf("\n%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,426 @@
+/**
+ * @file    test_modbus.c
+ * @brief   Modbus RTU slave on the emulated USART1 and TIM2, over a pty
+ *
+ * The test is the master. Requests are written to the slave side of a
+ * pty in raw mode; the master side feeds the simulated USART1 receive
+ * line, and the simulated TX DMA writes replies back into it. A 10 ms
+ * main loop calls MID_Modbus_Process(), as the application does.
+ *
+ * Covers functions 03/04/06/16, the exception replies, broadcast, frames
+ * for other slaves, CRC errors and a silence inside a frame (injected
+ * directly, a pty does not keep byte timing), then a master polling back
+ * to back: the loop must keep its rate and every request be answered.
+ */
+
+#define _GNU_SOURCE             // posix_openpt(), cfmakeraw()
+
+#include "sim.h"
+#include "bsp_uart.h"
+#include "bsp_modbus.h"
+#include "mid_param.h"
+#include "mid_modbus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define SLAVE_ADDRESS           17
+#define PTY_TIMEOUT_MS          20      // Real time: sim output is already queued
+#define BYTE_US                 (10U * 1000000U / MODBUS_BAUD)
+
+static UART_HandleTypeDef huart1;
+static int failures = 0;
+static int pty_master = -1;             // Firmware side
+static int pty_slave = -1;              // Master (test) side
+static uint32_t loop_passes = 0;
+
+/* Holding registers (parameter table) */
+static uint8_t low = 40;
+static uint8_t high = 50;
+static uint16_t dry = 3800;
+
+/* Input registers */
+typedef enum { MODE_A = 0, MODE_B, MODE_C } Mode_t;
+static Mode_t mode = MODE_C;
+static uint8_t percent = 42;
+static int16_t temperature = -55;
+static uint16_t raw = 2345;
+
+static bool check_low(uint16_t value)
+{
+    return value < high;
+}
+
+static bool check_high(uint16_t value)
+{
+    return value > low;
+}
+
+static uint16_t read_raw(void)
+{
+    return raw;
+}
+
+static const Param_t params[] = {
+    {"low",  &low,  PARAM_U8,  0, 100,  check_low},
+    {"high", &high, PARAM_U8,  0, 100,  check_high},
+    {"dry",  &dry,  PARAM_U16, 0, 4095, NULL},
+};
+
+static const ModbusInput_t inputs[] = {
+    MODBUS_INPUT(mode),
+    MODBUS_INPUT(percent),
+    MODBUS_INPUT(temperature),
+    MODBUS_INPUT_FN(read_raw),
+};
+
+/* Not used, the sim needs one */
+void SysTick_Handler(void)
+{
+}
+
+void TIM2_IRQHandler(void)
+{
+    BSP_Modbus_TIM_IRQHandler();
+}
+
+/**
+ * @brief Simulated TX DMA output goes back into the pty
+ */
+static void tx_sink(void *ctx, const uint8_t *data, uint16_t len)
+{
+    (void)ctx;
+    if (write(pty_master, data, len) != len) {
+        printf("FAIL pty write\n");
+        failures++;
+    }
+}
+
+/**
+ * @brief Bitwise CRC-16/MODBUS, independent of the firmware's table
+ */
+static uint16_t crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint16_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 1U) ? (uint16_t)((crc >> 1) ^ 0xA001U) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t append_crc(uint8_t *frame, uint16_t len)
+{
+    uint16_t crc = crc16(frame, len);
+
+    frame[len] = (uint8_t)(crc & 0xFF);
+    frame[len + 1] = (uint8_t)(crc >> 8);
+    return (uint16_t)(len + 2U);
+}
+
+/**
+ * @brief Main loop: Modbus poll plus the 10 ms delay, for ms of time
+ */
+static void run_loop(uint32_t ms)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (HAL_GetTick() - start < ms) {
+        MID_Modbus_Process();
+        HAL_Delay(10);
+        loop_passes++;
+    }
+}
+
+/**
+ * @brief Move whatever the master wrote into the simulated RX line
+ * @return Bytes moved
+ */
+static uint16_t pump_pty(int timeout_ms)
+{
+    struct pollfd pfd = {pty_master, POLLIN, 0};
+    uint8_t buf[256];
+    uint16_t total = 0;
+    ssize_t n;
+
+    while (poll(&pfd, 1, timeout_ms) > 0 && (n = read(pty_master, buf, sizeof(buf))) > 0) {
+        SIM_UART_Inject(buf, (uint16_t)n);
+        total = (uint16_t)(total + n);
+        timeout_ms = 10;
+    }
+    return total;
+}
+
+/**
+ * @brief Collect the reply from the pty until it goes quiet
+ */
+static uint16_t read_reply(uint8_t *reply, uint16_t max)
+{
+    struct pollfd pfd = {pty_slave, POLLIN, 0};
+    uint16_t len = 0;
+    ssize_t n;
+
+    while (len < max && poll(&pfd, 1, PTY_TIMEOUT_MS) > 0 &&
+           (n = read(pty_slave, &reply[len], max - len)) > 0) {
+        len = (uint16_t)(len + n);
+    }
+    return len;
+}
+
+/**
+ * @brief One request over the pty
+ * @param pdu Address and PDU, CRC appended here
+ * @param sim_ms Simulated time to let the slave answer
+ * @return Reply length with CRC, 0 if none; the CRC is checked
+ */
+static uint16_t transact(const uint8_t *pdu, uint16_t len, uint8_t *reply, uint16_t max,
+                         uint32_t sim_ms)
+{
+    uint8_t request[MODBUS_FRAME_MAX];
+    uint16_t got;
+
+    memcpy(request, pdu, len);
+    len = append_crc(request, len);
+    if (write(pty_slave, request, len) != len) {
+        printf("FAIL pty write\n");
+        failures++;
+        return 0;
+    }
+
+    pump_pty(PTY_TIMEOUT_MS);
+    run_loop(sim_ms);
+    got = read_reply(reply, max);
+
+    if (got > 0 && (got < 4 || crc16(reply, got) != 0)) {
+        printf("FAIL reply to function %02X: bad CRC (%u bytes)\n", pdu[1], got);
+        failures++;
+    }
+    return got;
+}
+
+/**
+ * @brief Send a request and compare the reply (without CRC)
+ */
+static void expect(const char *what, const uint8_t *pdu, uint16_t len,
+                   const uint8_t *want, uint16_t want_len)
+{
+    uint8_t reply[MODBUS_FRAME_MAX];
+    // Request, silence, handling and a full-size reply at the slowest baud
+    uint16_t got = transact(pdu, len, reply, sizeof(reply), 200);
+    uint16_t body = (got >= 2) ? (uint16_t)(got - 2U) : 0;
+
+    if (body != want_len || memcmp(reply, want, want_len) != 0) {
+        printf("FAIL %s: got", what);
+        for (uint16_t i = 0; i < body; i++) {
+            printf(" %02X", reply[i]);
+        }
+        printf(", expected");
+        for (uint16_t i = 0; i < want_len; i++) {
+            printf(" %02X", want[i]);
+        }
+        printf("\n");
+        failures++;
+    }
+}
+
+#define EXPECT(what, pdu, want) \
+    expect(what, pdu, sizeof(pdu), want, sizeof(want))
+
+static void test_functions(void)
+{
+    static const uint8_t rd_hold[] = {SLAVE_ADDRESS, 0x03, 0x00, 0x00, 0x00, 0x03};
+    static const uint8_t rd_hold_ok[] = {SLAVE_ADDRESS, 0x03, 6, 0, 40, 0, 50, 0x0E, 0xD8};
+    static const uint8_t rd_in[] = {SLAVE_ADDRESS, 0x04, 0x00, 0x00, 0x00, 0x04};
+    static const uint8_t rd_in_ok[] = {SLAVE_ADDRESS, 0x04, 8, 0, 2, 0, 42, 0xFF, 0xC9, 0x09, 0x29};
+    static const uint8_t wr_low[] = {SLAVE_ADDRESS, 0x06, 0x00, 0x00, 0x00, 30};
+    static const uint8_t wr_low_bad[] = {SLAVE_ADDRESS, 0x06, 0x00, 0x00, 0x00, 60};
+    static const uint8_t wr_low_bad_ex[] = {SLAVE_ADDRESS, 0x86, MODBUS_EX_VALUE};
+    static const uint8_t wr_far[] = {SLAVE_ADDRESS, 0x06, 0x00, 0x63, 0x00, 0x01};
+    static const uint8_t wr_far_ex[] = {SLAVE_ADDRESS, 0x86, MODBUS_EX_ADDRESS};
+    static const uint8_t wr_multi[] = {SLAVE_ADDRESS, 0x10, 0x00, 0x00, 0x00, 0x02, 4,
+                                       0, 70, 0, 80};
+    static const uint8_t wr_multi_ok[] = {SLAVE_ADDRESS, 0x10, 0x00, 0x00, 0x00, 0x02};
+    static const uint8_t wr_multi_rule[] = {SLAVE_ADDRESS, 0x10, 0x00, 0x00, 0x00, 0x02, 4,
+                                            0, 20, 0, 10};
+    static const uint8_t wr_multi_range[] = {SLAVE_ADDRESS, 0x10, 0x00, 0x01, 0x00, 0x02, 4,
+                                             0, 90, 0x10, 0x00};
+    static const uint8_t wr_multi_ex[] = {SLAVE_ADDRESS, 0x90, MODBUS_EX_VALUE};
+    static const uint8_t wr_multi_short[] = {SLAVE_ADDRESS, 0x10, 0x00, 0x00, 0x00, 0x02, 2,
+                                             0, 70};
+    static const uint8_t rd_zero[] = {SLAVE_ADDRESS, 0x03, 0x00, 0x00, 0x00, 0x00};
+    static const uint8_t rd_zero_ex[] = {SLAVE_ADDRESS, 0x83, MODBUS_EX_VALUE};
+    static const uint8_t rd_past[] = {SLAVE_ADDRESS, 0x04, 0x00, 0x02, 0x00, 0x03};
+    static const uint8_t rd_past_ex[] = {SLAVE_ADDRESS, 0x84, MODBUS_EX_ADDRESS};
+    static const uint8_t coils[] = {SLAVE_ADDRESS, 0x01, 0x00, 0x00, 0x00, 0x08};
+    static const uint8_t coils_ex[] = {SLAVE_ADDRESS, 0x81, MODBUS_EX_FUNCTION};
+    static const uint8_t rd_after[] = {SLAVE_ADDRESS, 0x03, 0x00, 0x00, 0x00, 0x02};
+    static const uint8_t rd_after_ok[] = {SLAVE_ADDRESS, 0x03, 4, 0, 70, 0, 80};
+
+    EXPECT("read holding", rd_hold, rd_hold_ok);
+    EXPECT("read input", rd_in, rd_in_ok);
+    EXPECT("write single", wr_low, wr_low);
+    EXPECT("write single, rule", wr_low_bad, wr_low_bad_ex);
+    EXPECT("write single, address", wr_far, wr_far_ex);
+    // low=70 alone would break low < high: the pair is checked as a whole
+    EXPECT("write multiple", wr_multi, wr_multi_ok);
+    EXPECT("write multiple, rule", wr_multi_rule, wr_multi_ex);
+    EXPECT("write multiple, range", wr_multi_range, wr_multi_ex);
+    EXPECT("write multiple, byte count", wr_multi_short, wr_multi_ex);
+    EXPECT("read count 0", rd_zero, rd_zero_ex);
+    EXPECT("read past the map", rd_past, rd_past_ex);
+    EXPECT("unsupported function", coils, coils_ex);
+    EXPECT("read back", rd_after, rd_after_ok);
+
+    if (low != 70 || high != 80 || dry != 0x0ED8) {
+        printf("FAIL live variables: low=%u high=%u dry=%u\n", low, high, dry);
+        failures++;
+    }
+}
+
+/**
+ * @brief Frames that must get no reply
+ */
+static void test_silent(void)
+{
+    static const uint8_t other[] = {SLAVE_ADDRESS + 1, 0x03, 0x00, 0x00, 0x00, 0x01};
+    static const uint8_t broadcast[] = {0x00, 0x06, 0x00, 0x02, 0x01, 0x00};
+    uint8_t frame[16];
+    uint8_t reply[MODBUS_FRAME_MAX];
+    uint16_t len;
+    Modbus_Stats_t before;
+    Modbus_Stats_t after;
+
+    BSP_Modbus_GetStats(&before);
+
+    if (transact(other, sizeof(other), reply, sizeof(reply), 100) != 0) {
+        printf("FAIL answered a frame for another slave\n");
+        failures++;
+    }
+    if (transact(broadcast, sizeof(broadcast), reply, sizeof(reply), 100) != 0 ||
+        dry != 0x0100) {
+        printf("FAIL broadcast: reply sent or not applied (dry=%u)\n", dry);
+        failures++;
+    }
+
+    // Corrupted CRC
+    memcpy(frame, other, sizeof(other));
+    frame[0] = SLAVE_ADDRESS;
+    len = append_crc(frame, sizeof(other));
+    frame[len - 1] ^= 0x01;
+    SIM_UART_Inject(frame, len);
+    run_loop(50);
+
+    // 1.5 < silence < 3.5 characters in the middle of a good frame
+    len = append_crc(frame, sizeof(other));
+    SIM_UART_Inject(frame, 3);
+    SIM_Advance_Us(3U * BYTE_US + 1200U);
+    SIM_UART_Inject(&frame[3], (uint16_t)(len - 3U));
+    run_loop(50);
+
+    if (read_reply(reply, sizeof(reply)) != 0) {
+        printf("FAIL answered a damaged frame\n");
+        failures++;
+    }
+
+    BSP_Modbus_GetStats(&after);
+    if (after.ignored - before.ignored != 1 || after.crc_errors - before.crc_errors != 1 ||
+        after.frame_errors - before.frame_errors != 1 || after.frames - before.frames != 1) {
+        printf("FAIL counters: %lu ignored, %lu CRC, %lu framing, %lu frames\n",
+               (unsigned long)(after.ignored - before.ignored),
+               (unsigned long)(after.crc_errors - before.crc_errors),
+               (unsigned long)(after.frame_errors - before.frame_errors),
+               (unsigned long)(after.frames - before.frames));
+        failures++;
+    }
+}
+
+/**
+ * @brief Master polling all input registers back to back for a while
+ */
+static void test_polling(void)
+{
+    static const uint8_t poll_req[] = {SLAVE_ADDRESS, 0x04, 0x00, 0x00, 0x00, 0x04};
+    uint8_t reply[MODBUS_FRAME_MAX];
+    uint32_t start_ms = HAL_GetTick();
+    uint32_t start_passes = loop_passes;
+    uint32_t answered = 0;
+    uint32_t elapsed;
+    uint32_t passes;
+
+    for (uint16_t i = 0; i < 50; i++) {
+        percent = (uint8_t)i;
+        // About the shortest cycle at 19200: 5 ms request, 2 ms silence, 7 ms reply
+        if (transact(poll_req, sizeof(poll_req), reply, sizeof(reply), 40) == 13 &&
+            reply[6] == i) {
+            answered++;
+        }
+    }
+
+    elapsed = HAL_GetTick() - start_ms;
+    passes = loop_passes - start_passes;
+    printf("polling: %lu/50 answered, %lu loop passes in %lu ms\n",
+           (unsigned long)answered, (unsigned long)passes, (unsigned long)elapsed);
+
+    if (answered != 50) {
+        printf("FAIL %lu requests unanswered\n", (unsigned long)(50 - answered));
+        failures++;
+    }
+    // HAL_Delay(10) takes 11 ms; Modbus must not slow the loop down
+    if (passes < elapsed / 11U - 1U) {
+        printf("FAIL loop slowed to %lu passes\n", (unsigned long)passes);
+        failures++;
+    }
+}
+
+/**
+ * @brief Raw pty pair: master side for the firmware, slave side for us
+ */
+static bool open_pty(void)
+{
+    struct termios tio;
+
+    pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty_master < 0 || grantpt(pty_master) != 0 || unlockpt(pty_master) != 0) {
+        return false;
+    }
+    pty_slave = open(ptsname(pty_master), O_RDWR | O_NOCTTY);
+    if (pty_slave < 0 || tcgetattr(pty_slave, &tio) != 0) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    return tcsetattr(pty_slave, TCSANOW, &tio) == 0;
+}
+
+int main(void)
+{
+    if (!open_pty()) {
+        printf("FAIL could not open a pty\n");
+        return 1;
+    }
+
+    SIM_Reset();
+    SIM_UART_SetSink(tx_sink, NULL);
+    BSP_Modbus_Init(&huart1, SLAVE_ADDRESS);
+    MID_Param_Register(params, sizeof(params) / sizeof(params[0]));
+    MID_Modbus_Init(inputs, sizeof(inputs) / sizeof(inputs[0]));
+
+    printf("Modbus test: %u baud, slave %u, pty %s\n",
+           (unsigned)MODBUS_BAUD, SLAVE_ADDRESS, ptsname(pty_master));
+
+    test_functions();
+    test_silent();
+    test_polling();
+
+    close(pty_slave);
+    close(pty_master);
+
+    printf("\n%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file    test_shell.c
+ * @brief   UART command shell on the emulated USART1
+ *
+ * Commands are injected at 115200 baud while a 10 ms main loop calls
+ * MID_Shell_Process(); replies are taken from the simulated TX DMA.
+ * Covers get/set/list, range and rule checks, line editing, a flood
+ * of input that must cost each loop pass a bounded slice and leave the
+ * shell usable afterwards, and an event journal dump larger than the TX
+ * ring that must arrive complete.
+ */
+
+#include "sim.h"
+#include "bsp_uart.h"
+#include "mid_param.h"
+#include "mid_shell.h"
+#include "mid_journal.h"
+#include <stdio.h>
+#include <string.h>
+
+static UART_HandleTypeDef huart1;
+static int failures = 0;
+
+static char tx_text[4096];
+static size_t tx_len = 0;
+
+static uint8_t low = 40;
+static uint8_t high = 50;
+static uint16_t dry = 3800;
+
+static bool check_low(uint16_t value)
+{
+    return value < high;
+}
+
+static const Param_t params[] = {
+    {"low",  &low,  PARAM_U8,  0, 100,  check_low},
+    {"high", &high, PARAM_U8,  0, 100,  NULL},
+    {"dry",  &dry,  PARAM_U16, 0, 4095, NULL},
+};
+
+/* Not used, the sim needs one */
+void SysTick_Handler(void)
+{
+}
+
+static void tx_sink(void *ctx, const uint8_t *data, uint16_t len)
+{
+    (void)ctx;
+    if (tx_len + len < sizeof(tx_text)) {
+        memcpy(&tx_text[tx_len], data, len);
+        tx_len += len;
+        tx_text[tx_len] = '\0';
+    }
+}
+
+/**
+ * @brief Main loop: shell poll plus the 10 ms delay, for ms of time
+ * @return Loop passes run
+ */
+static uint32_t run_loop(uint32_t ms)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t passes = 0;
+    
+    while (HAL_GetTick() - start < ms) {
+        MID_Shell_Process();
+        HAL_Delay(10);
+        passes++;
+    }
+    return passes;
+}
+
+/**
+ * @brief Send one line and check the complete reply
+ */
+static void expect(const char *input, const char *reply)
+{
+    tx_len = 0;
+    tx_text[0] = '\0';
+    SIM_UART_Inject((const uint8_t *)input, (uint16_t)strlen(input));
+    run_loop(100);
+    BSP_UART_Flush();
+    SIM_Advance_Us(SIM_UART_BYTE_US(UART_TX_CHUNK));
+    
+    if (strcmp(tx_text, reply) != 0) {
+        printf("FAIL \"%s\": got \"%s\", expected \"%s\"\n", input, tx_text, reply);
+        failures++;
+    }
+}
+
+static void test_commands(void)
+{
+    expect("get low\r\n", "low=40\r\n");
+    expect("set low 30\n", "low=30\r\n");
+    expect("set low 60\n", "ERR rejected\r\n");
+    expect("set high 101\n", "high=50 (0-100)\r\nERR out of range\r\n");
+    expect("set dry 3000\r", "dry=3000\r\n");
+    expect("set dry 3x\n", "ERR bad value\r\n");
+    expect("set dry 70000\n", "ERR bad value\r\n");
+    expect("get nope\n", "ERR unknown parameter\r\n");
+    expect("frob\n", "ERR unknown command\r\n");
+    expect("  get   high  \n", "high=50\r\n");
+    expect("get lox\bw\n", "low=30\r\n");
+    expect("\r\n\r\n", "");
+    expect("list\n", "low=30 (0-100)\r\nhigh=50 (0-100)\r\ndry=3000 (0-4095)\r\n");
+    expect("set low 10000000000000000000000000000000000000000000000000000\n",
+           "ERR line too long\r\n");
+    
+    if (low != 30 || high != 50 || dry != 3000) {
+        printf("FAIL live variables: low=%u high=%u dry=%u\n", low, high, dry);
+        failures++;
+    }
+}
+
+/**
+ * @brief About 0.7 s of garbage at full line rate, then a normal command
+ */
+static void test_flood(void)
+{
+    static uint8_t garbage[SIM_UART_RX_MAX];
+    UART_Stats_t before;
+    UART_Stats_t after;
+    uint32_t received;
+    uint32_t passes;
+    
+    memset(garbage, 'x', sizeof(garbage));
+    BSP_UART_GetStats(&before);
+    if (!SIM_UART_Inject(garbage, sizeof(garbage))) {
+        printf("FAIL could not queue the flood\n");
+        failures++;
+        return;
+    }
+    
+    passes = run_loop(1000);
+    BSP_UART_GetStats(&after);
+    received = after.rx_bytes - before.rx_bytes;
+    printf("flood: %lu bytes received, %lu dropped, %lu loop passes in 1 s\n",
+           (unsigned long)received, (unsigned long)(after.rx_dropped - before.rx_dropped),
+           (unsigned long)passes);
+    
+    // HAL_Delay(10) takes 11 ms; the shell must not slow the loop down
+    if (passes < 1000 / 11) {
+        printf("FAIL loop slowed to %lu passes\n", (unsigned long)passes);
+        failures++;
+    }
+    if (after.rx_dropped == before.rx_dropped ||
+        received > passes * SHELL_POLL_BYTES + UART_RX_BUFFER_SIZE) {
+        printf("FAIL shell took more than %d bytes per pass\n", SHELL_POLL_BYTES);
+        failures++;
+    }
+    if (SIM_UART_RxPending() != 0) {
+        printf("FAIL %u bytes still on the line\n", SIM_UART_RxPending());
+        failures++;
+    }
+    run_loop(100);
+    
+    // The flood was one endless line: its end is reported, then back to normal
+    expect("\n", "ERR line too long\r\n");
+    expect("get dry\n", "dry=3000\r\n");
+}
+
+/**
+ * @brief Dump a journal that has wrapped, with lines too long for the TX
+ *        ring to hold them all
+ */
+static void test_events(void)
+{
+    UART_Stats_t before;
+    UART_Stats_t after;
+    char line[48];
+    uint32_t first_tick = 0;
+    uint32_t lines = 0;
+    const char *p;
+    
+    expect("events\n", "events=0 lost=0\r\n");
+    
+    for (uint16_t i = 0; i < JOURNAL_LENGTH + 36; i++) {
+        if (i == 36) {
+            first_tick = HAL_GetTick();
+        }
+        MID_Journal_Record(JOURNAL_PUMP, (uint8_t)(i & 1), (uint16_t)(60000U + i));
+        SIM_Advance_Us(1000);
+    }
+    
+    tx_len = 0;
+    tx_text[0] = '\0';
+    BSP_UART_GetStats(&before);
+    SIM_UART_Inject((const uint8_t *)"events\n", 7);
+    run_loop(1000);
+    BSP_UART_Flush();
+    SIM_Advance_Us(SIM_UART_BYTE_US(UART_TX_CHUNK));
+    BSP_UART_GetStats(&after);
+    
+    for (p = tx_text; (p = strstr(p, " pump ")) != NULL; p++) {
+        lines++;
+    }
+    snprintf(line, sizeof(line), "%lu pump 0 60036\r\n", (unsigned long)first_tick);
+    printf("events: %lu lines, %lu bytes\n", (unsigned long)lines, (unsigned long)tx_len);
+    
+    if (after.bytes_dropped != before.bytes_dropped) {
+        printf("FAIL dump dropped %lu bytes\n",
+               (unsigned long)(after.bytes_dropped - before.bytes_dropped));
+        failures++;
+    }
+    if (lines != JOURNAL_LENGTH || strncmp(tx_text, line, strlen(line)) != 0 ||
+        strstr(tx_text, " 60099\r\nevents=64 lost=36\r\n") == NULL) {
+        printf("FAIL dump:\n%s", tx_text);
+        failures++;
+    }
+    
+    // Input waits while the dump runs, then works again
+    expect("get high\n", "high=50\r\n");
+}
+
+int main(void)
+{
+    SIM_Reset();
+    SIM_UART_SetSink(tx_sink, NULL);
+    BSP_UART_Init(&huart1);
+    MID_Param_Register(params, sizeof(params) / sizeof(params[0]));
+    MID_Shell_Init();
+    MID_Journal_Init();
+    
+    printf("Shell test: RX ring %d bytes, %d bytes per poll\n",
+           UART_RX_BUFFER_SIZE, SHELL_POLL_BYTES);
+    
+    test_commands();
+    test_flood();
+    test_events();
+    
+    printf("\n%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,371 @@
+/**
+ * @file    log_decode.c
+ * @brief   Turn tokenized log frames (LOG_TOKENIZED=1) back into text
+ *
+ *   log_decode <firmware.elf> [capture.bin]
+ *
+ * Format strings are read from the ELF's log_fmt section; a frame's id is
+ * the string's offset in it. The UART stream is read from the capture
+ * file or stdin: frames are printed as text, every other byte is passed
+ * through unchanged. See BSP/include/bsp_log.h for the frame layout.
+ *
+ * %@ is the firmware's rate limit report: its argument is another format
+ * id, printed as that format's prefix (same rule as bsp_log.c).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_FRAME_START     0xA5
+#define LOG_SECTION         "log_fmt"
+#define SPEC_MAX            32
+#define REPEAT_PREFIX       24      // LOG_REPEAT_PREFIX
+
+/* Format strings from the ELF */
+static char *fmt_table = NULL;
+static size_t fmt_size = 0;
+
+/* Arguments of the frame being decoded */
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+} Args_t;
+
+/**
+ * @brief Little-endian field readers
+ */
+static uint32_t rd16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return rd16(p) | (rd16(p + 2) << 16);
+}
+
+static uint64_t rd64(const uint8_t *p)
+{
+    return (uint64_t)rd32(p) | ((uint64_t)rd32(p + 4) << 32);
+}
+
+/**
+ * @brief Read a whole file into memory
+ */
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *buf;
+    long len;
+    
+    if (f == NULL) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    
+    buf = malloc(len > 0 ? (size_t)len : 1);
+    if (buf == NULL || fread(buf, 1, (size_t)len, f) != (size_t)len) {
+        free(buf);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size = (size_t)len;
+    return buf;
+}
+
+/**
+ * @brief Load the log_fmt section of a little-endian ELF32/ELF64 file
+ */
+static bool load_formats(const char *path)
+{
+    size_t size = 0;
+    uint8_t *elf = read_file(path, &size);
+    bool is64;
+    uint64_t shoff;
+    uint32_t shentsize, shnum, shstrndx;
+    uint64_t strtab_off;
+    bool found = false;
+    
+    if (elf == NULL) {
+        fprintf(stderr, "log_decode: cannot read %s\n", path);
+        return false;
+    }
+    if (size < 64 || memcmp(elf, "\x7f" "ELF", 4) != 0 || elf[5] != 1) {
+        fprintf(stderr, "log_decode: %s is not a little-endian ELF file\n", path);
+        free(elf);
+        return false;
+    }
+    
+    is64 = (elf[4] == 2);
+    shoff = is64 ? rd64(elf + 0x28) : rd32(elf + 0x20);
+    shentsize = rd16(elf + (is64 ? 0x3A : 0x2E));
+    shnum = rd16(elf + (is64 ? 0x3C : 0x30));
+    shstrndx = rd16(elf + (is64 ? 0x3E : 0x32));
+    
+    if (shnum == 0 || shstrndx >= shnum || shoff + (uint64_t)shnum * shentsize > size) {
+        fprintf(stderr, "log_decode: %s has no usable section table\n", path);
+        free(elf);
+        return false;
+    }
+    
+    // Section header: name, type, flags, addr, offset, size
+    {
+        const uint8_t *sh = elf + shoff + (uint64_t)shstrndx * shentsize;
+        strtab_off = is64 ? rd64(sh + 0x18) : rd32(sh + 0x10);
+    }
+    
+    for (uint32_t i = 0; i < shnum && !found; i++) {
+        const uint8_t *sh = elf + shoff + (uint64_t)i * shentsize;
+        uint64_t name = strtab_off + rd32(sh);
+        uint64_t off = is64 ? rd64(sh + 0x18) : rd32(sh + 0x10);
+        uint64_t len = is64 ? rd64(sh + 0x20) : rd32(sh + 0x14);
+        
+        if (name + sizeof(LOG_SECTION) > size ||
+            memcmp(elf + name, LOG_SECTION, sizeof(LOG_SECTION)) != 0) {
+            continue;
+        }
+        if (off + len > size) {
+            break;
+        }
+        
+        // Keep a NUL at the end so a bad id cannot run off the table
+        fmt_table = malloc((size_t)len + 1);
+        if (fmt_table != NULL) {
+            memcpy(fmt_table, elf + off, (size_t)len);
+            fmt_table[len] = '\0';
+            fmt_size = (size_t)len;
+            found = true;
+        }
+    }
+    
+    free(elf);
+    if (!found) {
+        fprintf(stderr, "log_decode: no " LOG_SECTION " section in %s "
+                "(built without LOG_TOKENIZED=1?)\n", path);
+    }
+    return found;
+}
+
+/**
+ * @brief Take the next 32-bit argument
+ */
+static bool arg_int(Args_t *args, uint32_t *value)
+{
+    if (args->pos + 4 > args->len) {
+        return false;
+    }
+    *value = rd32(args->data + args->pos);
+    args->pos += 4;
+    return true;
+}
+
+/**
+ * @brief Take the next NUL-terminated string argument
+ */
+static const char *arg_str(Args_t *args)
+{
+    const char *str = (const char *)args->data + args->pos;
+    const uint8_t *end;
+    
+    if (args->pos >= args->len) {
+        return NULL;
+    }
+    end = memchr(args->data + args->pos, '\0', args->len - args->pos);
+    if (end == NULL) {
+        return NULL;
+    }
+    args->pos = (size_t)(end - args->data) + 1;
+    return str;
+}
+
+/**
+ * @brief Print the start of a format string naming a rate-limited site
+ */
+static void print_prefix(FILE *out, Args_t *args)
+{
+    char prefix[REPEAT_PREFIX + 2];
+    uint32_t id;
+    const char *p;
+    size_t n = 0;
+    
+    if (!arg_int(args, &id) || id >= fmt_size) {
+        fputs("<?> ", out);
+        return;
+    }
+    
+    p = fmt_table + id;
+    while (*p == '\r' || *p == '\n') {
+        p++;
+    }
+    while (*p && *p != '%' && *p != '\r' && *p != '\n' && n < REPEAT_PREFIX) {
+        prefix[n++] = *p++;
+    }
+    while (n > 0 && prefix[n - 1] == ' ') {
+        n--;
+    }
+    if (n > 0) {
+        prefix[n++] = ' ';
+    }
+    prefix[n] = '\0';
+    fputs(prefix, out);
+}
+
+/**
+ * @brief Print one conversion
+ * @param spec Flags, width and precision with '%' in front, no length
+ * @param conv Conversion character
+ */
+static void print_arg(FILE *out, char *spec, size_t n, char conv, Args_t *args)
+{
+    uint32_t value;
+    const char *str;
+    
+    if (conv == 's') {
+        str = arg_str(args);
+        spec[n++] = 's';
+        spec[n] = '\0';
+        fprintf(out, spec, str ? str : "<?>");
+        return;
+    }
+    
+    if (!arg_int(args, &value)) {
+        fputs("<?>", out);
+        return;
+    }
+    
+    switch (conv) {
+    case 'd':
+    case 'i':
+        spec[n++] = 'l';
+        spec[n++] = 'd';
+        spec[n] = '\0';
+        fprintf(out, spec, (long)(int32_t)value);
+        break;
+    case 'c':
+        spec[n++] = 'c';
+        spec[n] = '\0';
+        fprintf(out, spec, (int)(uint8_t)value);
+        break;
+    default:    // u, x, X, o
+        spec[n++] = 'l';
+        spec[n++] = conv;
+        spec[n] = '\0';
+        fprintf(out, spec, (unsigned long)value);
+        break;
+    }
+}
+
+/**
+ * @brief Print a frame's format string with its arguments
+ */
+static void print_frame(FILE *out, const uint8_t *frame, size_t len)
+{
+    Args_t args;
+    uint32_t id;
+    const char *p;
+    
+    if (len < 2) {
+        fputs("<short log frame>\n", out);
+        return;
+    }
+    args = (Args_t){ frame + 2, len - 2, 0 };
+    id = rd16(frame);
+    if (id >= fmt_size) {
+        fprintf(out, "<unknown log id %u>\n", (unsigned)id);
+        return;
+    }
+    
+    p = fmt_table + id;
+    while (*p) {
+        char spec[SPEC_MAX];
+        size_t n = 0;
+        
+        if (*p != '%') {
+            fputc(*p++, out);
+            continue;
+        }
+        
+        spec[n++] = *p++;
+        if (*p == '%') {
+            fputc(*p++, out);
+            continue;
+        }
+        
+        // Flags, width, precision
+        while (*p && strchr("-+ #0123456789.", *p) && n < SPEC_MAX - 4) {
+            spec[n++] = *p++;
+        }
+        // Length modifiers: every argument is sent as 32 bits
+        while (*p && strchr("hlzt", *p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (strchr("diuxXocs", *p)) {
+            print_arg(out, spec, n, *p, &args);
+        } else if (*p == '@') {
+            print_prefix(out, &args);
+        } else {
+            spec[n] = '\0';
+            fprintf(out, "%s%c", spec, *p);
+        }
+        p++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    uint8_t frame[256];
+    int c;
+    
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <firmware.elf> [capture.bin]\n", argv[0]);
+        return 2;
+    }
+    if (!load_formats(argv[1])) {
+        return 1;
+    }
+    if (argc == 3) {
+        in = fopen(argv[2], "rb");
+        if (in == NULL) {
+            fprintf(stderr, "log_decode: cannot read %s\n", argv[2]);
+            return 1;
+        }
+    }
+    
+    while ((c = fgetc(in)) != EOF) {
+        int len;
+        size_t got;
+        
+        if (c != LOG_FRAME_START) {
+            fputc(c, stdout);
+            continue;
+        }
+        
+        len = fgetc(in);
+        if (len == EOF) {
+            break;
+        }
+        got = fread(frame, 1, (size_t)len, in);
+        if (got < (size_t)len) {
+            fputs("<truncated log frame>\n", stdout);
+            break;
+        }
+        print_frame(stdout, frame, got);
+        fflush(stdout);
+    }
+    
+    if (in != stdin) {
+        fclose(in);
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+# Run both log_demo builds, decode the tokenized stream and compare
+#   cmake -DDECODER=... -DTEXT=... -DTOKENIZED=... -DWORK_DIR=... -P roundtrip.cmake
+
+execute_process(COMMAND ${TEXT} OUTPUT_FILE ${WORK_DIR}/log_text.txt RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "log_demo_text failed: ${rc}")
+endif()
+
+execute_process(COMMAND ${TOKENIZED} OUTPUT_FILE ${WORK_DIR}/log_frames.bin RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "log_demo_tokenized failed: ${rc}")
+endif()
+
+execute_process(COMMAND ${DECODER} ${TOKENIZED} ${WORK_DIR}/log_frames.bin
+                OUTPUT_FILE ${WORK_DIR}/log_decoded.txt RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "log_decode failed: ${rc}")
+endif()
+
+file(SIZE ${WORK_DIR}/log_text.txt text_size)
+file(SIZE ${WORK_DIR}/log_frames.bin frame_size)
+message(STATUS "text ${text_size} bytes, tokenized ${frame_size} bytes")
+
+file(READ ${WORK_DIR}/log_text.txt text)
+if(NOT text MATCHES "LCD I2C Error: \\(repeated 35 times\\)" OR
+   NOT text MATCHES "AUTO: Moisture \\(repeated 5 times\\)[^A]*AUTO: Moisture 50%")
+    message(FATAL_ERROR "Rate limit reports missing from ${WORK_DIR}/log_text.txt")
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+                ${WORK_DIR}/log_text.txt ${WORK_DIR}/log_decoded.txt RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "Decoded log differs from printf output "
+                        "(${WORK_DIR}/log_text.txt vs log_decoded.txt)")
+endif()
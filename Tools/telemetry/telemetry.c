@@ -0,0 +1,272 @@
+/**
+ * @file    telemetry.c
+ * @brief   Decode and record the binary telemetry stream (mid_telemetry)
+ *
+ *   telemetry [-b baud] [-w record.bin] <serial port | pty | file | ->
+ *
+ * Prints one CSV line per valid snapshot on stdout. A serial port or pty
+ * is switched to raw mode at the given baud rate (115200 by default);
+ * -w also writes every byte received to a file, which can be decoded
+ * again later. Frames are 0x00-delimited COBS; anything that does not
+ * decode to a packet with a good CRC (debug text, cut frames) is
+ * skipped. Totals go to stderr at the end.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define TELEMETRY_TYPE_SNAPSHOT 0x01
+#define TELEMETRY_PACKET_SIZE   27
+#define FRAME_MAX               256
+
+typedef struct {
+    uint32_t frames;
+    uint32_t rejected;      // Chunks failing COBS, length or CRC (text too)
+    uint32_t lost;          // Sequence gaps
+    uint64_t skipped;       // Bytes outside valid frames
+} Totals_t;
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)rd16(p) | ((uint32_t)rd16(p + 2) << 16);
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE, as in mid_telemetry.c
+ */
+static uint16_t crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    
+    while (len--) {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief COBS-decode one frame (delimiters removed)
+ * @return Decoded length, or -1 if malformed
+ */
+static int cobs_decode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    size_t i = 0;
+    int o = 0;
+    
+    while (i < len) {
+        uint8_t code = in[i++];
+        
+        if (code == 0 || i + code - 1 > len) {
+            return -1;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            out[o++] = in[i++];
+        }
+        if (code < 0xFF && i < len) {
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+/**
+ * @brief Check and print one frame
+ */
+static void handle_frame(const uint8_t *frame, size_t len, Totals_t *totals)
+{
+    static bool have_seq = false;
+    static uint16_t last_seq = 0;
+    uint8_t p[FRAME_MAX];
+    int n = cobs_decode(frame, len, p);
+    uint16_t seq;
+    int16_t temp;
+    
+    if (n != TELEMETRY_PACKET_SIZE || p[0] != TELEMETRY_TYPE_SNAPSHOT ||
+        crc16(p, TELEMETRY_PACKET_SIZE - 2) != rd16(&p[TELEMETRY_PACKET_SIZE - 2])) {
+        totals->rejected++;
+        totals->skipped += len;
+        return;
+    }
+    
+    seq = rd16(&p[1]);
+    if (have_seq) {
+        totals->lost += (uint16_t)(seq - last_seq - 1);
+    }
+    have_seq = true;
+    last_seq = seq;
+    totals->frames++;
+    
+    temp = (int16_t)rd16(&p[12]);
+    printf("%u,%u,%u,%u,%u,%u,%s%d.%d,%u.%u,%02u:%02u:%02u,%u,%u,%u\n",
+           seq, rd32(&p[3]), p[7], rd16(&p[8]), p[10], p[11],
+           (temp < 0) ? "-" : "", abs(temp) / 10, abs(temp) % 10,
+           rd16(&p[14]) / 10, rd16(&p[14]) % 10,
+           p[16], p[17], p[18],
+           rd16(&p[19]), rd16(&p[21]), rd16(&p[23]));
+}
+
+/**
+ * @brief Put a serial port or pty into raw mode
+ */
+static bool setup_tty(int fd, long baud)
+{
+    struct termios tio;
+    speed_t speed;
+    
+    switch (baud) {
+    case 9600:   speed = B9600;   break;
+    case 19200:  speed = B19200;  break;
+    case 38400:  speed = B38400;  break;
+    case 57600:  speed = B57600;  break;
+    case 115200: speed = B115200; break;
+    case 230400: speed = B230400; break;
+    default:
+        fprintf(stderr, "telemetry: unsupported baud rate %ld\n", baud);
+        return false;
+    }
+    
+    if (tcgetattr(fd, &tio) != 0) {
+        perror("telemetry: tcgetattr");
+        return false;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror("telemetry: tcsetattr");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *record_path = NULL;
+    FILE *record = NULL;
+    long baud = 115200;
+    Totals_t totals = {0};
+    uint8_t frame[FRAME_MAX];
+    size_t frame_len = 0;
+    bool overflow = false;
+    int fd;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "b:w:")) != -1) {
+        switch (opt) {
+        case 'b':
+            baud = strtol(optarg, NULL, 10);
+            break;
+        case 'w':
+            record_path = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-b baud] [-w record.bin] <port|file|->\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-b baud] [-w record.bin] <port|file|->\n", argv[0]);
+        return 2;
+    }
+    
+    if (strcmp(argv[optind], "-") == 0) {
+        fd = STDIN_FILENO;
+    } else {
+        fd = open(argv[optind], O_RDONLY | O_NOCTTY);
+        if (fd < 0) {
+            fprintf(stderr, "telemetry: cannot open %s: %s\n", argv[optind], strerror(errno));
+            return 1;
+        }
+    }
+    if (isatty(fd) && !setup_tty(fd, baud)) {
+        return 1;
+    }
+    if (record_path != NULL) {
+        record = fopen(record_path, "wb");
+        if (record == NULL) {
+            fprintf(stderr, "telemetry: cannot write %s\n", record_path);
+            return 1;
+        }
+    }
+    
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    printf("seq,tick_ms,state,adc_raw,moisture,pump,temp_c,humidity,time,"
+           "loops,loop_max_us,loop_avg_us\n");
+    
+    while (!stop) {
+        uint8_t buf[512];
+        ssize_t got = read(fd, buf, sizeof(buf));
+        
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+        if (record != NULL) {
+            fwrite(buf, 1, (size_t)got, record);
+            fflush(record);
+        }
+        
+        for (ssize_t i = 0; i < got; i++) {
+            if (buf[i] != 0x00) {
+                if (frame_len < sizeof(frame)) {
+                    frame[frame_len++] = buf[i];
+                } else {
+                    overflow = true;
+                    totals.skipped++;
+                }
+                continue;
+            }
+            
+            // Delimiter: text and cut frames fail the checks and are skipped
+            if (overflow) {
+                totals.skipped += frame_len;
+            } else if (frame_len > 0) {
+                handle_frame(frame, frame_len, &totals);
+            }
+            frame_len = 0;
+            overflow = false;
+        }
+        fflush(stdout);
+    }
+    totals.skipped += frame_len;
+    
+    fprintf(stderr, "telemetry: %u frames, %u rejected, %u lost, %llu bytes skipped\n",
+            totals.frames, totals.rejected, totals.lost, (unsigned long long)totals.skipped);
+    
+    if (record != NULL) {
+        fclose(record);
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+# Record the demo stream, decode it and compare with the expected CSV
+#   cmake -DDECODER=... -DDEMO=... -DEXPECTED=... -DWORK_DIR=... -P decode.cmake
+
+execute_process(COMMAND ${DEMO} OUTPUT_FILE ${WORK_DIR}/telemetry.bin RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "telemetry_demo failed: ${rc}")
+endif()
+
+execute_process(COMMAND ${DECODER} ${WORK_DIR}/telemetry.bin
+                OUTPUT_FILE ${WORK_DIR}/telemetry.csv
+                ERROR_VARIABLE summary RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "telemetry decoder failed: ${rc}")
+endif()
+message(STATUS "${summary}")
+
+if(NOT summary MATCHES "55 frames, 2 rejected, 0 lost")
+    message(FATAL_ERROR "Unexpected decoder totals")
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+                ${EXPECTED} ${WORK_DIR}/telemetry.csv RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "Decoded telemetry differs from ${EXPECTED}")
+endif()